@@ -0,0 +1,107 @@
+//==============================================================================
+// BPlusTree.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Fills a BPlusTree, a SkipList and a DoubleSkipList with random keys, and
+ * times the adds, random finds of keys that are there, short range scans
+ * (findHigh and then 100 steps) and random removes, from 10^4 items up to
+ * 10^7. Larger sizes can be asked for, but the skiplists need a few GB at
+ * 10^8 items.
+ *
+ * Usage: BPlusTree [largest items]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include "BPlusTree.hpp"
+#include "SkipList.hpp"
+#include "DoubleSkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// DoubleSkipList's Iterators work like pointers.
+template<typename ITR> bool valid (ITR itr) { return itr.valid(); }
+template<typename ITR> unsigned value (ITR itr) { return itr.cref(); }
+bool valid (DoubleSkipList<unsigned>::ConstIterator itr) { return itr; }
+unsigned value (DoubleSkipList<unsigned>::ConstIterator itr) { return *itr; }
+
+//------------------------------------------------------------------------------
+template<typename LIST>
+void run (char const* name, LIST& list, vector<unsigned>& keys) {
+   Timer timer;
+   LIST const& clist = list;
+   unsigned items = keys.size();
+   unsigned lookups = items < 1000000 ? items : 1000000;
+   unsigned scans = lookups / 10;
+
+   timer.start();
+   for (unsigned i=0; i<items; ++i)
+      list.add(keys[i]);
+   double add = timer.seconds();
+
+   XorShift32 rand(0xf1d);
+   unsigned found = 0;
+   timer.start();
+   for (unsigned i=0; i<lookups; ++i)
+      found += valid(clist.find(keys[rand.u32() % items]));
+   double find = timer.seconds();
+
+   unsigned long sum = 0;
+   timer.start();
+   for (unsigned i=0; i<scans; ++i) {
+      typename LIST::ConstIterator itr = clist.findHigh(rand.u32());
+      for (unsigned j=0; j<100 and valid(itr); ++j, ++itr)
+         sum += value(itr);
+   }
+   double scan = timer.seconds();
+
+   unsigned removed = 0;
+   timer.start();
+   for (unsigned i=0; i<lookups; ++i)
+      removed += list.remove(keys[i]);
+   double remove = timer.seconds();
+
+   cout << "  " << left << setw(16) << name << right
+        << setw(8) << 1e9 * add / items
+        << setw(8) << 1e9 * find / lookups
+        << setw(8) << 1e9 * scan / scans
+        << setw(8) << 1e9 * remove / lookups
+        << setw(22) << sum << setw(9) << found + removed << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned largest = argc > 1 ? atoi(argv[1]) : 10000000;
+   cout << setprecision(1) << fixed;
+   for (unsigned items=10000; items<=largest; items*=10) {
+      vector<unsigned> keys(items);
+      XorShift32 rand(0x5eed);
+      for (unsigned& key : keys)
+         key = rand.u32();
+
+      cout << items << " random items (ns per add, find, scan of 100, remove)\n"
+           << "                       add    find    scan  remove                   sum    found\n";
+      {
+         BPlusTree<unsigned> tree;
+         run("BPlusTree", tree, keys);
+      }
+      {
+         SkipList<unsigned> list(items);
+         run("SkipList", list, keys);
+      }
+      {
+         DoubleSkipList<unsigned> list(items);
+         run("DoubleSkipList", list, keys);
+      }
+      cout << '\n';
+   }
+   return 0;
+}
@@ -0,0 +1,129 @@
+//==============================================================================
+// BitFieldScan.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Fills BitFields with random bits at densities from very sparse to very
+ * dense, and times visiting every set bit and every unset bit with the
+ * iterators' nextSet and nextUnset, against testing one bit at a time with
+ * get (as nextSet and nextUnset used to). Also times count, and random rank
+ * and select queries. Last, it frees a random half of a MemoryPoolF's
+ * pieces and times allocating them again, since MemoryPoolF finds free
+ * pieces with findUnset.
+ *
+ * Usage: BitFieldScan [bits]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include "BitField.h"
+#include "MemoryPoolF.h"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+void run (unsigned bits, unsigned density) {
+   Timer timer;
+   XorShift32 rand(0xb17);
+   BitField field(bits);
+   field.zero();
+   for (unsigned i=0; i<bits; ++i) {
+      if (rand.u32() % 1024 < density)
+         field.set(i);
+   }
+
+   // one bit at a time, as nextSet and nextUnset used to
+   unsigned long sum = 0;
+   timer.start();
+   for (unsigned i = field.get(0) ? 0 : field.findSet(0); i<bits; ) {
+      sum += i;
+      do { ++i; } while (i < bits and !field.get(i));
+   }
+   double bitSet = timer.seconds();
+   timer.start();
+   for (unsigned i = field.get(0) ? field.findUnset(0) : 0; i<bits; ) {
+      sum -= i;
+      do { ++i; } while (i < bits and field.get(i));
+   }
+   double bitUnset = timer.seconds();
+
+   // a word at a time
+   unsigned long check = 0;
+   timer.start();
+   for (BitField::CItr itr = field.cFirstSet(); itr.valid(); itr.nextSet())
+      check += itr.i();
+   double wordSet = timer.seconds();
+   BitField::CItr unset(field, field.findUnset(0));
+   timer.start();
+   for (; unset.valid(); unset.nextUnset())
+      check -= unset.i();
+   double wordUnset = timer.seconds();
+
+   unsigned const passes = 100;
+   unsigned long count = 0;
+   timer.start();
+   for (unsigned p=0; p<passes; ++p)
+      count += field.count();
+   double counting = timer.seconds() / passes;
+
+   unsigned const queries = 1000;
+   count /= passes;
+   unsigned long ranks = 0;
+   timer.start();
+   for (unsigned q=0; q<queries; ++q)
+      ranks += field.rank(rand.u32() % bits);
+   double rank = timer.seconds() / queries;
+   timer.start();
+   for (unsigned q=0; q<queries and count; ++q)
+      ranks += field.select(rand.u32() % count);
+   double select = timer.seconds() / queries;
+
+   cout << setw(8) << density << "/1024" << setw(12) << count
+        << setw(9) << 1e3 * bitSet << setw(9) << 1e3 * wordSet
+        << setw(9) << 1e3 * bitUnset << setw(9) << 1e3 * wordUnset
+        << setw(9) << 1e3 * counting << setw(9) << 1e6 * rank << setw(9) << 1e6 * select
+        << (sum == check ? "" : "   (mismatch!)") << '\n';
+}
+
+//------------------------------------------------------------------------------
+// Frees a random half of a MemoryPoolF's pieces, and times allocating that many again.
+void pool (unsigned pieces) {
+   Timer timer;
+   MemoryPoolF pool;
+   pool.setItemSize(16, 8);
+   pool.setNextBlockSize(pieces);
+   vector<void*> live(pieces);
+   for (unsigned i=0; i<pieces; ++i)
+      live[i] = pool.alloc();
+   XorShift32 rand(0xf4ee);
+   for (unsigned i=pieces; i>1; --i)
+      swap(live[i-1], live[rand.u32() % i]);
+   for (unsigned i=0; i<pieces/2; ++i)
+      pool.free(live[i]);
+   timer.start();
+   for (unsigned i=0; i<pieces/2; ++i)
+      live[i] = pool.alloc();
+   double seconds = timer.seconds();
+   cout << "MemoryPoolF: " << pieces / 2 << " allocs after random frees, "
+        << 1e9 * seconds / (pieces / 2) << " ns per alloc (" << pool.blocks() << " blocks)\n";
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned bits = argc > 1 ? atoi(argv[1]) : 100000000;
+   cout << bits << " bits (ms to visit every set and unset bit, one bit at a time and with\n"
+        << "nextSet/nextUnset; ms per count; us per rank and select)\n"
+        << "     density    set bits   by bit  nextSet   by bit nextUnset  count     rank   select\n"
+        << setprecision(2) << fixed;
+   unsigned const densities[] = {1, 16, 128, 512, 896, 1008, 1023};
+   for (unsigned density : densities)
+      run(bits, density);
+   pool(1000000);
+   return 0;
+}
@@ -0,0 +1,83 @@
+//==============================================================================
+// BloomFilter.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * First, this measures the false positive rate of BloomFilter at several
+ * numbers of bits per item (and compares it to the expected rate), along with
+ * the time per mayContain.
+ * Then it repeats the experiment in main.cpp (a million random numbers are
+ * added, and then random numbers are searched for, nearly all of which miss)
+ * with a HashSet and with a FilteredHashSet.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "MemoryPoolF.h"
+#include "FilteredHashSet.hpp"
+#include "Random.h"
+#include "HUnsigned.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+void falsePositives (unsigned n, unsigned m) {
+   // Keys that were added are even, keys that are looked up are odd.
+   const float bitsPerItem[] = { 4, 6, 8, 10, 12, 16, 20, 24 };
+   cout << "False positive rate (" << n << " items, " << m << " lookups of absent keys)\n";
+   cout << setw(14) << "bits/item" << setw(14) << "measured" << setw(14) << "expected" << setw(16) << "ns/lookup\n";
+   for (float bits : bitsPerItem) {
+      BloomFilter filter(n, bits);
+      XorShift32 rand(0xdefceedll);
+      for (unsigned i=0; i<n; ++i)
+         filter.add(rand.u32() << 1);
+
+      unsigned positives = 0;
+      Timer timer;
+      for (unsigned i=0; i<m; ++i)
+         positives += filter.mayContain((rand.u32() << 1) | 1);
+      double seconds = timer.seconds();
+
+      cout << setw(14) << setprecision(1) << fixed << filter.bitsPerItem()
+           << setw(13) << setprecision(4) << 100.0 * positives / m << '%'
+           << setw(13) << 100.0 * filter.expectedFalsePositiveRate() << '%'
+           << setw(15) << setprecision(2) << 1e9 * seconds / m << '\n';
+   }
+   cout << '\n';
+}
+
+//------------------------------------------------------------------------------
+template<class SET>
+void lookups (SET& set, unsigned n, unsigned m, char const* label) {
+   XorShift32 rand(0xdefceedll);
+   while (set.size() < n)
+      set.add(rand.u32());
+
+   unsigned hits = 0;
+   Timer timer;
+   for (unsigned i=0; i<m; ++i) {
+      if (set.find(HUnsigned(rand.u32())))
+         ++hits;
+   }
+   double seconds = timer.seconds();
+   cout << setw(18) << left << label << right << setw(8) << setprecision(2) << fixed
+        << 1e9 * seconds / m << " ns/find  (" << hits << " hits)\n";
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned n = argc > 1 ? atoi(argv[1]) : 1000000;
+   unsigned m = argc > 2 ? atoi(argv[2]) : 10000000;
+   falsePositives(n, m);
+
+   cout << "Random lookups (" << n << " items, " << m << " lookups)\n";
+   HashSet<HUnsigned, MemoryPoolF> set(n);
+   lookups(set, n, m, "HashSet");
+   FilteredHashSet<HUnsigned, MemoryPoolF> filtered(n, 10);
+   lookups(filtered, n, m, "FilteredHashSet");
+   return 0;
+}
@@ -0,0 +1,162 @@
+//==============================================================================
+// ConcurrentQueue.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Producer threads send stamped messages through a queue to consumer
+ * threads, which check that each producer's messages arrive in order and
+ * note how long each one took to get through. Compares ConcurrentQueue (one
+ * consumer), ConcurrentRing (one and two consumers) and a std::queue behind a
+ * std::mutex, with 1 to 8 producers, and reports messages per second and the
+ * mean, median and 99th percentile latency. Consumers yield when there is
+ * nothing to take, and producers yield when the ring is full.
+ *
+ * Usage: ConcurrentQueue [messages [ring capacity]]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "ConcurrentQueue.hpp"
+#include "ConcurrentRing.hpp"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+struct Message {
+   long sent;          ///< steady_clock time in ns
+   unsigned producer;
+   unsigned sequence;
+};
+
+long now () {
+   return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+/// The baseline: a std::queue behind a std::mutex.
+class LockedQueue {
+private:
+   mutex _lock;
+   queue<Message> _queue;
+public:
+   LockedQueue (unsigned) {}
+   bool add (Message const& message) { lock_guard<mutex> guard(_lock); _queue.push(message); return true; }
+   bool remove (Message& message) {
+      lock_guard<mutex> guard(_lock);
+      if (_queue.empty())
+         return false;
+      message = _queue.front();
+      _queue.pop();
+      return true;
+   }
+};
+
+/// ConcurrentQueue, with the same constructor as the others.
+class MPSCQueue : public ConcurrentQueue<Message> {
+public:
+   MPSCQueue (unsigned) {}
+};
+
+//------------------------------------------------------------------------------
+template<typename QUEUE>
+void produce (QUEUE& queue, unsigned producer, unsigned messages) {
+   Message message = {0, producer, 0};
+   for (unsigned i=0; i<messages; ++i) {
+      message.sequence = i;
+      message.sent = now();
+      while (!queue.add(message))
+         this_thread::yield();
+   }
+}
+
+//------------------------------------------------------------------------------
+// Takes messages until all have been taken, and appends their latencies. Returns false if any came out of order.
+template<typename QUEUE>
+bool consume (QUEUE& queue, unsigned producers, unsigned messages, atomic<unsigned>& taken, vector<long>& latencies) {
+   vector<long> next(producers, -1);
+   bool ordered = true;
+   Message message;
+   while (taken.load(memory_order_relaxed) < messages) {
+      if (!queue.remove(message)) {
+         this_thread::yield();
+         continue;
+      }
+      latencies.push_back(now() - message.sent);
+      if (long(message.sequence) <= next[message.producer])
+         ordered = false;
+      next[message.producer] = message.sequence;
+      taken.fetch_add(1, memory_order_relaxed);
+   }
+   return ordered;
+}
+
+//------------------------------------------------------------------------------
+template<typename QUEUE>
+void run (char const* name, unsigned producers, unsigned consumers, unsigned messages, unsigned capacity) {
+   QUEUE queue(capacity);
+   unsigned each = messages / producers;
+   messages = each * producers;
+   atomic<unsigned> taken(0);
+   vector<vector<long> > latencies(consumers);
+   vector<char> ordered(consumers);
+   for (unsigned c=0; c<consumers; ++c)
+      latencies[c].reserve(messages);
+
+   Timer timer;
+   timer.start();
+   vector<thread> threads;
+   for (unsigned c=0; c<consumers; ++c)
+      threads.push_back(thread([&, c] { ordered[c] = consume(queue, producers, messages, taken, latencies[c]); }));
+   for (unsigned p=0; p<producers; ++p)
+      threads.push_back(thread(produce<QUEUE>, ref(queue), p, each));
+   for (thread& t : threads)
+      t.join();
+   double seconds = timer.seconds();
+
+   vector<long> all;
+   bool inOrder = true;
+   for (unsigned c=0; c<consumers; ++c) {
+      all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+      inOrder = inOrder and ordered[c];
+   }
+   sort(all.begin(), all.end());
+   double mean = 0;
+   for (long latency : all)
+      mean += latency;
+   mean /= all.size();
+
+   cout << "  " << left << setw(20) << name << right << setw(4) << producers
+        << setw(10) << 1e-6 * messages / seconds
+        << setw(10) << 1e-3 * mean
+        << setw(10) << 1e-3 * all[all.size() / 2]
+        << setw(10) << 1e-3 * all[all.size() * 99 / 100]
+        << (inOrder ? "" : "   (out of order!)") << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned messages = argc > 1 ? atoi(argv[1]) : 2000000;
+   unsigned capacity = argc > 2 ? atoi(argv[2]) : 4096;
+   cout << messages << " messages, ring capacity " << capacity << ", " << thread::hardware_concurrency() << " hardware threads\n"
+        << "(producers, millions of messages per second, mean, median and 99th percentile latency in us)\n"
+        << "                    producers  M msg/s      mean    median       p99\n"
+        << setprecision(2) << fixed;
+   for (unsigned producers=1; producers<=8; producers*=2) {
+      run<MPSCQueue>("ConcurrentQueue", producers, 1, messages, capacity);
+      run<ConcurrentRing<Message> >("ConcurrentRing", producers, 1, messages, capacity);
+      run<ConcurrentRing<Message> >("  two consumers", producers, 2, messages, capacity);
+      run<LockedQueue>("mutex and std::queue", producers, 1, messages, capacity);
+   }
+   return 0;
+}
@@ -0,0 +1,157 @@
+//==============================================================================
+// ConcurrentSkipList.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Runs writer threads (adding random timestamps) alongside reader threads
+ * (scanning short ranges of timestamps), first on a SkipList behind a mutex
+ * and then on a ConcurrentSkipList, and reports the throughput of each. A
+ * last run on the ConcurrentSkipList has the writers remove an old item for
+ * every new one, as a sliding window of events would.
+ *
+ * Usage: ConcurrentSkipList [writers [readers [seconds]]]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SkipList.hpp"
+#include "ConcurrentSkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// The operations the benchmark needs, for each kind of list.
+struct Locked {
+   SkipList<unsigned> _list;
+   mutex _mutex;
+   Locked (): _list(1024) {}
+   void add (unsigned item) {
+      lock_guard<mutex> lock(_mutex);
+      _list.add(item);
+   }
+   void update (unsigned item, unsigned) { add(item); }
+   unsigned scan (unsigned start, unsigned end) {
+      lock_guard<mutex> lock(_mutex);
+      unsigned count = 0;
+      for (SkipList<unsigned>::ConstIterator itr = _list.findHigh(start); itr.valid() and itr.cref() < end; ++itr)
+         ++count;
+      return count;
+   }
+};
+
+struct LockFree {
+   ConcurrentSkipList<unsigned> _list;
+   bool _window;
+   LockFree (bool window): _window(window) {}
+   void add (unsigned item) { _list.add(item); }
+   void update (unsigned item, unsigned old) {
+      _list.add(item);
+      if (_window)
+         _list.remove(old);
+   }
+   unsigned scan (unsigned start, unsigned end) {
+      ConcurrentSkipList<unsigned>::Guard guard = _list.pin();
+      unsigned count = 0;
+      for (ConcurrentSkipList<unsigned>::ConstIterator itr = _list.findHigh(start); itr.valid() and itr.cref() < end; ++itr)
+         ++count;
+      return count;
+   }
+};
+
+//------------------------------------------------------------------------------
+template<typename LIST>
+void run (char const* name, LIST& list, unsigned writers, unsigned readers, double seconds) {
+   // Start with some items, so the readers have something to find. Each
+   // writer's items come from its own generator, which a second copy trails
+   // (for the sliding window).
+   vector<XorShift32> rands, olds;
+   for (unsigned i=0; i<writers; ++i) {
+      rands.push_back(XorShift32(0xa11 + i));
+      olds.push_back(rands.back());
+      for (unsigned j=0; j<100000/writers; ++j)
+         list.add(rands.back().u32());
+   }
+
+   atomic<bool> stop(false);
+   vector<unsigned long> adds(writers), scans(readers), found(readers);
+   vector<thread> threads;
+   for (unsigned i=0; i<writers; ++i) {
+      threads.push_back(thread([&, i] () {
+         XorShift32& rand = rands[i];
+         XorShift32& old = olds[i];
+         unsigned long count = 0;
+         while (!stop.load(memory_order_relaxed)) {
+            for (unsigned j=0; j<64; ++j)
+               list.update(rand.u32(), old.u32());
+            count += 64;
+         }
+         adds[i] = count;
+      }));
+   }
+   for (unsigned i=0; i<readers; ++i) {
+      threads.push_back(thread([&, i] () {
+         XorShift32 rand(0x5ca + i);
+         unsigned long count = 0, items = 0;
+         while (!stop.load(memory_order_relaxed)) {
+            for (unsigned j=0; j<64; ++j) {
+               unsigned start = rand.u32();
+               items += list.scan(start, start + (1u << 20));
+            }
+            count += 64;
+         }
+         scans[i] = count;
+         found[i] = items;
+      }));
+   }
+
+   Timer timer;
+   this_thread::sleep_for(chrono::milliseconds(static_cast<unsigned>(1e3 * seconds)));
+   stop = true;
+   for (thread& t : threads)
+      t.join();
+   double time = timer.seconds();
+
+   unsigned long totalAdds = 0, totalScans = 0, totalFound = 0;
+   for (unsigned long count : adds)
+      totalAdds += count;
+   for (unsigned i=0; i<readers; ++i) {
+      totalScans += scans[i];
+      totalFound += found[i];
+   }
+   cout << "  " << left << setw(24) << name << right
+        << setw(9) << 1e-3 * totalAdds / time << " k adds/s"
+        << setw(9) << 1e-3 * totalScans / time << " k scans/s"
+        << setw(7) << (totalScans ? double(totalFound) / totalScans : 0.0) << " items/scan\n";
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned writers = argc > 1 ? atoi(argv[1]) : 2;
+   unsigned readers = argc > 2 ? atoi(argv[2]) : 2;
+   double seconds = argc > 3 ? atof(argv[3]) : 1.0;
+   cout << writers << " writers, " << readers << " readers, "
+        << thread::hardware_concurrency() << " hardware threads\n" << setprecision(1) << fixed;
+
+   {
+      Locked list;
+      run("SkipList + mutex", list, writers, readers, seconds);
+   }
+   {
+      LockFree list(false);
+      run("ConcurrentSkipList", list, writers, readers, seconds);
+   }
+   {
+      LockFree list(true);
+      run("  sliding window", list, writers, readers, seconds);
+   }
+   return 0;
+}
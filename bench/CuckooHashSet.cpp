@@ -0,0 +1,142 @@
+//==============================================================================
+// CuckooHashSet.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Compares lookups in a CuckooHashSet with lookups in a HashSet holding the
+ * same items. The CuckooHashSet is filled to several loads (fractions of its
+ * slots used), up to 95%. For each load we time adding the items, finding
+ * every added item (in shuffled order), and finding random numbers (nearly
+ * all of which miss). The HashSet has one bin per item, as in main.cpp.
+ *
+ * First it checks that items in the stash survive the table doubling, using
+ * strings that all have the same hash (so some of them must be stashed), and
+ * counting constructions and destructions.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <string>
+#include "MemoryPoolF.h"
+#include "HashSet.hpp"
+#include "CuckooHashSet.hpp"
+#include "Random.h"
+#include "HUnsigned.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// Times adding n numbers and searching for them (and for m random numbers).
+template<class SET>
+void time (SET& set, unsigned* added, unsigned n, unsigned m) {
+   XorShift32 rand(0xdefceedll);
+   for (unsigned i=0; i<n; ++i)
+      added[i] = rand.u32();
+
+   Timer timer;
+   for (unsigned i=0; i<n; ++i)
+      set.add(added[i]);
+   double addTime = timer.seconds();
+
+   // Searching in insertion order would be biased (for HashSet, it walks the pool sequentially).
+   for (unsigned i=n-1; i>0; --i) {
+      unsigned j = rand.u32() % (i+1);
+      unsigned temp = added[i];
+      added[i] = added[j];
+      added[j] = temp;
+   }
+   unsigned found = 0;
+   timer.start();
+   for (unsigned i=0; i<n; ++i) {
+      if (set.find(HUnsigned(added[i])))
+         ++found;
+   }
+   double hitTime = timer.seconds();
+
+   XorShift32 rand2(0xbadcab1e);
+   unsigned hits = 0;
+   timer.start();
+   for (unsigned i=0; i<m; ++i) {
+      if (set.find(HUnsigned(rand2.u32())))
+         ++hits;
+   }
+   double missTime = timer.seconds();
+
+   cout << setprecision(2) << fixed
+        << setw(10) << 1e9 * addTime / n << " ns/add"
+        << setw(10) << 1e9 * hitTime / n << " ns/hit"
+        << setw(10) << 1e9 * missTime / m << " ns/random"
+        << "  (" << found << " found, " << hits << " random hits)";
+}
+
+//------------------------------------------------------------------------------
+// a string that keeps count of how many exist, and whose hash is often the same
+struct CountedString {
+   static int _live;
+   string _s;
+   unsigned _hash;
+   CountedString (string const& s, unsigned hash): _s(s), _hash(hash) { ++_live; }
+   CountedString (CountedString const& cs): _s(cs._s), _hash(cs._hash) { ++_live; }
+   CountedString& operator= (CountedString const&) = default;
+   ~CountedString () { --_live; }
+   unsigned hash () const { return _hash; }
+   bool operator== (CountedString const& cs) const { return _s == cs._s; }
+};
+int CountedString::_live = 0;
+
+//------------------------------------------------------------------------------
+// Stashes some strings, makes the set double a few times, and checks they are all still there.
+bool checkStash () {
+   unsigned const colliding = 10;   // two buckets hold 8, so at least 2 go in the stash
+   unsigned const others = 500;
+   bool ok = true;
+   {
+      CuckooHashSet<CountedString> set(16);
+      for (unsigned i=0; i<colliding; ++i)
+         set.add(CountedString("colliding string number " + to_string(i), 12345));
+      ok = ok and set.stashed() > 0;
+      unsigned buckets = set.buckets();
+      for (unsigned i=0; i<others; ++i)
+         set.add(CountedString("another string number " + to_string(i), i * 2654435761u));
+      ok = ok and set.buckets() > buckets and set.stashed() > 0;
+      for (unsigned i=0; i<colliding; ++i)
+         ok = ok and set.find(CountedString("colliding string number " + to_string(i), 12345));
+      for (unsigned i=0; i<others; ++i)
+         ok = ok and set.find(CountedString("another string number " + to_string(i), i * 2654435761u));
+      ok = ok and set.size() == colliding + others and CountedString::_live == int(set.size());
+   }
+   return ok and CountedString::_live == 0;
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned slots = argc > 1 ? atoi(argv[1]) : 1 << 22;
+   unsigned m = argc > 2 ? atoi(argv[2]) : 10000000;
+   float const loads[] = { 0.5, 0.8, 0.9, 0.95 };
+
+   cout << "stashed items after doubling: " << (checkStash() ? "ok" : "FAILED") << '\n';
+
+   unsigned* added = new unsigned[slots];
+   for (float load : loads) {
+      unsigned n = static_cast<unsigned>(load * slots);
+      cout << "load " << setprecision(2) << fixed << load << " (" << n << " items)\n";
+
+      // the table has exactly `slots` slots (slots must be a power of 2), and doesn't double
+      CuckooHashSet<HUnsigned> cuckoo(static_cast<unsigned>(0.95 * slots), 0.96);
+      cout << "  CuckooHashSet";
+      time(cuckoo, added, n, m);
+      cout << "\n    " << cuckoo.buckets() << " buckets, load " << setprecision(3) << cuckoo.load()
+           << ", " << cuckoo.stashed() << " stashed\n";
+
+      HashSet<HUnsigned, MemoryPoolF> chained(n);
+      cout << "  HashSet      ";
+      time(chained, added, n, m);
+      cout << '\n';
+   }
+   delete[] added;
+   return 0;
+}
@@ -0,0 +1,25 @@
+//==============================================================================
+// HUnsigned.h
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_BENCH_HUNSIGNED
+#define ESTDLIB_BENCH_HUNSIGNED
+
+
+//==============================================================================
+// Struct HUnsigned
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Extends unsigned with the methods required by HashSet (and CuckooHashSet), for the benchmarks.
+struct HUnsigned {
+   unsigned _n;
+   HUnsigned () {}
+   HUnsigned (unsigned n): _n(n) {}
+   unsigned hash () const { return _n; }
+   bool operator== (HUnsigned hu) const { return _n == hu._n; }
+};
+
+
+#endif // ESTDLIB_BENCH_HUNSIGNED
@@ -0,0 +1,62 @@
+//==============================================================================
+// HashSetArena.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Compares HashSets that use MemoryPoolF with insert only HashSets that use
+ * MemoryPool, on main.cpp's workload: a million random numbers are added
+ * to a presized set, and then a million random numbers (nearly all of which
+ * miss) are searched for. The same is repeated with a set that starts small
+ * and grows, so that the old bins are donated to the pool.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "MemoryPool.h"
+#include "MemoryPoolF.h"
+#include "HashSet.hpp"
+#include "Random.h"
+#include "HUnsigned.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+template<class POOL>
+void run (char const* label, unsigned initialBins, unsigned n, unsigned m) {
+   Timer timer;
+   HashSet<HUnsigned, POOL> set(initialBins);
+   XorShift32 rand(0xdefceedll);
+   do {
+      set.add(rand.u32());
+   } while (set.size() <= n);
+   double addTime = timer.seconds();
+
+   timer.start();
+   unsigned hits = 0;
+   for (unsigned i=0; i<m; ++i) {
+      if (set.find(HUnsigned(rand.u32())))
+         ++hits;
+   }
+   double findTime = timer.seconds();
+
+   cout << "  " << setw(12) << left << label << right << setprecision(1) << fixed
+        << "add " << setw(6) << 1e3 * addTime << " ms,  find " << setw(6) << 1e3 * findTime
+        << " ms  (" << hits << " hits)\n";
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned n = argc > 1 ? atoi(argv[1]) : 1000000;
+   unsigned m = argc > 2 ? atoi(argv[2]) : 1000000;
+   cout << "presized set\n";
+   run<MemoryPoolF>("MemoryPoolF", n, n, m);
+   run<MemoryPool> ("MemoryPool",  n, n, m);
+   cout << "growing set\n";
+   run<MemoryPoolF>("MemoryPoolF", 1024, n, m);
+   run<MemoryPool> ("MemoryPool",  1024, n, m);
+   return 0;
+}
@@ -0,0 +1,92 @@
+//==============================================================================
+// HashSetRelayout.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Measures the effect of HashSet::relayout on lookups.
+ * Like main.cpp, it adds a million random numbers to a HashSet and then
+ * searches for random numbers (nearly all of which miss). It also searches
+ * for every number that was added. Both searches are timed before and after
+ * the HashSet's nodes are relaid out in bin order.
+ *
+ * The first set is presized (as in main.cpp), so it never resizes. The second
+ * starts small and is resized many times, with automatic relayout turned off.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "MemoryPoolF.h"
+#include "HashSet.hpp"
+#include "Random.h"
+#include "HUnsigned.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+typedef HashSet<HUnsigned, MemoryPoolF> Set;
+
+//------------------------------------------------------------------------------
+// Searches for m random numbers, and for all n added numbers (in shuffled order).
+void search (Set const& set, unsigned const* added, unsigned n, unsigned m, char const* label) {
+   XorShift32 rand(0xbadcab1e);
+   unsigned hits = 0;
+   Timer timer;
+   for (unsigned i=0; i<m; ++i) {
+      if (set.find(HUnsigned(rand.u32())))
+         ++hits;
+   }
+   double missTime = timer.seconds();
+
+   unsigned found = 0;
+   timer.start();
+   for (unsigned i=0; i<n; ++i) {
+      if (set.find(HUnsigned(added[i])))
+         ++found;
+   }
+   double hitTime = timer.seconds();
+
+   cout << setw(28) << left << label << right
+        << "random: " << setw(7) << setprecision(2) << fixed << 1e9 * missTime / m << " ns/find"
+        << " (" << hits << " hits),  added: " << setw(7) << 1e9 * hitTime / n << " ns/find"
+        << " (" << found << " found)\n";
+}
+
+//------------------------------------------------------------------------------
+void run (unsigned initialBins, unsigned n, unsigned m, char const* label) {
+   Set set(initialBins);
+   set.setRelayoutThreshold(0);
+   XorShift32 rand(0xdefceedll);
+   unsigned* added = new unsigned[n];
+   for (unsigned i=0; i<n; ++i) {
+      added[i] = rand.u32();
+      set.add(added[i]);
+   }
+   // Searching in insertion order would walk through the pool sequentially.
+   for (unsigned i=n-1; i>0; --i) {
+      unsigned j = rand.u32() % (i+1);
+      unsigned temp = added[i];
+      added[i] = added[j];
+      added[j] = temp;
+   }
+
+   cout << label << " (" << set.size() << " items, " << set.bins() << " bins)\n";
+   search(set, added, n, m, "  insertion order");
+   Timer timer;
+   set.relayout();
+   double relayoutTime = timer.seconds();
+   search(set, added, n, m, "  bin order");
+   cout << "  relayout took " << setprecision(3) << relayoutTime * 1e3 << " ms\n";
+   delete[] added;
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned n = argc > 1 ? atoi(argv[1]) : 1000000;
+   unsigned m = argc > 2 ? atoi(argv[2]) : 10000000;
+   run(n, n, m, "Presized HashSet");
+   run(64, n, m, "Grown HashSet");
+   return 0;
+}
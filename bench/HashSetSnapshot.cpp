@@ -0,0 +1,109 @@
+//==============================================================================
+// HashSetSnapshot.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Compares copying a HashSet by adding every item (as operator= used to)
+ * with the structural copy constructor, and measures the cost of taking
+ * Snapshots: taking one, and then the first and later batches of updates
+ * while one is held, against the same updates with no Snapshot.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "MemoryPoolF.h"
+#include "HashSet.hpp"
+#include "HashFunctions.h"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// A 16 byte key, hashed with murmurhash (so, unlike main.cpp's numbers, hashing isn't free).
+struct Key {
+   unsigned _word[4];
+   Key () {}
+   Key (XorShift32& rand) { for (unsigned i=0; i<4; ++i) _word[i] = rand.u32(); }
+   unsigned hash () const { return murmurhash(const_cast<unsigned*>(_word), 4); }
+   bool operator== (Key const& key) const {
+      return _word[0] == key._word[0] and _word[1] == key._word[1]
+         and _word[2] == key._word[2] and _word[3] == key._word[3];
+   }
+};
+
+typedef HashSet<Key, MemoryPoolF> Set;
+
+//------------------------------------------------------------------------------
+// Adds count random keys to set, and removes as many (that were added earlier).
+void update (Set& set, XorShift32& rand, unsigned count) {
+   XorShift32 old = rand;
+   for (unsigned i=0; i<count; ++i)
+      set.add(Key(rand));
+   for (unsigned i=0; i<count; ++i)
+      set.remove(Key(old));
+}
+
+//------------------------------------------------------------------------------
+void run (unsigned n, unsigned updates) {
+   Timer timer;
+   cout << n << " items\n" << setprecision(2) << fixed;
+
+   Set set(n);
+   XorShift32 rand(0x5a95407);
+   for (unsigned i=0; i<n; ++i)
+      set.add(Key(rand));
+   set.relayout();
+
+   // full copies
+   {
+      timer.start();
+      Set copy(set.bins());
+      for (Set::ConstIterator itr = set.constIterator(); itr.valid(); ++itr)
+         copy.add(itr.cref());
+      double addTime = timer.seconds();
+      timer.start();
+      Set clone(set);
+      double cloneTime = timer.seconds();
+      cout << "  copy by add     " << setw(9) << 1e3 * addTime << " ms\n";
+      cout << "  copy constructor" << setw(9) << 1e3 * cloneTime << " ms  (" << clone.size() << " items)\n";
+   }
+
+   // updates with and without a snapshot
+   XorShift32 updateRand(0x0dd5);
+   timer.start();
+   update(set, updateRand, updates);
+   double plainTime = timer.seconds();
+
+   timer.start();
+   Set::Snapshot snapshot = set.snapshot();
+   double snapshotTime = timer.seconds();
+   timer.start();
+   update(set, updateRand, updates);
+   double firstTime = timer.seconds();
+   timer.start();
+   update(set, updateRand, updates);
+   double laterTime = timer.seconds();
+   unsigned seen = 0;
+   for (Set::ConstIterator itr = snapshot.constIterator(); itr.valid(); ++itr)
+      ++seen;
+   snapshot.release();
+
+   cout << "  snapshot        " << setw(9) << 1e6 * snapshotTime << " us\n";
+   cout << "  " << 2 * updates << " updates:\n";
+   cout << "    no snapshot   " << setw(9) << 1e3 * plainTime << " ms\n";
+   cout << "    first batch   " << setw(9) << 1e3 * firstTime << " ms  (copies the chunks they touch)\n";
+   cout << "    later batch   " << setw(9) << 1e3 * laterTime << " ms\n";
+   cout << "  snapshot still has " << seen << " items\n";
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned n = argc > 1 ? atoi(argv[1]) : 2000000;
+   run(n, 1000);
+   run(n, 100000);
+   return 0;
+}
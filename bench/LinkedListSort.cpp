@@ -0,0 +1,134 @@
+//==============================================================================
+// LinkedListSort.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Sorts a LinkedList of random edges (by node1, then node2) in place with
+ * LinkedList::sort, and compares that with copying the items into a vector,
+ * sorting that (with std::sort and std::stable_sort) and copying them back,
+ * and with std::list::sort. The copy needs a second array of all the items
+ * (and stable_sort a buffer as big again), while LinkedList::sort only keeps
+ * 64 pairs of pointers. Then times merging two sorted halves with
+ * LinkedList::merge, and checks that every result is sorted.
+ *
+ * Usage: LinkedListSort [items]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <list>
+#include <vector>
+#include "LinkedList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+struct Edge {
+   unsigned node1;
+   unsigned node2;
+   bool operator< (Edge const& edge) const { return node1 < edge.node1 or (node1 == edge.node1 and node2 < edge.node2); }
+};
+
+//------------------------------------------------------------------------------
+void fill (LinkedList<Edge>& edges, unsigned items, unsigned seed) {
+   XorShift32 rand(seed);
+   for (unsigned i=0; i<items; ++i) {
+      Edge edge = {rand.u32() % (items / 8 + 1), rand.u32() % (items / 8 + 1)};
+      edges.add(edge);
+   }
+}
+
+//------------------------------------------------------------------------------
+template<typename ITR>
+bool sorted (ITR itr) {
+   if (!itr.valid())
+      return true;
+   Edge last = itr.cref();
+   for (++itr; itr.valid(); ++itr) {
+      if (itr.cref() < last)
+         return false;
+      last = itr.cref();
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Sorts edges by copying them into a vector and back.
+template<bool STABLE>
+void sortByCopy (LinkedList<Edge>& edges) {
+   vector<Edge> copy;
+   copy.reserve(edges.size());
+   for (LinkedList<Edge>::CItr itr = edges.citr(); itr.valid(); ++itr)
+      copy.push_back(itr.cref());
+   if (STABLE)
+      stable_sort(copy.begin(), copy.end());
+   else
+      sort(copy.begin(), copy.end());
+   unsigned i = 0;
+   for (LinkedList<Edge>::Itr itr = edges.itr(); itr.valid(); ++itr)
+      itr.ref() = copy[i++];
+}
+
+//------------------------------------------------------------------------------
+void report (char const* name, double seconds, unsigned items, bool ok) {
+   cout << "  " << left << setw(28) << name << right << setw(8) << seconds
+        << setw(8) << 1e9 * seconds / items << " ns/item" << (ok ? "" : "   (not sorted!)") << endl;
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned items = argc > 1 ? atoi(argv[1]) : 1000000;
+   Timer timer;
+   cout << items << " random edges (seconds)" << endl << setprecision(2) << fixed;
+
+   {
+      LinkedList<Edge> edges;
+      fill(edges, items, 1);
+      timer.start();
+      edges.sort();
+      report("LinkedList::sort", timer.seconds(), items, sorted(edges.citr()));
+   }
+   {
+      LinkedList<Edge> edges;
+      fill(edges, items, 1);
+      timer.start();
+      sortByCopy<false>(edges);
+      report("copy, std::sort, copy back", timer.seconds(), items, sorted(edges.citr()));
+   }
+   {
+      LinkedList<Edge> edges;
+      fill(edges, items, 1);
+      timer.start();
+      sortByCopy<true>(edges);
+      report("copy, std::stable_sort, back", timer.seconds(), items, sorted(edges.citr()));
+   }
+   {
+      list<Edge> edges;
+      XorShift32 rand(1);
+      for (unsigned i=0; i<items; ++i) {
+         Edge edge = {rand.u32() % (items / 8 + 1), rand.u32() % (items / 8 + 1)};
+         edges.push_front(edge);
+      }
+      timer.start();
+      edges.sort();
+      double seconds = timer.seconds();
+      report("std::list::sort", seconds, items, is_sorted(edges.begin(), edges.end()));
+   }
+   {
+      LinkedList<Edge> edges, more;
+      fill(edges, items / 2, 2);
+      fill(more, items - items / 2, 3);
+      edges.sort();
+      more.sort();
+      timer.start();
+      edges.merge(more);
+      report("LinkedList::merge of halves", timer.seconds(), items, sorted(edges.citr()) and edges.size() == items);
+   }
+   return 0;
+}
@@ -0,0 +1,70 @@
+//==============================================================================
+// ParallelForEach.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Sums the items of a large HashSet with a ConstIterator, and then with
+ * parallelForEach and parallelForRanges using different numbers of threads.
+ * (The speedup depends on how many cores the machine has.)
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <atomic>
+#include "MemoryPoolF.h"
+#include "HashSet.hpp"
+#include "Random.h"
+#include "HUnsigned.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+typedef HashSet<HUnsigned, MemoryPoolF> Set;
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned n = argc > 1 ? atoi(argv[1]) : 10000000;
+   Set set(n);
+   XorShift32 rand(0xdefceedll);
+   for (unsigned i=0; i<n; ++i)
+      set.add(rand.u32());
+   cout << set.size() << " items, " << set.bins() << " bins, "
+        << thread::hardware_concurrency() << " hardware threads\n";
+
+   Timer timer;
+   unsigned long long sum = 0;
+   for (Set::ConstIterator itr = set.constIterator(); itr.valid(); ++itr)
+      sum += itr.cref()._n;
+   double serialTime = timer.seconds();
+   cout << "ConstIterator:          " << setw(8) << setprecision(2) << fixed << 1e3 * serialTime << " ms  (sum " << sum << ")\n";
+
+   for (unsigned threads = 1; threads <= 8; threads *= 2) {
+      // every item does an atomic add, so this is mostly a measure of contention
+      atomic<unsigned long long> total(0);
+      timer.start();
+      set.parallelForEach([&total] (HUnsigned const& item) {
+         total.fetch_add(item._n, memory_order_relaxed);
+      }, threads);
+      double eachTime = timer.seconds();
+
+      // each chunk is totaled locally, and only added once
+      atomic<unsigned long long> rangeTotal(0);
+      timer.start();
+      set.parallelForRanges([&rangeTotal] (Set::ConstIterator itr) {
+         unsigned long long local = 0;
+         for (; itr.valid(); ++itr)
+            local += itr.cref()._n;
+         rangeTotal.fetch_add(local);
+      }, threads);
+      double rangesTime = timer.seconds();
+
+      cout << threads << " thread(s): parallelForEach " << setw(8) << 1e3 * eachTime << " ms"
+           << (total == sum ? "" : " (wrong sum)")
+           << ",  parallelForRanges " << setw(8) << 1e3 * rangesTime << " ms"
+           << (rangeTotal == sum ? "" : " (wrong sum)") << '\n';
+   }
+   return 0;
+}
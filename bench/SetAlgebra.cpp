@@ -0,0 +1,128 @@
+//==============================================================================
+// SetAlgebra.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Compares HashSet::unionWith, intersectWith and subtract with the obvious
+ * loops of find, add and remove. The two sets have n random 16 byte keys
+ * each, half of which they share. Each operation is timed with both sets
+ * having the same number of bins, and with the second set having a quarter
+ * as many. The sets are relaid out first (as large sets are after they grow).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "MemoryPoolF.h"
+#include "HashSet.hpp"
+#include "HashFunctions.h"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// A 16 byte key, hashed with murmurhash (so, unlike main.cpp's numbers, hashing isn't free).
+struct Key {
+   unsigned _word[4];
+   Key () {}
+   Key (XorShift32& rand) { for (unsigned i=0; i<4; ++i) _word[i] = rand.u32(); }
+   unsigned hash () const { return murmurhash(const_cast<unsigned*>(_word), 4); }
+   bool operator== (Key const& key) const {
+      return _word[0] == key._word[0] and _word[1] == key._word[1]
+         and _word[2] == key._word[2] and _word[3] == key._word[3];
+   }
+};
+
+typedef HashSet<Key, MemoryPoolF> Set;
+
+//------------------------------------------------------------------------------
+// Fills a with n keys and b with n keys, half of which are also in a.
+void fill (Set& a, Set& b, unsigned n) {
+   XorShift32 rand(0x5e7a19e);
+   for (unsigned i=0; i<n; ++i) {
+      Key key(rand);
+      a.add(key);
+      b.add(i & 1 ? key : Key(rand));
+   }
+   a.relayout();
+   b.relayout();
+}
+
+//------------------------------------------------------------------------------
+void report (char const* label, double loopTime, unsigned loopSize, double opTime, unsigned opSize) {
+   cout << "  " << setw(14) << left << label << right << setprecision(1) << fixed
+        << "loop " << setw(7) << 1e3 * loopTime << " ms,  method " << setw(7) << 1e3 * opTime << " ms"
+        << "  (" << loopSize << (loopSize == opSize ? " items)\n" : " items, but the method gave a different size!)\n");
+}
+
+//------------------------------------------------------------------------------
+void run (unsigned n, unsigned bBins, unsigned threads) {
+   Timer timer;
+   double loopTime, opTime;
+   cout << "second set has " << bBins << " bins, " << threads << " thread(s)\n";
+
+   // union
+   {
+      Set a(n), b(bBins), c(n);
+      fill(a, b, n);
+      fill(c, b, n);
+      timer.start();
+      for (Set::ConstIterator itr = b.constIterator(); itr.valid(); ++itr)
+         a.add(itr.cref());
+      loopTime = timer.seconds();
+      timer.start();
+      c.unionWith(b, threads);
+      opTime = timer.seconds();
+      report("union", loopTime, a.size(), opTime, c.size());
+   }
+
+   // intersection
+   {
+      Set a(n), b(bBins), c(n);
+      fill(a, b, n);
+      fill(c, b, n);
+      timer.start();
+      // collect first, since removing while iterating isn't allowed
+      Key* doomed = new Key[n];
+      unsigned count = 0;
+      for (Set::ConstIterator itr = a.constIterator(); itr.valid(); ++itr) {
+         if (!b.find(itr.cref()))
+            doomed[count++] = itr.cref();
+      }
+      for (unsigned i=0; i<count; ++i)
+         a.remove(doomed[i]);
+      loopTime = timer.seconds();
+      delete[] doomed;
+      timer.start();
+      c.intersectWith(b, threads);
+      opTime = timer.seconds();
+      report("intersection", loopTime, a.size(), opTime, c.size());
+   }
+
+   // difference
+   {
+      Set a(n), b(bBins), c(n);
+      fill(a, b, n);
+      fill(c, b, n);
+      timer.start();
+      for (Set::ConstIterator itr = b.constIterator(); itr.valid(); ++itr)
+         a.remove(itr.cref());
+      loopTime = timer.seconds();
+      timer.start();
+      c.subtract(b, threads);
+      opTime = timer.seconds();
+      report("difference", loopTime, a.size(), opTime, c.size());
+   }
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned n = argc > 1 ? atoi(argv[1]) : 2000000;
+   unsigned threads = argc > 2 ? atoi(argv[2]) : 1;
+   run(n, n, threads);
+   run(n, n / 4, threads);
+   return 0;
+}
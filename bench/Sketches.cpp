@@ -0,0 +1,128 @@
+//==============================================================================
+// Sketches.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Compares counting distinct numbers with a HyperLogLog to counting them
+ * exactly with a HashSet, for streams of 20 million random numbers drawn from
+ * different numbers of distinct values. Each stream is also split into four
+ * parts (as if it were processed by four threads) whose HyperLogLogs are
+ * merged.
+ *
+ * Then it counts how often each number appears in a heavy tailed stream with
+ * a CountMinSketch, and compares the estimates to the exact counts.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include "MemoryPoolF.h"
+#include "HashSet.hpp"
+#include "HyperLogLog.h"
+#include "CountMinSketch.h"
+#include "Random.h"
+#include "HUnsigned.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+void distinct (unsigned const* stream, unsigned n, unsigned values) {
+   Timer timer;
+   HashSet<HUnsigned, MemoryPoolF> set(1024);
+   for (unsigned i=0; i<n; ++i)
+      set.add(stream[i]);
+   double setTime = timer.seconds();
+   double setBytes = set.bins() * sizeof(void*) + set.size() * (sizeof(void*) + 2 * sizeof(unsigned));
+
+   timer.start();
+   HyperLogLog hll;
+   for (unsigned i=0; i<n; ++i)
+      hll.add(stream[i]);
+   double hllTime = timer.seconds();
+   double estimate = hll.estimate();
+
+   // four "threads", each with a quarter of the stream
+   HyperLogLog part[4];
+   for (unsigned t=0; t<4; ++t) {
+      for (unsigned i=t*(n/4); i<(t+1)*(n/4); ++i)
+         part[t].add(stream[i]);
+   }
+   timer.start();
+   for (unsigned t=1; t<4; ++t)
+      part[0].merge(part[t]);
+   double merged = part[0].estimate();
+   double mergeTime = timer.seconds();
+
+   cout << setw(9) << values << " values: "
+        << "HashSet " << setw(8) << set.size() << " (" << setw(6) << setprecision(1) << fixed << setBytes / 1048576 << " MB, "
+        << setprecision(2) << 1e9 * setTime / n << " ns/add),  "
+        << "HyperLogLog " << setw(10) << setprecision(0) << estimate
+        << " (" << showpos << setprecision(2) << 100.0 * (estimate - set.size()) / set.size() << noshowpos << "%, "
+        << hll.bytes() / 1024 << " KB, " << 1e9 * hllTime / n << " ns/add),  "
+        << "merged " << setprecision(0) << merged << " in " << setprecision(1) << 1e6 * mergeTime << " us\n";
+}
+
+//------------------------------------------------------------------------------
+void frequencies (unsigned n, unsigned values, unsigned width, unsigned depth) {
+   // numbers are spread log uniformly over [1, values), so number k appears about n / (k ln values) times
+   XorShift32 rand(0xf00d);
+   unsigned* exact = new unsigned[values]();
+   CountMinSketch cms(width, depth);
+   double logValues = log(double(values));
+   Timer timer;
+   for (unsigned i=0; i<n; ++i) {
+      unsigned k = static_cast<unsigned>(exp(logValues * rand.u32() / 4294967296.0));
+      cms.add(k);
+      ++exact[k];
+   }
+   double addTime = timer.seconds();
+
+   double totalOver = 0.0;
+   unsigned withinBound = 0;
+   unsigned seen = 0;
+   timer.start();
+   for (unsigned k=1; k<values; ++k) {
+      unsigned over = cms.estimate(k) - exact[k];
+      totalOver += over;
+      if (over <= cms.errorBound())
+         ++withinBound;
+      if (exact[k])
+         ++seen;
+   }
+   double estimateTime = timer.seconds();
+
+   cout << "CountMinSketch " << cms.width() << " x " << cms.depth() << " (" << cms.bytes() / 1024 << " KB) for "
+        << seen << " distinct numbers: " << setprecision(2) << fixed
+        << 1e9 * addTime / n << " ns/add (with exact counting), " << 1e9 * estimateTime / values << " ns/estimate\n"
+        << "  mean overestimate " << totalOver / values << ", bound " << setprecision(0) << cms.errorBound()
+        << " (" << setprecision(2) << 100.0 * withinBound / (values - 1) << "% of numbers within it, expected >= "
+        << 100.0 * (1.0 - exp(-double(cms.depth()))) << "%)\n";
+   for (unsigned k=1; k<=1000; k*=10)
+      cout << "  number " << setw(4) << k << ": exact " << setw(8) << exact[k] << ", estimate " << setw(8) << cms.estimate(k) << '\n';
+   delete[] exact;
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned n = argc > 1 ? atoi(argv[1]) : 20000000;
+   unsigned* stream = new unsigned[n];
+   for (unsigned values = 1000; values <= 10000000; values *= 10) {
+      XorShift32 rand(values);
+      // the stream is made of values different random numbers
+      unsigned* pool = new unsigned[values];
+      for (unsigned i=0; i<values; ++i)
+         pool[i] = rand.u32();
+      for (unsigned i=0; i<n; ++i)
+         stream[i] = pool[rand.u32() % values];
+      delete[] pool;
+      distinct(stream, n, values);
+   }
+   delete[] stream;
+   cout << '\n';
+   frequencies(n, 1000000, 16384, 4);
+   return 0;
+}
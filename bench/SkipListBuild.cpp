@@ -0,0 +1,86 @@
+//==============================================================================
+// SkipListBuild.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Builds a SkipList from sorted keys with add, with add(hint, item) and with
+ * buildSorted (with even and with random lanes), and then times a full scan
+ * and random finds on each result.
+ *
+ * Usage: SkipListBuild [items]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include "SkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+void use (char const* name, double build, SkipList<unsigned>& list, vector<unsigned> const& keys) {
+   Timer timer;
+   unsigned long sum = 0;
+   timer.start();
+   for (SkipList<unsigned>::ConstIterator itr = list.constIterator(); itr.valid(); ++itr)
+      sum += itr.cref();
+   double scan = timer.seconds();
+
+   XorShift32 rand(0x7e57);
+   unsigned found = 0;
+   timer.start();
+   for (unsigned i=0; i<keys.size(); ++i)
+      found += list.find(keys[rand.u32() % keys.size()]).valid();
+   double find = timer.seconds();
+
+   cout << "  " << left << setw(20) << name << right
+        << setw(8) << 1e9 * build / keys.size()
+        << setw(8) << 1e9 * scan / keys.size()
+        << setw(8) << 1e9 * find / keys.size()
+        << setw(16) << sum << setw(9) << found << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned items = argc > 1 ? atoi(argv[1]) : 1000000;
+   vector<unsigned> keys(items);
+   for (unsigned i=0; i<items; ++i)
+      keys[i] = 3*i;
+
+   Timer timer;
+   cout << items << " sorted items (ns per item)\n" << setprecision(1) << fixed
+        << "                         build    scan    find             sum    found\n";
+   {
+      SkipList<unsigned> list(1);
+      timer.start();
+      for (unsigned key : keys)
+         list.add(key);
+      use("add", timer.seconds(), list, keys);
+   }
+   {
+      SkipList<unsigned> list(1);
+      SkipList<unsigned>::Iterator hint;
+      timer.start();
+      for (unsigned key : keys)
+         hint = list.add(hint, key);
+      use("add(hint)", timer.seconds(), list, keys);
+   }
+   {
+      SkipList<unsigned> list(1);
+      timer.start();
+      list.buildSorted(keys.begin(), keys.end());
+      use("buildSorted", timer.seconds(), list, keys);
+   }
+   {
+      SkipList<unsigned> list(1);
+      timer.start();
+      list.buildSorted(keys.begin(), keys.end(), true);
+      use("  random lanes", timer.seconds(), list, keys);
+   }
+   return 0;
+}
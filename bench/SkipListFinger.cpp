@@ -0,0 +1,98 @@
+//==============================================================================
+// SkipListFinger.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Fills a SkipList with plain add and with add(hint, item) (passing the
+ * Iterator the last add returned), for sorted, reverse sorted, clustered
+ * (short sorted runs starting at random places) and random input, then looks
+ * every item up again in the same order with plain find and find(hint, key).
+ * Random input is there to show the cost of a hint that is no help: moving the
+ * finger a long way takes more steps than searching from the head.
+ *
+ * Usage: SkipListFinger [items]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include "SkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+void run (char const* name, vector<unsigned> const& keys) {
+   Timer timer;
+   unsigned found = 0;
+   cout << "  " << left << setw(16) << name << right;
+
+   {
+      SkipList<unsigned> list(keys.size());
+      timer.start();
+      for (unsigned key : keys)
+         list.add(key);
+      cout << setw(8) << 1e9 * timer.seconds() / keys.size();
+
+      timer.start();
+      for (unsigned key : keys)
+         found += list.find(key).valid();
+      cout << setw(8) << 1e9 * timer.seconds() / keys.size();
+   }
+   {
+      SkipList<unsigned> list(keys.size());
+      SkipList<unsigned>::Iterator hint;
+      timer.start();
+      for (unsigned key : keys)
+         hint = list.add(hint, key);
+      cout << setw(8) << 1e9 * timer.seconds() / keys.size();
+
+      // A found item is the hint for the next key; a miss keeps the old hint.
+      SkipList<unsigned>::ConstIterator at;
+      timer.start();
+      for (unsigned key : keys) {
+         SkipList<unsigned>::ConstIterator itr = list.find(at, key);
+         if (itr.valid()) {
+            at = itr;
+            ++found;
+         }
+      }
+      cout << setw(8) << 1e9 * timer.seconds() / keys.size();
+   }
+   cout << setw(10) << found << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned items = argc > 1 ? atoi(argv[1]) : 1000000;
+   XorShift32 rand(0xf1ed);
+   vector<unsigned> keys(items);
+
+   cout << items << " items (ns per item)\n" << setprecision(1) << fixed
+        << "                       add    find  add(h) find(h)     found\n";
+
+   for (unsigned i=0; i<items; ++i)
+      keys[i] = 2*i;
+   run("sorted", keys);
+
+   for (unsigned i=0; i<items; ++i)
+      keys[i] = 2*(items-i);
+   run("reverse sorted", keys);
+
+   // Runs of 64 nearby keys, each starting somewhere random.
+   unsigned key = 0;
+   for (unsigned i=0; i<items; ++i) {
+      key = i % 64 ? key + 1 + (rand.u32() & 3) : rand.u32() >> 1;
+      keys[i] = key;
+   }
+   run("clustered", keys);
+
+   for (unsigned i=0; i<items; ++i)
+      keys[i] = rand.u32();
+   run("random", keys);
+   return 0;
+}
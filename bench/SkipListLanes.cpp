@@ -0,0 +1,92 @@
+//==============================================================================
+// SkipListLanes.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Compares SkipLists with random lanes (with a few seeds) and deterministic
+ * lanes (setDeterministicLanes), added to in random and in sorted order. For
+ * each it times the adds and finds of keys that are there, and counts the
+ * Links each of those searches compares (pathLength): the mean, the standard
+ * deviation and the longest.
+ *
+ * Usage: SkipListLanes [largest items]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "SkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+void run (char const* name, vector<unsigned> const& keys, unsigned seed) {
+   Timer timer;
+   unsigned items = keys.size();
+   unsigned lookups = items < 1000000 ? items : 1000000;
+   XorShift32 lanes(seed);
+   SkipList<unsigned> list(items, 0.25, &lanes);
+   list.setDeterministicLanes(!seed);
+
+   timer.start();
+   for (unsigned i=0; i<items; ++i)
+      list.add(keys[i]);
+   double add = timer.seconds();
+
+   XorShift32 rand(0xf1d);
+   unsigned found = 0;
+   timer.start();
+   for (unsigned i=0; i<lookups; ++i)
+      found += list.find(keys[rand.u32() % items]).valid();
+   double find = timer.seconds();
+
+   double sum = 0, squares = 0;
+   unsigned longest = 0;
+   for (unsigned i=0; i<lookups; ++i) {
+      unsigned length = list.pathLength(keys[rand.u32() % items]);
+      sum += length;
+      squares += double(length) * length;
+      if (length > longest)
+         longest = length;
+   }
+   double mean = sum / lookups;
+
+   cout << "  " << left << setw(22) << name << right
+        << setw(8) << 1e9 * add / items
+        << setw(8) << 1e9 * find / lookups
+        << setw(8) << mean
+        << setw(8) << sqrt(squares / lookups - mean * mean)
+        << setw(8) << longest << setw(10) << found << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned largest = argc > 1 ? atoi(argv[1]) : 1000000;
+   cout << setprecision(1) << fixed;
+   for (unsigned items=10000; items<=largest; items*=10) {
+      vector<unsigned> keys(items);
+      XorShift32 rand(0x5eed);
+      for (unsigned& key : keys)
+         key = rand.u32();
+
+      for (unsigned sorted=0; sorted<2; ++sorted) {
+         if (sorted)
+            sort(keys.begin(), keys.end());
+         cout << items << (sorted ? " sorted" : " random") << " items (ns per add and find, Links compared per search)\n"
+              << "                             add    find    mean  stddev longest     found\n";
+         run("random lanes, seed 1", keys, 1);
+         run("random lanes, seed 2", keys, 2);
+         run("random lanes, seed 3", keys, 3);
+         run("deterministic lanes", keys, 0);
+      }
+      cout << '\n';
+   }
+   return 0;
+}
@@ -0,0 +1,139 @@
+//==============================================================================
+// SkipListQueue.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Runs a timer queue, as a scheduler's timer wheel would: each step fires the
+ * earliest timer and arms it again a random delay later, and every few steps
+ * (one in 4 by default) a pending timer is moved to a new deadline, as when a
+ * timeout is pushed back or pulled in. DoubleSkipList relinks the handles
+ * add returned in both cases, and a last run pops each fired timer and adds
+ * it again instead. std::priority_queue, a binary heap, can't move a timer,
+ * so it pushes the new deadline and skips the old one when it comes up (lazy
+ * deletion). Deadlines are unique, so all of them fire the same timers in the
+ * same order.
+ *
+ * Usage: SkipListQueue [steps [moves per 16 steps]]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <queue>
+#include <vector>
+#include <functional>
+#include "DoubleSkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+/// A timer, ordered by its deadline (which has the timer's id in its low bits, to keep it unique).
+struct Alarm {
+   unsigned long deadline;
+   bool operator<  (Alarm const& alarm) const { return deadline <  alarm.deadline; }
+   bool operator== (Alarm const& alarm) const { return deadline == alarm.deadline; }
+};
+
+//------------------------------------------------------------------------------
+unsigned long deadline (unsigned long now, XorShift32& rand, unsigned id) {
+   return ((now >> 20) + 1 + rand.u32() % 4096) << 20 | id;
+}
+
+//------------------------------------------------------------------------------
+// Runs the DoubleSkipList, holding the handles add returned, and returns the sum of the deadlines fired.
+unsigned long runList (unsigned timers, unsigned steps, unsigned moves, bool pop, double& time) {
+   Timer timer;
+   unsigned long sum = 0;
+   XorShift32 rand(0x7173);
+   vector<Alarm> alarms(timers);
+   vector<DoubleSkipList<Alarm>::Iterator> handles;
+   DoubleSkipList<Alarm> list(timers);
+   for (unsigned id=0; id<timers; ++id) {
+      alarms[id].deadline = deadline(0, rand, id);
+      handles.push_back(list.add(alarms[id]));
+   }
+   timer.start();
+   for (unsigned i=0; i<steps; ++i) {
+      unsigned long now = list.begin()->deadline;
+      unsigned id = now & 0xfffff;
+      sum += now;
+      alarms[id].deadline = deadline(now, rand, id);
+      if (pop) {
+         list.popFront();
+         handles[id] = list.add(alarms[id]);
+      } else {
+         list.relink(handles[id]);
+      }
+      if (rand.u32() % 16 < moves) {
+         unsigned moved = rand.u32() % timers;
+         alarms[moved].deadline = deadline(now, rand, moved);
+         list.relink(handles[moved]);
+      }
+   }
+   time = timer.seconds();
+   return sum;
+}
+
+//------------------------------------------------------------------------------
+void run (unsigned timers, unsigned steps, unsigned moves) {
+   Timer timer;
+   cout << timers << " timers" << setprecision(1) << fixed;
+
+   double listTime, popTime;
+   unsigned long listSum = runList(timers, steps, moves, false, listTime);
+   unsigned long popSum = runList(timers, steps, moves, true, popTime);
+
+   // std::priority_queue, skipping the deadlines that were moved
+   double heapTime;
+   unsigned long heapSum = 0;
+   unsigned stale = 0;
+   {
+      XorShift32 rand(0x7173);
+      vector<unsigned long> current(timers);
+      priority_queue<unsigned long, vector<unsigned long>, greater<unsigned long> > heap;
+      for (unsigned id=0; id<timers; ++id) {
+         current[id] = deadline(0, rand, id);
+         heap.push(current[id]);
+      }
+      timer.start();
+      for (unsigned i=0; i<steps; ++i) {
+         unsigned long fired = heap.top();
+         heap.pop();
+         unsigned id = fired & 0xfffff;
+         if (current[id] != fired) {
+            ++stale;
+            --i;
+            continue;
+         }
+         heapSum += fired;
+         current[id] = deadline(fired, rand, id);
+         heap.push(current[id]);
+         if (rand.u32() % 16 < moves) {
+            unsigned moved = rand.u32() % timers;
+            current[moved] = deadline(fired, rand, moved);
+            heap.push(current[moved]);
+         }
+      }
+      heapTime = timer.seconds();
+      stale += heap.size() - timers;
+   }
+
+   cout << (listSum == heapSum and popSum == heapSum ? "" : " (mismatch!)") << '\n'
+        << "  DoubleSkipList       " << setw(8) << 1e9 * listTime / steps << " ns/step\n"
+        << "    popFront and add   " << setw(8) << 1e9 * popTime / steps << " ns/step\n"
+        << "  std::priority_queue  " << setw(8) << 1e9 * heapTime / steps << " ns/step"
+        << "   (" << stale << " stale deadlines)\n";
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned steps = argc > 1 ? atoi(argv[1]) : 2000000;
+   unsigned moves = argc > 2 ? atoi(argv[2]) : 4;
+   for (unsigned timers=1000; timers<=1000000; timers*=10)
+      run(timers, steps, moves);
+   return 0;
+}
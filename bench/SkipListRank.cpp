@@ -0,0 +1,110 @@
+//==============================================================================
+// SkipListRank.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Tracks the median, 95th and 99th percentiles of a sliding window of
+ * latencies: each step adds a latency, removes the one that was added a
+ * window ago, and reads the three percentiles. SkipList and DoubleSkipList
+ * read them with at(), while std::multiset has to walk to them (from
+ * whichever end is nearer), so it runs fewer steps.
+ *
+ * Usage: SkipListRank [window [steps]]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <iterator>
+#include <set>
+#include <vector>
+#include "SkipList.hpp"
+#include "DoubleSkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// Returns the index of the pct-th percentile in a window of size items.
+unsigned percentile (unsigned size, unsigned pct) {
+   return static_cast<unsigned long>(size - 1) * pct / 100;
+}
+
+//------------------------------------------------------------------------------
+void report (char const* name, double time, unsigned steps, unsigned long sum) {
+   cout << "  " << left << setw(16) << name << right << setw(10) << 1e9 * time / steps << " ns/step"
+        << setw(16) << sum << '\n';
+}
+
+//------------------------------------------------------------------------------
+void run (unsigned window, unsigned steps) {
+   Timer timer;
+   cout << window << " latencies in the window (ns per step, and a checksum)\n" << setprecision(1) << fixed;
+
+   // Mostly short latencies with a long tail.
+   vector<unsigned> latencies(window + steps);
+   XorShift32 rand(0x9e7c);
+   for (unsigned& latency : latencies) {
+      latency = 100 + (rand.u32() & 1023);
+      if ((rand.u32() & 31) == 0)
+         latency += rand.u32() & 0xfffff;
+   }
+
+   {
+      SkipList<unsigned> list(window);
+      for (unsigned i=0; i<window; ++i)
+         list.add(latencies[i]);
+      unsigned long sum = 0;
+      timer.start();
+      for (unsigned i=window; i<window+steps; ++i) {
+         list.add(latencies[i]);
+         list.remove(latencies[i - window]);
+         sum += list.at(percentile(window, 50)).cref() + list.at(percentile(window, 95)).cref()
+              + list.at(percentile(window, 99)).cref();
+      }
+      report("SkipList", timer.seconds(), steps, sum);
+   }
+   {
+      DoubleSkipList<unsigned> list(window);
+      for (unsigned i=0; i<window; ++i)
+         list.add(latencies[i]);
+      unsigned long sum = 0;
+      timer.start();
+      for (unsigned i=window; i<window+steps; ++i) {
+         list.add(latencies[i]);
+         list.remove(latencies[i - window]);
+         sum += *list.at(percentile(window, 50)) + *list.at(percentile(window, 95)) + *list.at(percentile(window, 99));
+      }
+      report("DoubleSkipList", timer.seconds(), steps, sum);
+   }
+   {
+      unsigned fewer = steps / 100;
+      multiset<unsigned> set(latencies.begin(), latencies.begin() + window);
+      unsigned long sum = 0;
+      timer.start();
+      for (unsigned i=window; i<window+fewer; ++i) {
+         set.insert(latencies[i]);
+         set.erase(set.find(latencies[i - window]));
+         sum += *next(set.begin(), percentile(window, 50)) + *prev(set.end(), window - percentile(window, 95))
+              + *prev(set.end(), window - percentile(window, 99));
+      }
+      report("std::multiset", timer.seconds(), fewer, sum);
+   }
+   cout << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned window = argc > 1 ? atoi(argv[1]) : 0;
+   unsigned steps = argc > 2 ? atoi(argv[2]) : 1000000;
+   if (window) {
+      run(window, steps);
+   } else {
+      run(1000, steps);
+      run(100000, steps);
+   }
+   return 0;
+}
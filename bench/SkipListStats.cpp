@@ -0,0 +1,88 @@
+//==============================================================================
+// SkipListStats.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Uses SkipListStats to compare linkProbs: for each it fills a SkipList with
+ * random keys and finds keys that are there, and prints the mean and
+ * standard deviation of the Links each add and find stepped onto, the lanes
+ * each find dropped, the comparisons each find made (Links plus lanes), and
+ * the time per find. Each size is also timed with the default
+ * NoSkipListStats, to show what counting costs.
+ *
+ * Usage: SkipListStats [items]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "SkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+template<typename STATS>
+double timeFinds (SkipList<unsigned, STATS>& list, vector<unsigned> const& keys, unsigned lookups, unsigned& found) {
+   Timer timer;
+   XorShift32 rand(0xf1d);
+   found = 0;
+   timer.start();
+   for (unsigned i=0; i<lookups; ++i)
+      found += list.find(keys[rand.u32() % keys.size()]).valid();
+   return timer.seconds();
+}
+
+//------------------------------------------------------------------------------
+void run (vector<unsigned> const& keys, float linkProb) {
+   unsigned items = keys.size();
+   unsigned lookups = items < 1000000 ? items : 1000000;
+   unsigned found;
+
+   SkipList<unsigned, SkipListStats> list(items, linkProb);
+   for (unsigned i=0; i<items; ++i)
+      list.add(keys[i]);
+   list.stats().reset();
+   double time = timeFinds(list, keys, lookups, found);
+   SkipListCosts::Op const& find = list.stats().costs().find;
+
+   SkipList<unsigned, SkipListStats> added(items, linkProb);
+   for (unsigned i=0; i<items; ++i)
+      added.add(keys[i]);
+   SkipListCosts::Op const& add = added.stats().costs().add;
+
+   SkipList<unsigned> plain(items, linkProb);
+   for (unsigned i=0; i<items; ++i)
+      plain.add(keys[i]);
+   double plainTime = timeFinds(plain, keys, lookups, found);
+
+   cout << "  1/" << left << setw(6) << 1.0 / linkProb << right
+        << setw(8) << add.meanLinks() << setw(8) << sqrt(add.varianceLinks())
+        << setw(8) << find.meanLinks() << setw(8) << sqrt(find.varianceLinks())
+        << setw(8) << find.meanDrops() << setw(8) << find.meanLinks() + find.meanDrops() + 1
+        << setw(8) << 1e9 * time / lookups << setw(8) << 1e9 * plainTime / lookups
+        << setw(10) << found << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned items = argc > 1 ? atoi(argv[1]) : 1000000;
+   vector<unsigned> keys(items);
+   XorShift32 rand(0x5eed);
+   for (unsigned& key : keys)
+      key = rand.u32();
+
+   cout << items << " random items (Links stepped onto per add and find, lanes dropped and comparisons per find,\n"
+        << "ns per find with SkipListStats and with NoSkipListStats)\n"
+        << "  linkProb  add    stddev    find  stddev   drops compares   ns/find   plain     found\n"
+        << setprecision(1) << fixed;
+   float const linkProbs[] = {1.0/2, 1.0/3, 1.0/4, 1.0/6, 1.0/8, 1.0/16};
+   for (float linkProb : linkProbs)
+      run(keys, linkProb);
+   return 0;
+}
@@ -0,0 +1,136 @@
+//==============================================================================
+// SkipListWindow.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Keeps a sliding window of events in SkipList, DoubleSkipList and
+ * std::multiset: each step adds an event and removes one that was added a
+ * window ago. Events arrive roughly (not exactly) in time order, so the one
+ * removed is usually near the front. A second run removes the oldest event
+ * by key rather than through an iterator. At the end the window is drained,
+ * which drops the skiplists' lanes back down.
+ *
+ * Usage: SkipListWindow [window [steps]]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <set>
+#include <vector>
+#include "SkipList.hpp"
+#include "DoubleSkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// Returns the time of the next event, which may arrive a little out of order.
+unsigned long nextTime (XorShift32& rand, unsigned long& clock) {
+   clock += 16;
+   return clock + (rand.u32() & 255);
+}
+
+//------------------------------------------------------------------------------
+void run (unsigned window, unsigned steps) {
+   Timer timer;
+   cout << window << " events in the window, " << steps << " steps\n" << setprecision(1) << fixed;
+
+   // The times of the events, in the order they were added (so times[i - window] leaves at step i).
+   vector<unsigned long> times(window + steps);
+   XorShift32 rand(0x3f1d);
+   unsigned long clock = 0;
+   for (unsigned long& time : times)
+      time = nextTime(rand, clock);
+
+   // SkipList, removing the first event
+   {
+      SkipList<unsigned long> list(window);
+      for (unsigned i=0; i<window; ++i)
+         list.add(times[i]);
+      timer.start();
+      for (unsigned i=window; i<window+steps; ++i) {
+         list.add(times[i]);
+         list.remove(list.iterator());
+      }
+      double time = timer.seconds();
+      cout << "  SkipList        pop front" << setw(8) << 1e9 * time / steps << " ns/step\n";
+
+      timer.start();
+      for (unsigned i=0; i<window; ++i)
+         list.remove(list.iterator());
+      cout << "    drained in " << 1e3 * timer.seconds() << " ms\n";
+      list.printStats();
+   }
+
+   // SkipList, removing by key
+   {
+      SkipList<unsigned long> list(window);
+      for (unsigned i=0; i<window; ++i)
+         list.add(times[i]);
+      timer.start();
+      for (unsigned i=window; i<window+steps; ++i) {
+         list.add(times[i]);
+         list.remove(times[i - window]);
+      }
+      double time = timer.seconds();
+      cout << "  SkipList        by key   " << setw(8) << 1e9 * time / steps << " ns/step\n";
+   }
+
+   // DoubleSkipList (which holds pointers), removing by key
+   {
+      DoubleSkipList<unsigned long> list(window);
+      for (unsigned i=0; i<window; ++i)
+         list.add(times[i]);
+      timer.start();
+      for (unsigned i=window; i<window+steps; ++i) {
+         list.add(times[i]);
+         list.remove(times[i - window]);
+      }
+      double time = timer.seconds();
+      cout << "  DoubleSkipList  by key   " << setw(8) << 1e9 * time / steps << " ns/step\n";
+   }
+
+   // std::multiset
+   {
+      multiset<unsigned long> set;
+      for (unsigned i=0; i<window; ++i)
+         set.insert(times[i]);
+      timer.start();
+      for (unsigned i=window; i<window+steps; ++i) {
+         set.insert(times[i]);
+         set.erase(set.begin());
+      }
+      double time = timer.seconds();
+      cout << "  std::multiset   pop front" << setw(8) << 1e9 * time / steps << " ns/step\n";
+   }
+   {
+      multiset<unsigned long> set;
+      for (unsigned i=0; i<window; ++i)
+         set.insert(times[i]);
+      timer.start();
+      for (unsigned i=window; i<window+steps; ++i) {
+         set.insert(times[i]);
+         set.erase(set.find(times[i - window]));
+      }
+      double time = timer.seconds();
+      cout << "  std::multiset   by key   " << setw(8) << 1e9 * time / steps << " ns/step\n";
+   }
+   cout << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned window = argc > 1 ? atoi(argv[1]) : 0;
+   unsigned steps = argc > 2 ? atoi(argv[2]) : 1000000;
+   if (window) {
+      run(window, steps);
+   } else {
+      run(1000, steps);
+      run(100000, steps);
+   }
+   return 0;
+}
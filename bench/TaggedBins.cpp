@@ -0,0 +1,63 @@
+//==============================================================================
+// TaggedBins.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Compares HashSets with plain bins and with tagged bins (HashSetTaggedBins)
+ * on main.cpp's workload: a million random numbers are added to a presized
+ * set, and then random numbers (nearly all of which miss) are searched for.
+ * The searches are timed, and repeated with HashSetStats to count the nodes
+ * each miss has to look at.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "MemoryPoolF.h"
+#include "HashSet.hpp"
+#include "Random.h"
+#include "HUnsigned.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+template<class BINS>
+void run (char const* label, unsigned n, unsigned m) {
+   HashSet<HUnsigned, MemoryPoolF, HashSetNoStats, BINS> set(n);
+   HashSet<HUnsigned, MemoryPoolF, HashSetStats, BINS> counted(n);
+   XorShift32 rand(0xdefceedll);
+   do {
+      unsigned number = rand.u32();
+      set.add(number);
+      counted.add(number);
+   } while (set.size() <= n);
+
+   XorShift32 search = rand;
+   Timer timer;
+   unsigned hits = 0;
+   for (unsigned i=0; i<m; ++i) {
+      if (set.find(HUnsigned(search.u32())))
+         ++hits;
+   }
+   double findTime = timer.seconds();
+
+   for (unsigned i=0; i<m; ++i)
+      counted.find(HUnsigned(rand.u32()));
+   HashSetTelemetry telemetry = counted.telemetry();
+
+   cout << "  " << setw(8) << left << label << right << setprecision(1) << fixed
+        << "find " << setw(6) << 1e3 * findTime << " ms  (" << hits << " hits),  "
+        << setprecision(3) << telemetry.probesPerMiss() << " nodes read per miss\n";
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char * const argv[]) {
+   unsigned n = argc > 1 ? atoi(argv[1]) : 1000000;
+   unsigned m = argc > 2 ? atoi(argv[2]) : 4000000;
+   run<HashSetPlainBins> ("plain",  n, m);
+   run<HashSetTaggedBins>("tagged", n, m);
+   return 0;
+}
@@ -0,0 +1,32 @@
+//==============================================================================
+// Timer.h
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_BENCH_TIMER
+#define ESTDLIB_BENCH_TIMER
+
+#include <chrono>
+
+
+//==============================================================================
+// Class Timer
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// A wall clock stopwatch for the benchmarks. It starts running when it is constructed.
+class Timer {
+private:
+   std::chrono::steady_clock::time_point _start;
+
+public:
+   Timer () { start(); }
+   void start () { _start = std::chrono::steady_clock::now(); }
+   // Returns the number of seconds since the Timer was (re)started.
+   double seconds () const {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+   }
+};
+
+
+#endif // ESTDLIB_BENCH_TIMER
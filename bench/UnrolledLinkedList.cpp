@@ -0,0 +1,112 @@
+//==============================================================================
+// UnrolledLinkedList.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Builds many short lists at once, as a graph's edge lists are built (each
+ * item goes to the head of a random list, so a LinkedList's Links end up
+ * scattered), then times a traversal of all of them and the adding of an
+ * item after every other item through an Itr. Compares LinkedList against
+ * UnrolledLinkedLists (sharing a MemoryPool) with 8, 16 and 32 items per
+ * Node.
+ *
+ * Usage: UnrolledLinkedList [items [lists]]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include "LinkedList.hpp"
+#include "UnrolledLinkedList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+template<typename LIST>
+LIST* make (MemoryPool& pool) { return new LIST(pool); }
+template<>
+LinkedList<unsigned>* make<LinkedList<unsigned> > (MemoryPool& pool) { return new LinkedList<unsigned>; }
+
+//------------------------------------------------------------------------------
+template<typename LIST>
+unsigned long traverse (vector<LIST*> const& lists) {
+   unsigned long sum = 0;
+   for (unsigned l=0; l<lists.size(); ++l) {
+      LIST const& list = *lists[l];
+      for (typename LIST::CItr itr = list.citr(); itr.valid(); ++itr)
+         sum += itr.cref();
+   }
+   return sum;
+}
+
+//------------------------------------------------------------------------------
+template<typename LIST>
+void run (char const* name, unsigned items, unsigned lists) {
+   Timer timer;
+   MemoryPool pool(1 << 16, 8);
+   vector<LIST*> heads(lists);
+   for (unsigned l=0; l<lists; ++l)
+      heads[l] = make<LIST>(pool);
+
+   XorShift32 rand(0xed9e);
+   timer.start();
+   for (unsigned i=0; i<items; ++i)
+      heads[rand.u32() % lists]->add(i);
+   double build = timer.seconds();
+
+   unsigned const passes = 10;
+   unsigned long sum = 0;
+   timer.start();
+   for (unsigned p=0; p<passes; ++p)
+      sum += traverse(heads);
+   double walk = timer.seconds();
+
+   timer.start();
+   for (unsigned l=0; l<lists; ++l) {
+      typename LIST::Itr itr = heads[l]->itr();
+      while (itr.valid()) {
+         ++(itr = heads[l]->add(itr, items));
+         if (itr.valid())
+            ++itr;
+      }
+   }
+   double insert = timer.seconds();
+   unsigned added = 0;
+   for (unsigned l=0; l<lists; ++l)
+      added += heads[l]->size();
+   added -= items;
+
+   timer.start();
+   sum += traverse(heads);
+   double walkAgain = timer.seconds();
+
+   for (unsigned l=0; l<lists; ++l)
+      delete heads[l];
+
+   cout << "  " << left << setw(26) << name << right
+        << setw(8) << 1e9 * build / items
+        << setw(8) << 1e9 * walk / (passes * items)
+        << setw(8) << 1e9 * insert / added
+        << setw(8) << 1e9 * walkAgain / (items + added)
+        << setw(18) << sum << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned items = argc > 1 ? atoi(argv[1]) : 10000000;
+   unsigned lists = argc > 2 ? atoi(argv[2]) : 100000;
+   cout << items << " items in " << lists << " lists (ns per add at the head, per item traversed,\n"
+        << "per add after an Itr, and per item traversed after those)\n"
+        << "                               add    walk  insert    walk               sum\n"
+        << setprecision(1) << fixed;
+   run<LinkedList<unsigned> >("LinkedList", items, lists);
+   run<UnrolledLinkedList<unsigned, 8> >("UnrolledLinkedList<8>", items, lists);
+   run<UnrolledLinkedList<unsigned, 16> >("UnrolledLinkedList<16>", items, lists);
+   run<UnrolledLinkedList<unsigned, 32> >("UnrolledLinkedList<32>", items, lists);
+   return 0;
+}
@@ -0,0 +1,115 @@
+//==============================================================================
+// UnrolledSkipList.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * Fills a SkipList, an UnrolledSkipList and a BPlusTree with random keys,
+ * and reports the memory each takes per item (as counted by malloc), and
+ * the time per add, per random find of a key that is there, and per short
+ * range scan (findHigh and then 100 steps). A last run adds the keys in
+ * order, which leaves the UnrolledSkipList's Nodes full.
+ *
+ * Usage: UnrolledSkipList [largest items]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <malloc.h>
+#include "SkipList.hpp"
+#include "UnrolledSkipList.hpp"
+#include "BPlusTree.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// Returns the bytes malloc has handed out and not had back.
+size_t heapInUse () {
+   struct mallinfo2 info = mallinfo2();
+   return info.uordblks + info.hblkhd;
+}
+
+//------------------------------------------------------------------------------
+template<typename LIST>
+void run (char const* name, vector<unsigned> const& keys) {
+   Timer timer;
+   unsigned items = keys.size();
+   unsigned lookups = items < 1000000 ? items : 1000000;
+   unsigned scans = lookups / 10;
+
+   size_t before = heapInUse();
+   LIST* list = new LIST;
+   timer.start();
+   for (unsigned i=0; i<items; ++i)
+      list->add(keys[i]);
+   double add = timer.seconds();
+   double bytes = double(heapInUse() - before) / items;
+
+   LIST const& clist = *list;
+   XorShift32 rand(0xf1d);
+   unsigned found = 0;
+   timer.start();
+   for (unsigned i=0; i<lookups; ++i)
+      found += clist.find(keys[rand.u32() % items]).valid();
+   double find = timer.seconds();
+
+   unsigned long sum = 0;
+   timer.start();
+   for (unsigned i=0; i<scans; ++i) {
+      typename LIST::ConstIterator itr = clist.findHigh(rand.u32());
+      for (unsigned j=0; j<100 and itr.valid(); ++j, ++itr)
+         sum += itr.cref();
+   }
+   double scan = timer.seconds();
+   delete list;
+
+   cout << "  " << left << setw(18) << name << right
+        << setw(8) << bytes
+        << setw(8) << 1e9 * add / items
+        << setw(8) << 1e9 * find / lookups
+        << setw(8) << 1e9 * scan / scans
+        << setw(22) << sum << setw(9) << found << '\n';
+}
+
+//------------------------------------------------------------------------------
+// SkipList is told how many items to expect.
+struct SizedSkipList : public SkipList<unsigned> {
+   static unsigned capacity;
+   SizedSkipList (): SkipList<unsigned>(capacity) {}
+};
+unsigned SizedSkipList::capacity = 1;
+
+//------------------------------------------------------------------------------
+void runAll (vector<unsigned> const& keys, char const* order) {
+   cout << keys.size() << ' ' << order << " items (bytes per item, and ns per add, find, scan of 100)\n"
+        << "                       bytes     add    find    scan                   sum    found\n";
+   SizedSkipList::capacity = keys.size();
+   run<SizedSkipList>("SkipList", keys);
+   run<UnrolledSkipList<unsigned> >("UnrolledSkipList", keys);
+   run<UnrolledSkipList<unsigned, 32> >("  32 per Node", keys);
+   run<BPlusTree<unsigned> >("BPlusTree", keys);
+   cout << '\n';
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned largest = argc > 1 ? atoi(argv[1]) : 10000000;
+   cout << setprecision(1) << fixed;
+   vector<unsigned> keys;
+   for (unsigned items=100000; items<=largest; items*=10) {
+      keys.resize(items);
+      XorShift32 rand(0x5eed);
+      for (unsigned& key : keys)
+         key = rand.u32();
+      runAll(keys, "random");
+   }
+   sort(keys.begin(), keys.end());
+   runAll(keys, "sorted");
+   return 0;
+}
@@ -0,0 +1,165 @@
+//==============================================================================
+// VersionedSkipList.cpp
+// Created October 18 2026
+//==============================================================================
+
+/*
+ * A writer thread keeps a sliding window of events (adding one and removing
+ * an old one per step) while a reader thread scans the whole window over and
+ * over. With a plain SkipList the reader has to hold the lock for a whole
+ * scan. With a VersionedSkipList it takes a Snapshot under the lock and then
+ * only holds it for batches of steps, so the writer is held up for much less
+ * time and still every scan sees one version. Reports the writer's steps per
+ * second, the longest it waited for the lock, and the scans done.
+ *
+ * First it checks that Snapshots (including one assigned to itself, and
+ * copies) keep seeing their version, and that removed items are unlinked
+ * once the last of them is released.
+ *
+ * Usage: VersionedSkipList [window [seconds [batch]]]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "SkipList.hpp"
+#include "VersionedSkipList.hpp"
+#include "Random.h"
+#include "Timer.h"
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+template<typename LIST>
+void fill (LIST& list, unsigned window) {
+   XorShift32 rand(0x3f1d);
+   for (unsigned i=0; i<window; ++i)
+      list.add(rand.u32());
+}
+
+//------------------------------------------------------------------------------
+// The writer's side, after fill. Returns the steps taken and the longest wait in seconds.
+template<typename LIST>
+void write (LIST& list, mutex& lock, atomic<bool>& stop, unsigned window, unsigned long& steps, double& longest) {
+   XorShift32 rand(0x3f1d), old(0x3f1d);
+   Timer timer;
+   for (unsigned i=0; i<window; ++i)
+      rand.u32();
+   steps = 0;
+   longest = 0;
+   while (!stop.load(memory_order_relaxed)) {
+      timer.start();
+      lock_guard<mutex> guard(lock);
+      double waited = timer.seconds();
+      if (waited > longest)
+         longest = waited;
+      list.add(rand.u32());
+      list.remove(old.u32());
+      ++steps;
+   }
+}
+
+//------------------------------------------------------------------------------
+void report (char const* name, unsigned long steps, double longest, unsigned long scans, double seconds, unsigned long sum) {
+   cout << "  " << left << setw(24) << name << right
+        << setw(9) << 1e-3 * steps / seconds << " k steps/s"
+        << setw(9) << 1e3 * longest << " ms longest wait"
+        << setw(6) << scans << " scans" << setw(24) << sum << '\n';
+}
+
+//------------------------------------------------------------------------------
+// Counts the items a Snapshot sees.
+unsigned count (VersionedSkipList<unsigned>::Snapshot const& snapshot) {
+   unsigned n = 0;
+   for (VersionedSkipList<unsigned>::ConstIterator itr = snapshot.constIterator(); itr.valid(); ++itr)
+      ++n;
+   return n;
+}
+
+//------------------------------------------------------------------------------
+bool checkSnapshots () {
+   VersionedSkipList<unsigned> list(100);
+   for (unsigned i=0; i<100; ++i)
+      list.add(i);
+   VersionedSkipList<unsigned>::Snapshot snapshot = list.snapshot();
+   VersionedSkipList<unsigned>::Snapshot& same = snapshot;
+   snapshot = same;
+   bool ok = snapshot.valid() and list.snapshots() == 1;
+   for (unsigned i=0; i<10; ++i)
+      list.remove(i);
+   VersionedSkipList<unsigned>::Snapshot copy;
+   copy = snapshot;
+   snapshot.release();
+   ok = ok and count(copy) == 100 and list.marked() == 10 and list.size() == 90;
+   copy = same;
+   ok = ok and list.snapshots() == 0 and list.marked() == 0 and list.list().size() == 90;
+   return ok;
+}
+
+//------------------------------------------------------------------------------
+int main (int argc, char** argv) {
+   unsigned window = argc > 1 ? atoi(argv[1]) : 1000000;
+   double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+   unsigned batch = argc > 3 ? atoi(argv[3]) : 256;
+   cout << "snapshots: " << (checkSnapshots() ? "ok" : "FAILED") << '\n';
+   cout << window << " events in the window, scans in batches of " << batch << '\n' << setprecision(2) << fixed;
+
+   // SkipList: each scan holds the lock throughout.
+   {
+      SkipList<unsigned> list(window);
+      mutex lock;
+      atomic<bool> stop(false);
+      unsigned long steps, scans = 0, sum = 0;
+      double longest;
+      fill(list, window);
+      thread writer(write<SkipList<unsigned> >, ref(list), ref(lock), ref(stop), window, ref(steps), ref(longest));
+      Timer timer;
+      while (timer.seconds() < seconds) {
+         lock_guard<mutex> guard(lock);
+         for (SkipList<unsigned>::ConstIterator itr = list.constIterator(); itr.valid(); ++itr)
+            sum += itr.cref();
+         ++scans;
+      }
+      stop = true;
+      writer.join();
+      report("SkipList", steps, longest, scans, timer.seconds(), sum);
+   }
+
+   // VersionedSkipList: each scan reads a Snapshot, a batch at a time.
+   {
+      VersionedSkipList<unsigned> list(window);
+      mutex lock;
+      atomic<bool> stop(false);
+      unsigned long steps, scans = 0, sum = 0;
+      double longest;
+      unsigned marked = 0;
+      fill(list, window);
+      thread writer(write<VersionedSkipList<unsigned> >, ref(list), ref(lock), ref(stop), window, ref(steps), ref(longest));
+      Timer timer;
+      while (timer.seconds() < seconds) {
+         unique_lock<mutex> guard(lock);
+         VersionedSkipList<unsigned>::Snapshot snapshot = list.snapshot();
+         VersionedSkipList<unsigned>::ConstIterator itr = snapshot.constIterator();
+         while (itr.valid()) {
+            for (unsigned i=0; i<batch and itr.valid(); ++i, ++itr)
+               sum += itr.cref();
+            if (list.marked() > marked)
+               marked = list.marked();
+            guard.unlock();
+            guard.lock();
+         }
+         snapshot.release();
+         ++scans;
+      }
+      stop = true;
+      writer.join();
+      report("VersionedSkipList", steps, longest, scans, timer.seconds(), sum);
+      cout << "    at most " << marked << " removed items kept for a snapshot\n";
+   }
+   return 0;
+}
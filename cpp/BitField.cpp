@@ -15,11 +15,9 @@ using namespace std;
 //==============================================================================
 
 //------------------------------------------------------------------------------
-// We assume 32 bit integers (2^5 == 32).
-// If this is not true then BitField may break
-// unless these are changed accordingly.
-const unsigned BitField::_shift = 5;
-const unsigned BitField::_mask = 31;
+// Bits are stored in 64 bit words (2^6 == 64).
+const unsigned BitField::_shift = 6;
+const unsigned BitField::_mask = 63;
 
 
 //==============================================================================
@@ -37,14 +35,17 @@ unsigned BitField::accomodate (unsigned bits) {
 
 //------------------------------------------------------------------------------
 void BitField::zero () {
-   memset(_data, 0, _words * sizeof(unsigned));
+   memset(_data, 0, _words * sizeof(uint64_t));
 }
 
 //------------------------------------------------------------------------------
 unsigned BitField::shrink () {
    unsigned words = usedWords();
    if (words < _words) {
-      _data = static_cast<unsigned*> ( realloc(_data, words * sizeof(unsigned)) );
+      uint64_t* data = new uint64_t[words];
+      memcpy(data, _data, words * sizeof(uint64_t));
+      delete[] _data;
+      _data = data;
       _words = words;
    }
    return words;
@@ -53,16 +54,20 @@ unsigned BitField::shrink () {
 //------------------------------------------------------------------------------
 BitField& BitField::operator= (BitField const& ex) {
    unsigned words = accomodate(ex.bits());
-   memcpy(_data, ex._data, words * sizeof(unsigned));
+   if (words)
+      memcpy(_data, ex._data, words * sizeof(uint64_t));
+   _bits = ex._bits;
    return *this;
 }
 
 //------------------------------------------------------------------------------
 BitField& BitField::operator= (BitField && ex) {
-   delete _data;
+   delete[] _data;
    _bits = ex._bits;
    _words = ex._words;
    _data = ex._data;
+   ex._bits = 0;
+   ex._words = 0;
    ex._data = nullptr;
    return *this;
 }
@@ -140,6 +145,44 @@ bool BitField::operator== (BitField const& bf) {
    return true;
 }
 
+//------------------------------------------------------------------------------
+// Returns the number of set bits in [begin, end).
+unsigned BitField::countRange (unsigned begin, unsigned end) const {
+   if (end > _bits)
+      end = _bits;
+   if (begin >= end)
+      return 0;
+   unsigned first = begin >> _shift;
+   unsigned last = (end - 1) >> _shift;
+   uint64_t head = ~uint64_t(0) << (begin & _mask);
+   uint64_t tail = ~uint64_t(0) >> (_mask - ((end - 1) & _mask));
+   if (first == last)
+      return countBits(_data[first] & head & tail);
+   unsigned count = countBits(_data[first] & head);
+   for (unsigned w=first+1; w<last; ++w)
+      count += countBits(_data[w]);
+   return count + countBits(_data[last] & tail);
+}
+
+//------------------------------------------------------------------------------
+// Returns the index of the set bit with rank k, or _bits if there are no more than k set bits.
+unsigned BitField::select (unsigned k) const {
+   unsigned words = usedWords();
+   for (unsigned w=0; w<words; ++w) {
+      uint64_t word = _data[w];
+      unsigned count = countBits(word);
+      if (k < count) {
+         // clear the k lowest set bits
+         for (; k; --k)
+            word &= word - 1;
+         unsigned i = (w << _shift) + __builtin_ctzll(word);
+         return i < _bits ? i : _bits;
+      }
+      k -= count;
+   }
+   return _bits;
+}
+
 //==============================================================================
 // Private Method Definitions
 //==============================================================================
@@ -150,58 +193,39 @@ void BitField::resize (unsigned bits, unsigned words) {
    _words = words;
    if (_data)
       delete[] _data;
-   _data = new unsigned[_words];
+   _data = new uint64_t[_words];
    _bits = bits;
 
-   // zero unused bits
+   // zero unused bits (the high bits of the last word)
    words = usedWords();
+   if (words == 0)
+      return;
    unsigned unusedBits = (words << _shift) - _bits;
-   unsigned mask = ~((1 << unusedBits) - 1);
-   _data[words-1] &= mask;
+   _data[words-1] &= ~uint64_t(0) >> unusedBits;
 }
 
 //------------------------------------------------------------------------------
 unsigned BitField::indexOfFirstSet () const {
-   // find the first word with set bits
-   unsigned i = 0;
-   unsigned words = usedWords();
-   while (i < words) {
-      if (_data[i] != 0)
-         break;
-      ++i;
-   }
-
-   // if there is no word with set bits, return _bits
-   if (i == words)
-      return _bits;
-
-   // index of first bit in the word we just found
-   i <<= _shift;
-   while (i<_bits and !get(i))
-      ++i;
-   return i;
+   return findSet(0);
 }
 
 //------------------------------------------------------------------------------
 unsigned BitField::indexOfLastSet () const {
-   // find the last word with set bits
-   unsigned i = usedWords() - 1;
-   while (i > 0) {
-      if (_data[i] != 0)
-         break;
-      --i;
-   }
-
-   // if there is no word with set bits, return _bits
-   if (i == 0 and _data[0] == 0)
+   // find the last word with set bits (ignoring any past _bits)
+   unsigned w = usedWords();
+   if (w == 0)
       return _bits;
+   --w;
+   uint64_t word = _data[w] & (~uint64_t(0) >> ((w << _shift) + _mask + 1 - _bits));
+   while (!word) {
+      // if there is no word with set bits, return _bits
+      if (w == 0)
+         return _bits;
+      word = _data[--w];
+   }
 
-   // index of last bit in the word we just found
-   i <<= _shift;
-   i += _mask;
-   while (i>0 and !get(i))
-      --i;
-   return i;
+   // index of the last bit in the word we just found
+   return (w << _shift) + _mask - __builtin_clzll(word);
 }
 
 
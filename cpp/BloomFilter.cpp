@@ -0,0 +1,77 @@
+//==============================================================================
+// BloomFilter.cpp
+// Created October 18 2026
+//==============================================================================
+
+#include "BloomFilter.h"
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+
+//==============================================================================
+// Set Constants
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Odd multipliers that pick a bit in each word of a block.
+// (These are the ones used by Impala's and Parquet's split block Bloom filters.)
+const unsigned BloomFilter::_salt[8] = {
+   0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+   0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+
+//==============================================================================
+// Public Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+BloomFilter::BloomFilter (unsigned expectedItems, float bitsPerItem)
+: _block(nullptr), _blocks(0), _items(0)
+{
+   resize(expectedItems, bitsPerItem);
+}
+
+//------------------------------------------------------------------------------
+void BloomFilter::resize (unsigned expectedItems, float bitsPerItem) {
+   double bits = double(expectedItems) * bitsPerItem;
+   _blocks = static_cast<unsigned>(ceil(bits / (_blockWords * 32)));
+   if (_blocks == 0)
+      _blocks = 1;
+
+   // Leave room to slide the first block forward to a cache line boundary.
+   const unsigned lineWords = _lineBytes / sizeof(unsigned);
+   _bits.resize((_blocks * _blockWords + lineWords - 1) * 32);
+   uintptr_t start = reinterpret_cast<uintptr_t>(_bits.data());
+   unsigned offset = ((_lineBytes - start % _lineBytes) % _lineBytes) / sizeof(unsigned);
+   _block = reinterpret_cast<unsigned*>(_bits.data()) + offset;
+   clear();
+}
+
+//------------------------------------------------------------------------------
+void BloomFilter::clear () {
+   _bits.zero();
+   _items = 0;
+}
+
+//------------------------------------------------------------------------------
+// The false positive rate expected with the specified number of bits per item.
+/**
+ * The number of items in a block is approximately Poisson distributed, with
+ * mean 256 / bitsPerItem. A block with n items has a false positive rate of
+ * (1 - (31/32)^n)^8, since one bit is tested in each of its eight words.
+ */
+double BloomFilter::expectedFalsePositiveRate (float bitsPerItem) {
+   double mean = 256.0 / bitsPerItem;
+   double probability = exp(-mean);  // probability of n items in a block (starting at n = 0)
+   double rate = 0.0;
+   double total = 0.0;
+   for (unsigned n=0; n < 10 * mean + 50; ++n) {
+      rate += probability * pow(1.0 - pow(31.0 / 32.0, n), 8);
+      total += probability;
+      probability *= mean / (n + 1);
+   }
+   return rate / total;
+}
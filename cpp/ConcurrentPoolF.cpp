@@ -0,0 +1,144 @@
+//==============================================================================
+// ConcurrentPoolF.cpp
+// Created October 18 2026
+//==============================================================================
+
+#include "ConcurrentPoolF.h"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+
+//==============================================================================
+// Public Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Constructor
+/**
+ * The alignment must be a power of two no larger than malloc's, and itemSize
+ * is rounded up to a multiple of it. firstChunk is rounded up to a power of
+ * two. No memory is allocated until the first alloc.
+ */
+ConcurrentPoolF::ConcurrentPoolF (unsigned itemSize, unsigned alignment, unsigned firstChunk)
+   : _top(0), _chunks(0)
+{
+   if (alignment == 0 or (alignment & (alignment - 1)))
+      throw("Error from ConcurrentPoolF constructor: alignment must be a power of two.\n");
+   if (itemSize == 0)
+      throw("Error from ConcurrentPoolF constructor: itemSize must be positive.\n");
+   _itemSize = (itemSize + alignment - 1) & ~(alignment - 1);
+   for (_shift = 0; (1u << _shift) < firstChunk and _shift < 20; ++_shift);
+   _firstChunk = 1u << _shift;
+   for (unsigned c=0; c<_maxChunks; ++c) {
+      _chunk[c].store(0, memory_order_relaxed);
+      _next[c].store(0, memory_order_relaxed);
+   }
+}
+
+//------------------------------------------------------------------------------
+// Destructor (no other thread may be using the pool)
+ConcurrentPoolF::~ConcurrentPoolF () {
+   for (unsigned c=0; c<_chunks; ++c) {
+      std::free(_chunk[c].load(memory_order_relaxed));
+      delete[] _next[c].load(memory_order_relaxed);
+   }
+}
+
+//------------------------------------------------------------------------------
+// Pops a piece off the stack of free ones, adding a chunk if the stack is empty.
+void* ConcurrentPoolF::alloc () {
+   uint64_t top = _top.load(memory_order_acquire);
+   while (true) {
+      unsigned first = static_cast<unsigned>(top);
+      if (!first) {
+         if (!grow())
+            return 0;
+         top = _top.load(memory_order_acquire);
+         continue;
+      }
+      // If another thread pops first before our CAS, the tag will have changed, so whatever we read here is discarded.
+      unsigned second = next(first - 1).load(memory_order_relaxed);
+      uint64_t popped = ((top >> 32) + 1) << 32 | second;
+      if (_top.compare_exchange_weak(top, popped, memory_order_acquire, memory_order_acquire)) {
+         unsigned offset;
+         unsigned c = chunkOf(first - 1, offset);
+         return _chunk[c].load(memory_order_relaxed) + static_cast<size_t>(offset) * _itemSize;
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Pushes item back onto the stack of free pieces.
+/**
+ * Finds the chunk item is in by checking the biggest (and so most likely)
+ * chunks first.
+ */
+void ConcurrentPoolF::free (void* item) {
+   char* ptr = static_cast<char*>(item);
+   for (unsigned c = _chunks.load(memory_order_acquire); c-- > 0; ) {
+      char* start = _chunk[c].load(memory_order_relaxed);
+      size_t bytes = static_cast<size_t>(_firstChunk << c) * _itemSize;
+      if (start <= ptr and ptr < start + bytes) {
+         unsigned index = ((_firstChunk << c) - _firstChunk) + (ptr - start) / _itemSize;
+         push(index + 1, index + 1);
+         return;
+      }
+   }
+}
+
+
+//==============================================================================
+// Private Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+std::atomic<unsigned>& ConcurrentPoolF::next (unsigned index) const {
+   unsigned offset;
+   unsigned c = chunkOf(index, offset);
+   return _next[c].load(memory_order_relaxed)[offset];
+}
+
+//------------------------------------------------------------------------------
+// Adds a chunk (unless another thread just did) and pushes all its pieces onto the stack.
+bool ConcurrentPoolF::grow () {
+   lock_guard<mutex> guard(_grow);
+   if (static_cast<unsigned>(_top.load(memory_order_acquire)))
+      return true;
+   unsigned c = _chunks.load(memory_order_relaxed);
+   if (c == _maxChunks or (static_cast<uint64_t>(_firstChunk) << (c + 1)) - _firstChunk >= 0xffffffffu)
+      return false;
+   unsigned pieces = _firstChunk << c;
+   char* memory = static_cast<char*>(malloc(static_cast<size_t>(pieces) * _itemSize));
+   atomic<unsigned>* links = new(nothrow) atomic<unsigned>[pieces];
+   if (!memory or !links) {
+      std::free(memory);
+      delete[] links;
+      return false;
+   }
+   unsigned base = _firstChunk * ((1u << c) - 1);
+   for (unsigned i=0; i+1<pieces; ++i)
+      links[i].store(base + i + 2, memory_order_relaxed);
+   _chunk[c].store(memory, memory_order_relaxed);
+   _next[c].store(links, memory_order_relaxed);
+   _chunks.store(c + 1, memory_order_release);
+   push(base + 1, base + pieces);
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Pushes a chain of pieces (indices + 1, linked from first to last) onto the stack.
+/**
+ * The release CAS publishes the chunk (and the chain's links) along with the
+ * pieces, to any thread that pops them with an acquire.
+ */
+void ConcurrentPoolF::push (unsigned first, unsigned last) {
+   uint64_t top = _top.load(memory_order_relaxed);
+   while (true) {
+      next(last - 1).store(static_cast<unsigned>(top), memory_order_relaxed);
+      uint64_t pushed = ((top >> 32) + 1) << 32 | first;
+      if (_top.compare_exchange_weak(top, pushed, memory_order_release, memory_order_relaxed))
+         return;
+   }
+}
@@ -0,0 +1,86 @@
+//==============================================================================
+// CountMinSketch.cpp
+// Created October 18 2026
+//==============================================================================
+
+#include "CountMinSketch.h"
+#include <cmath>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+
+//==============================================================================
+// Public Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+CountMinSketch::CountMinSketch (unsigned width, unsigned depth)
+: _count(nullptr), _width(4), _depth(depth), _total(0)
+{
+   if (depth == 0) {
+      throw("Error from CountMinSketch constructor: depth must be positive.\n");
+   }
+   // at least four counters per row, so merge can add them four at a time
+   while (_width < width)
+      _width <<= 1;
+   _mask = _width - 1;
+   _count = new unsigned[_width * _depth];
+   clear();
+}
+
+//------------------------------------------------------------------------------
+CountMinSketch::CountMinSketch (CountMinSketch const& cms)
+: _count(new unsigned[cms._width * cms._depth]), _width(cms._width), _mask(cms._mask),
+_depth(cms._depth), _total(cms._total)
+{
+   memcpy(_count, cms._count, bytes());
+}
+
+//------------------------------------------------------------------------------
+CountMinSketch& CountMinSketch::operator= (CountMinSketch const& cms) {
+   if (_width * _depth != cms._width * cms._depth) {
+      delete[] _count;
+      _count = new unsigned[cms._width * cms._depth];
+   }
+   _width = cms._width;
+   _mask = cms._mask;
+   _depth = cms._depth;
+   _total = cms._total;
+   memcpy(_count, cms._count, bytes());
+   return *this;
+}
+
+//------------------------------------------------------------------------------
+void CountMinSketch::merge (CountMinSketch const& cms) {
+   if (cms._width != _width or cms._depth != _depth) {
+      throw("Error from CountMinSketch::merge: dimensions must be the same.\n");
+   }
+   unsigned counters = _width * _depth;
+#ifdef __SSE2__
+   // there are always a multiple of 4 counters
+   for (unsigned i=0; i<counters; i+=4) {
+      __m128i* mine = reinterpret_cast<__m128i*>(_count + i);
+      __m128i theirs = _mm_loadu_si128(reinterpret_cast<__m128i const*>(cms._count + i));
+      _mm_storeu_si128(mine, _mm_add_epi32(_mm_loadu_si128(mine), theirs));
+   }
+#else
+   for (unsigned i=0; i<counters; ++i)
+      _count[i] += cms._count[i];
+#endif
+   _total += cms._total;
+}
+
+//------------------------------------------------------------------------------
+void CountMinSketch::clear () {
+   memset(_count, 0, bytes());
+   _total = 0;
+}
+
+//------------------------------------------------------------------------------
+double CountMinSketch::errorBound () const {
+   return exp(1.0) / _width * double(_total);
+}
@@ -0,0 +1,146 @@
+//==============================================================================
+// Epoch.cpp
+// Created October 18 2026
+//==============================================================================
+
+#include "Epoch.h"
+#include <thread>
+
+using namespace std;
+
+namespace {
+   /// The slot the thread holds, if any (only one Epoch is tracked per thread).
+   struct Held {
+      Epoch const* _epoch;
+      void* _slot;
+      unsigned _depth;
+   };
+   thread_local Held held = {0, 0, 0};
+}
+
+
+//==============================================================================
+// Public Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+Epoch::~Epoch () {
+   for (unsigned i=0; i<_slots; ++i) {
+      for (unsigned j=0; j<3; ++j)
+         reclaim(_slot[i]._limbo[j]);
+   }
+}
+
+//------------------------------------------------------------------------------
+unsigned Epoch::waiting () const {
+   unsigned count = 0;
+   for (unsigned i=0; i<_slots; ++i) {
+      for (unsigned j=0; j<3; ++j)
+         count += _slot[i]._limbo[j].size();
+   }
+   return count;
+}
+
+
+//==============================================================================
+// Private Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Claims a slot, and pins it to the current epoch.
+/**
+ * Each thread starts looking at a slot of its own (handed out in the order
+ * threads first pin), so unless there are more threads than slots the first
+ * slot tried is nearly always free.
+ */
+Epoch::Slot* Epoch::pin () {
+   if (held._depth and held._epoch == this) {
+      ++held._depth;
+      return static_cast<Slot*>(held._slot);
+   }
+
+   static atomic<unsigned> threads(0);
+   thread_local unsigned home = threads.fetch_add(1, memory_order_relaxed);
+
+   Slot* slot;
+   for (unsigned i = home; ; ++i) {
+      slot = &_slot[i % _slots];
+      if (!slot->_owned.load(memory_order_relaxed) and !slot->_owned.exchange(true, memory_order_acquire))
+         break;
+      if (i - home >= _slots)
+         this_thread::yield();
+   }
+
+   // Announce the epoch, then make sure it didn't advance before the announcement was seen.
+   unsigned epoch = _epoch.load(memory_order_seq_cst);
+   while (true) {
+      slot->_pinned.store((epoch << 1) | 1, memory_order_seq_cst);
+      unsigned now = _epoch.load(memory_order_seq_cst);
+      if (now == epoch)
+         break;
+      epoch = now;
+   }
+   reclaim(slot, epoch);
+
+   if (!held._depth) {
+      held._epoch = this;
+      held._slot = slot;
+      held._depth = 1;
+   }
+   return slot;
+}
+
+//------------------------------------------------------------------------------
+void Epoch::unpin (Slot* slot) {
+   if (held._depth and held._slot == slot and --held._depth)
+      return;
+   slot->_pinned.store(0, memory_order_release);
+   slot->_owned.store(false, memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void Epoch::retire (Slot* slot, void* ptr, Reclaimer reclaimer) {
+   unsigned epoch = _epoch.load(memory_order_acquire);
+   unsigned i = epoch % 3;
+   if (slot->_limboEpoch[i] != epoch) {
+      // This list was retired at least three epochs ago, so it is safe to free.
+      reclaim(slot->_limbo[i]);
+      slot->_limboEpoch[i] = epoch;
+   }
+   Retired retired = {ptr, reclaimer};
+   slot->_limbo[i].push_back(retired);
+   if (++slot->_retires >= _retiresPerAdvance) {
+      slot->_retires = 0;
+      if (tryAdvance())
+         reclaim(slot, epoch + 1);
+   }
+}
+
+//------------------------------------------------------------------------------
+// Advances the global epoch if every pinned slot has seen the current one.
+bool Epoch::tryAdvance () {
+   unsigned epoch = _epoch.load(memory_order_seq_cst);
+   unsigned current = (epoch << 1) | 1;
+   for (unsigned i=0; i<_slots; ++i) {
+      unsigned pinned = _slot[i]._pinned.load(memory_order_seq_cst);
+      if (pinned and pinned != current)
+         return false;
+   }
+   return _epoch.compare_exchange_strong(epoch, epoch + 1, memory_order_seq_cst);
+}
+
+//------------------------------------------------------------------------------
+// Frees the lists of slot that were retired at least two epochs before epoch.
+void Epoch::reclaim (Slot* slot, unsigned epoch) {
+   for (unsigned i=0; i<3; ++i) {
+      if (!slot->_limbo[i].empty() and slot->_limboEpoch[i] + 2 <= epoch)
+         reclaim(slot->_limbo[i]);
+   }
+}
+
+//------------------------------------------------------------------------------
+void Epoch::reclaim (vector<Retired>& limbo) {
+   for (Retired const& retired : limbo)
+      retired._reclaim(retired._ptr);
+   limbo.clear();
+}
@@ -0,0 +1,146 @@
+//==============================================================================
+// HyperLogLog.cpp
+// Created October 18 2026
+//==============================================================================
+
+#include "HyperLogLog.h"
+#include <cmath>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+
+//==============================================================================
+// Public Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+HyperLogLog::HyperLogLog (unsigned precision)
+: _register(nullptr), _precision(precision), _registers(1u << precision)
+{
+   if (precision < 4 or precision > 18) {
+      throw("Error from HyperLogLog constructor: precision must be between 4 and 18.\n");
+   }
+   _register = new unsigned char[_registers];
+   clear();
+}
+
+//------------------------------------------------------------------------------
+HyperLogLog::HyperLogLog (HyperLogLog const& hll)
+: _register(new unsigned char[hll._registers]), _precision(hll._precision), _registers(hll._registers)
+{
+   memcpy(_register, hll._register, _registers);
+}
+
+//------------------------------------------------------------------------------
+HyperLogLog& HyperLogLog::operator= (HyperLogLog const& hll) {
+   if (_registers != hll._registers) {
+      delete[] _register;
+      _register = new unsigned char[hll._registers];
+      _precision = hll._precision;
+      _registers = hll._registers;
+   }
+   memcpy(_register, hll._register, _registers);
+   return *this;
+}
+
+//------------------------------------------------------------------------------
+void HyperLogLog::merge (HyperLogLog const& hll) {
+   if (hll._precision != _precision) {
+      throw("Error from HyperLogLog::merge: precisions must be the same.\n");
+   }
+#ifdef __SSE2__
+   // there are always a multiple of 16 registers
+   for (unsigned i=0; i<_registers; i+=16) {
+      __m128i* mine = reinterpret_cast<__m128i*>(_register + i);
+      __m128i theirs = _mm_loadu_si128(reinterpret_cast<__m128i const*>(hll._register + i));
+      _mm_storeu_si128(mine, _mm_max_epu8(_mm_loadu_si128(mine), theirs));
+   }
+#else
+   for (unsigned i=0; i<_registers; ++i) {
+      if (hll._register[i] > _register[i])
+         _register[i] = hll._register[i];
+   }
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Returns the estimated number of distinct hashes added.
+/**
+ * This is the estimator from the original HyperLogLog paper (Flajolet et al
+ * 2007): the normalized harmonic mean of 2^register, switching to linear
+ * counting for small cardinalities (when some registers are still zero) and
+ * correcting for collisions of 32 bit hashes for large ones.
+ *
+ * 2^-register is computed exactly by building a float whose exponent is
+ * -register, so with SSE2 four registers are summed per instruction. Zero
+ * registers are counted with psadbw (each zero byte becomes a 1, and the
+ * bytes are added up in two 64 bit halves), rather than with popcount,
+ * which is a library call unless the target has POPCNT.
+ */
+double HyperLogLog::estimate () const {
+   double sum;
+   unsigned zeros = 0;
+#ifdef __SSE2__
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i bias = _mm_set1_epi32(127);
+   __m128i zeroCounts = _mm_setzero_si128();
+   sum = 0.0;
+   // Partial sums are kept in floats for at most 4096 registers at a time, so little precision is lost.
+   for (unsigned start=0; start<_registers; start+=4096) {
+      unsigned end = start + 4096 < _registers ? start + 4096 : _registers;
+      __m128 sums = _mm_setzero_ps();
+      for (unsigned i=start; i<end; i+=16) {
+         __m128i bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_register + i));
+         __m128i isZero = _mm_sub_epi8(zero, _mm_cmpeq_epi8(bytes, zero));
+         zeroCounts = _mm_add_epi64(zeroCounts, _mm_sad_epu8(isZero, zero));
+         // widen 16 bytes to four vectors of 32 bit ints, and turn each r into the float 2^-r
+         __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+         __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+         __m128i quarter[4] = {
+            _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+            _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)
+         };
+         for (unsigned j=0; j<4; ++j)
+            sums = _mm_add_ps(sums, _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(bias, quarter[j]), 23)));
+      }
+      float partial[4];
+      _mm_storeu_ps(partial, sums);
+      sum += double(partial[0]) + partial[1] + partial[2] + partial[3];
+   }
+   zeros = _mm_cvtsi128_si32(zeroCounts) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(zeroCounts, zeroCounts));
+#else
+   sum = 0.0;
+   for (unsigned i=0; i<_registers; ++i) {
+      sum += ldexp(1.0, -int(_register[i]));
+      if (_register[i] == 0)
+         ++zeros;
+   }
+#endif
+
+   double m = _registers;
+   double alpha = _registers == 16 ? 0.673 : _registers == 32 ? 0.697 : _registers == 64 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+   double estimate = alpha * m * m / sum;
+
+   const double two32 = 4294967296.0;
+   if (estimate <= 2.5 * m and zeros > 0) {
+      // linear counting
+      estimate = m * log(m / zeros);
+   } else if (estimate > two32 / 30.0) {
+      estimate = -two32 * log(1.0 - estimate / two32);
+   }
+   return estimate;
+}
+
+//------------------------------------------------------------------------------
+void HyperLogLog::clear () {
+   memset(_register, 0, _registers);
+}
+
+//------------------------------------------------------------------------------
+double HyperLogLog::relativeError () const {
+   return 1.04 / sqrt(double(_registers));
+}
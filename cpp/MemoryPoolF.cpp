@@ -60,14 +60,15 @@ unsigned MemoryPoolF::MemoryBlockRecord::partition (unsigned itemSize) {
 
 //------------------------------------------------------------------------------
 void* MemoryPoolF::MemoryBlockRecord::alloc (unsigned itemSize) {
-   unsigned memIndex = _firstFree;
-   _occupied.set(_firstFree);
-   if (--_freeItems > 0) {
-      BitField::Itr itr = BitField::Itr(_occupied, _firstFree);
-      itr.nextUnset();
-      _firstFree = itr.i();
-      // this might leave _firstFree invalid; this is intentional
-   }
+   // _firstFree is at or below the first free item (and there is one).
+   unsigned memIndex = _occupied.findUnset(_firstFree);
+   _occupied.set(memIndex);
+   --_freeItems;
+   // Everything up to memIndex is now occupied. The next free item isn't
+   // looked for until the next alloc, since a free may lower it first (when
+   // items are freed in the order they were allocated, it always does, and
+   // looking now would mean scanning past every live item each time).
+   _firstFree = memIndex + 1;
    return &_start[itemSize * memIndex];
 }
 
@@ -82,7 +83,8 @@ void MemoryPoolF::MemoryBlockRecord::free (unsigned index) {
 //------------------------------------------------------------------------------
 void MemoryPoolF::MemoryBlockRecord::clear () {
    _occupied.zero();
-   _freeItems = 0;
+   // every item in the block is free again (so the block can be reused)
+   _freeItems = _occupied.bits();
    _firstFree = 0;
 }
 
@@ -200,7 +202,9 @@ void MemoryPoolF::resizeBlockArray () {
    }
    auto newblock = static_cast<MemoryBlockRecord*> (malloc(newMaxBlocks*sizeof(MemoryBlockRecord)));
 
+   // newblock is raw memory, so each record must be constructed before it's assigned to.
    for (unsigned i=0; i<_blocks; ++i) {
+      new(&newblock[i+1]) MemoryBlockRecord;
       newblock[i+1] = std::move(_block[i]);
    }
    ++_blocks;
@@ -211,6 +215,8 @@ void MemoryPoolF::resizeBlockArray () {
 
 //------------------------------------------------------------------------------
 void MemoryPoolF::shiftBlockArray () {
+   // _block[_blocks] has never been constructed
+   new(&_block[_blocks]) MemoryBlockRecord;
    for (unsigned i=_blocks; i>0; --i) {
       _block[i] = std::move(_block[i-1]);
    }
@@ -234,8 +240,9 @@ void MemoryPoolF::clear () {
 //------------------------------------------------------------------------------
 // Returns all memory to the operating system.
 void MemoryPoolF::releaseAll () {
+   // The records are destroyed (not just released) so their BitFields are freed too.
    for (unsigned i=0; i<_blocks; ++i) {
-      _block[i].release();
+      _block[i].~MemoryBlockRecord();
    }
    _blocks = 0;
    _allocs = 0;
@@ -280,10 +287,10 @@ void MemoryPoolF::sortBlocks () {
          _block[i] = std::move(_block[i-1]);
          j = i - 2;
          while (j >= 0 and temp > _block[j]) {
+            _block[j+1] = std::move(_block[j]);
             --j;
          }
-         ++j;
-         _block[j] = std::move(temp);
+         _block[j+1] = std::move(temp);
       }
    }
 }
@@ -6,6 +6,7 @@
 #ifndef ESTDLIB_BITFIELD
 #define ESTDLIB_BITFIELD
 
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 
@@ -16,10 +17,16 @@
 
 //------------------------------------------------------------------------------
 /*
- * A BitField is a vector of unsigneds, each of whose individual bits
+ * A BitField is a vector of 64 bit words, each of whose individual bits
  * may be accessed as though they were separate boolean variables. 
  * Bits are numbered such that the first bit of each word is the least significant bit.
  *
+ * Searches for set or unset bits (findSet, findUnset, and the iterators'
+ * nextSet and nextUnset) skip whole words, and find the bit within a word
+ * with a count trailing zeros instruction. count, countRange, rank and select
+ * count a word at a time with popcount. (These are single instructions with
+ * -mpopcnt -mbmi, or -march=native, and short sequences otherwise.)
+ *
  * Bitwise operations are defined. In all cases the second BitField must be at
  * least as long as the third, or you will access invalid memory. (The second
  * being the rhs in &= etc, and the second argument for & etc.)
@@ -33,7 +40,7 @@ class BitField {
 private:
    unsigned _bits;      // number of bits stored in the BitField
    unsigned _words;     // lenth of _data
-   unsigned* _data;     // note _data may be longer than necessary
+   uint64_t* _data;     // note _data may be longer than necessary
    static const unsigned _shift;
    static const unsigned _mask;
 
@@ -49,10 +56,10 @@ public:
       // creates a CItr initialized to the specified bit
       CItr (BitField const& bitField, unsigned i = 0): _bitField(bitField), _i(i) {}
       CItr& operator++ () { ++_i; return *this; }
-      CItr& nextSet () { do { ++(*this); } while (valid() and !get()); return *this; }
-      CItr& nextUnset () { do { ++(*this); } while (valid() and get()); return *this; }
-      CItr& firstSet ();
-      CItr& lastSet ();
+      CItr& nextSet () { _i = _bitField.findSet(_i + 1); return *this; }
+      CItr& nextUnset () { _i = _bitField.findUnset(_i + 1); return *this; }
+      CItr& firstSet () { _i = _bitField.indexOfFirstSet(); return *this; }
+      CItr& lastSet () { _i = _bitField.indexOfLastSet(); return *this; }
       bool valid () const { return _i < _bitField.bits(); }
       unsigned get () const { return _bitField.get(_i); }
       unsigned i () const { return _i; }
@@ -64,6 +71,7 @@ public:
       Itr (BitField& bitField, unsigned i): CItr(bitField, i) {}
       Itr& operator++ () { CItr::operator++(); return *this; }
       Itr& nextSet () { CItr::nextSet(); return *this; }
+      Itr& nextUnset () { CItr::nextUnset(); return *this; }
       // read and write are not legal if iterator is past end - caller must check this
       void unset () { const_cast<BitField&>(_bitField).unset(_i); }
       void set   () { const_cast<BitField&>(_bitField).set(_i); }
@@ -100,14 +108,31 @@ public:
    //---------------------------------------------------------------------------
    // Basic Interaction
    unsigned get (unsigned i) const { return (_data[i >> _shift] >> (i & _mask)) & 0x1; }
-   void unset (unsigned i) { _data[i >> _shift] &= ~(0x1 << (i & _mask)); }
-   void set   (unsigned i) { _data[i >> _shift] |=  (0x1 << (i & _mask)); }
+   void unset (unsigned i) { _data[i >> _shift] &= ~(uint64_t(1) << (i & _mask)); }
+   void set   (unsigned i) { _data[i >> _shift] |=  (uint64_t(1) << (i & _mask)); }
    inline void set (unsigned i, unsigned value);
    void swap (unsigned i, unsigned j);
 
    unsigned bits () const { return _bits; }
    unsigned words () const { return _words; }
    unsigned usedWords () const { return wordsForBits(_bits); }
+   // Direct access to the words that store the bits (bit i is in word i >> 6).
+   uint64_t*       data ()       { return _data; }
+   uint64_t const* data () const { return _data; }
+
+   //---------------------------------------------------------------------------
+   // Searching and Counting
+   // Returns the index of the first set (or unset) bit at or after i, or bits() if there isn't one.
+   inline unsigned findSet (unsigned i) const;
+   inline unsigned findUnset (unsigned i) const;
+   // Returns the number of set bits.
+   unsigned count () const { return countRange(0, _bits); }
+   // Returns the number of set bits in [begin, end).
+   unsigned countRange (unsigned begin, unsigned end) const;
+   // Returns the number of set bits before bit i.
+   unsigned rank (unsigned i) const { return countRange(0, i); }
+   // Returns the index of the set bit with rank k (counting from 0), or bits() if there are no more than k.
+   unsigned select (unsigned k) const;
    
    void save (std::ofstream& file) const;
    void read (std::ifstream& file);
@@ -136,6 +161,7 @@ public:
    // Static Methods
    static unsigned charsForBits (unsigned bits) { return (bits + 7) >> 3; }
    static unsigned wordsForBits (unsigned bits) { return (bits + _mask) >> _shift; }
+   static inline unsigned countBits (uint64_t word);
 
 //------------------------------------------------------------------------------
 // Private Methods
@@ -163,10 +189,70 @@ BitField operator| (BitField const& bf1, BitField const& bf2);
 
 //------------------------------------------------------------------------------
 void BitField::set (unsigned i, unsigned value) {
-   unsigned word = i >> 5;
-   unsigned bit  = i & 31;
-   _data[word] &= ~(0x1 << bit);
-   _data[word] |= (value & 0x1) << bit;
+   unsigned word = i >> _shift;
+   unsigned bit  = i & _mask;
+   _data[word] &= ~(uint64_t(1) << bit);
+   _data[word] |= uint64_t(value & 0x1) << bit;
+}
+
+//------------------------------------------------------------------------------
+// Returns the index of the first set bit at or after i, or _bits if there isn't one.
+// (Returning early when bit i is set keeps dense scans from waiting on each
+// count trailing zeros, since that branch is predicted.)
+unsigned BitField::findSet (unsigned i) const {
+   if (i >= _bits)
+      return _bits;
+   uint64_t word = _data[i >> _shift] >> (i & _mask);
+   if (word & 1)
+      return i;
+   if (!word) {
+      unsigned w = i >> _shift;
+      unsigned words = usedWords();
+      do {
+         if (++w == words)
+            return _bits;
+         word = _data[w];
+      } while (!word);
+      i = w << _shift;
+   }
+   i += __builtin_ctzll(word);
+   return i < _bits ? i : _bits;
+}
+
+//------------------------------------------------------------------------------
+// Returns the index of the first unset bit at or after i, or _bits if there isn't one.
+unsigned BitField::findUnset (unsigned i) const {
+   if (i >= _bits)
+      return _bits;
+   uint64_t word = ~_data[i >> _shift] >> (i & _mask);
+   if (word & 1)
+      return i;
+   if (!word) {
+      unsigned w = i >> _shift;
+      unsigned words = usedWords();
+      do {
+         if (++w == words)
+            return _bits;
+         word = ~_data[w];
+      } while (!word);
+      i = w << _shift;
+   }
+   i += __builtin_ctzll(word);
+   return i < _bits ? i : _bits;
+}
+
+//------------------------------------------------------------------------------
+// Returns the number of set bits in word.
+unsigned BitField::countBits (uint64_t word) {
+#ifdef __POPCNT__
+   return __builtin_popcountll(word);
+#else
+   // Without the popcnt instruction __builtin_popcountll is a library call, so count in parallel.
+   word -= (word >> 1) & 0x5555555555555555ULL;
+   word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+   word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+   return (word * 0x0101010101010101ULL) >> 56;
+#endif
 }
 
 
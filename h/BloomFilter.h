@@ -0,0 +1,146 @@
+//==============================================================================
+// BloomFilter.h
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_BLOOM_FILTER
+#define ESTDLIB_BLOOM_FILTER
+
+#include "BitField.h"
+#include "HashFunctions.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+
+//==============================================================================
+// Class BloomFilter
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*
+ * A BloomFilter remembers a set of hashes approximately: mayContain is always
+ * true for hashes that have been added, and is false for most that haven't.
+ * Hashes can't be removed.
+ *
+ * This is a blocked (split block) Bloom filter. The bits are divided into
+ * blocks of 256 bits (eight 32 bit words), and each hash only touches one
+ * block: it sets (or tests) one bit in each of the block's eight words.
+ * Blocks are aligned to cache lines, so each add or mayContain touches
+ * exactly one cache line. The eight bit positions are computed from one
+ * mixed hash multiplied by eight odd constants, which is done with a handful
+ * of AVX2 instructions when they're available (compile with -mavx2 or
+ * -march=native), and with a short loop otherwise.
+ *
+ * The bits are stored in a BitField (its 64 bit words read as pairs of 32 bit
+ * words). A few extra words are allocated so that the first block can start
+ * on a cache line boundary.
+ *
+ * With 10 bits per item the false positive rate is about 1.2%; with 16 it is
+ * about 0.1% (see expectedFalsePositiveRate).
+ */
+
+//------------------------------------------------------------------------------
+class BloomFilter {
+//------------------------------------------------------------------------------
+// Members
+private:
+   BitField _bits;      // storage for all the blocks
+   unsigned* _block;    // start of the first (cache line aligned) block, in _bits
+   unsigned _blocks;    // number of 256 bit blocks
+   unsigned _items;     // number of times add has been called since the last clear
+   static const unsigned _salt[8];
+   static const unsigned _blockWords = 8;
+   static const unsigned _lineBytes = 64;
+
+//------------------------------------------------------------------------------
+// Public Methods
+public:
+   //---------------------------------------------------------------------------
+   // Ctors and Dtors
+   // Makes room for expectedItems items with bitsPerItem bits each (rounded up to whole blocks).
+   BloomFilter (unsigned expectedItems = 0, float bitsPerItem = 10);
+   BloomFilter (BloomFilter const&) = delete;
+   BloomFilter& operator= (BloomFilter const&) = delete;
+
+   //---------------------------------------------------------------------------
+   // Memory Management
+   // Makes room for expectedItems items with bitsPerItem bits each. This clears the filter.
+   void resize (unsigned expectedItems, float bitsPerItem = 10);
+   // Forgets all hashes.
+   void clear ();
+
+   //---------------------------------------------------------------------------
+   // Basic Interaction
+   inline void add (unsigned hash);
+   inline bool mayContain (unsigned hash) const;
+   // Convenience versions for any KEY with "unsigned hash() const".
+   template<class KEY> void addKey (KEY const& key) { add(key.hash()); }
+   template<class KEY> bool mayContainKey (KEY const& key) const { return mayContain(key.hash()); }
+
+   unsigned blocks () const { return _blocks; }
+   unsigned bits () const { return _blocks * _blockWords * 32; }
+   unsigned items () const { return _items; }
+   float bitsPerItem () const { return _items ? float(bits()) / float(_items) : 0.0f; }
+   // The false positive rate expected for the current number of items and bits.
+   double expectedFalsePositiveRate () const { return expectedFalsePositiveRate(float(bits()) / float(_items ? _items : 1)); }
+   // The false positive rate expected with the specified number of bits per item.
+   static double expectedFalsePositiveRate (float bitsPerItem);
+
+//------------------------------------------------------------------------------
+// Private Methods
+private:
+   // Returns the block that the (unmixed) hash maps to.
+   unsigned* block (unsigned hash) const {
+      unsigned long long mixed = hash1(hash);
+      return _block + _blockWords * unsigned((mixed * _blocks) >> 32);
+   }
+   // Returns the hash that determines which bits are set within a block.
+   static unsigned bitHash (unsigned hash) { return hash2(hash, 0x5eed); }
+};
+
+
+//==============================================================================
+// Inline Method Definitions
+//==============================================================================
+
+#ifdef __AVX2__
+//------------------------------------------------------------------------------
+// One bit in each 32 bit lane, chosen by the top five bits of the salted hash.
+inline __m256i bloomMask (unsigned bitHash, unsigned const* salt) {
+   __m256i products = _mm256_mullo_epi32(_mm256_set1_epi32(bitHash), _mm256_loadu_si256((__m256i const*) salt));
+   return _mm256_sllv_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(products, 27));
+}
+#endif
+
+//------------------------------------------------------------------------------
+void BloomFilter::add (unsigned hash) {
+   unsigned* words = block(hash);
+   unsigned key = bitHash(hash);
+#ifdef __AVX2__
+   __m256i* line = reinterpret_cast<__m256i*>(words);
+   _mm256_store_si256(line, _mm256_or_si256(_mm256_load_si256(line), bloomMask(key, _salt)));
+#else
+   for (unsigned i=0; i<_blockWords; ++i)
+      words[i] |= 1u << ((key * _salt[i]) >> 27);
+#endif
+   ++_items;
+}
+
+//------------------------------------------------------------------------------
+bool BloomFilter::mayContain (unsigned hash) const {
+   unsigned const* words = block(hash);
+   unsigned key = bitHash(hash);
+#ifdef __AVX2__
+   // testc is true if every bit of the mask is set in the block
+   return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<__m256i const*>(words)), bloomMask(key, _salt));
+#else
+   unsigned missing = 0;
+   for (unsigned i=0; i<_blockWords; ++i)
+      missing |= ~words[i] & (1u << ((key * _salt[i]) >> 27));
+   return !missing;
+#endif
+}
+
+
+#endif // ESTDLIB_BLOOM_FILTER
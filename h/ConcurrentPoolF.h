@@ -0,0 +1,89 @@
+//==============================================================================
+// ConcurrentPoolF.h
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_CONCURRENT_POOL_F
+#define ESTDLIB_CONCURRENT_POOL_F
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+
+//==============================================================================
+// Class ConcurrentPoolF
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*
+ * A memory pool that hands out fixed sized pieces, which any number of
+ * threads may alloc and free at once (compare to MemoryPoolF).
+ *
+ * Free pieces form a lock free stack (a Treiber stack). The links of the
+ * stack are indices kept in a side array per chunk, rather than in the free
+ * pieces themselves, so the pool never reads or writes memory it has handed
+ * out. The top of the stack is an index with a tag that every change bumps,
+ * so a pop that raced with pops and pushes of the same pieces fails its CAS
+ * (the ABA problem) instead of corrupting the stack.
+ *
+ * Memory comes in chunks, each twice as big as the one before, and is only
+ * returned to the operating system when the pool is destroyed. Adding a
+ * chunk takes a lock, but that only happens when the pool grows; alloc and
+ * free are lock free.
+ */
+
+//------------------------------------------------------------------------------
+class ConcurrentPoolF {
+//------------------------------------------------------------------------------
+// Members
+private:
+   static const unsigned _maxChunks = 32;
+   unsigned _itemSize;       ///< size of the pieces (a multiple of the alignment)
+   unsigned _firstChunk;     ///< pieces in chunk 0 (a power of two); chunk c has _firstChunk << c
+   unsigned _shift;          ///< log2 of _firstChunk
+   char _pad0[64];              ///< keeps _top's cache line to itself
+   std::atomic<uint64_t> _top;  ///< (tag << 32) | (index of the first free piece + 1), or tag << 32 if none
+   char _pad1[64];
+   std::atomic<char*> _chunk[_maxChunks];                    ///< memory of each chunk
+   std::atomic<std::atomic<unsigned>*> _next[_maxChunks];    ///< for each free piece, the index (+ 1) of the next
+   std::atomic<unsigned> _chunks;  ///< number of chunks
+   std::mutex _grow;               ///< held while adding a chunk
+
+//------------------------------------------------------------------------------
+// Public Methods
+public:
+   /// The first chunk holds at least firstChunk pieces.
+   ConcurrentPoolF (unsigned itemSize, unsigned alignment = 8, unsigned firstChunk = 1024);
+   ConcurrentPoolF (ConcurrentPoolF const&) = delete;
+   ConcurrentPoolF& operator= (ConcurrentPoolF const&) = delete;
+   ~ConcurrentPoolF ();
+
+   /// Returns itemSize bytes of memory (or a null pointer if malloc fails).
+   void* alloc ();
+   /// Returns memory from alloc to the pool.
+   void free (void* item);
+
+   unsigned itemSize () const { return _itemSize; }
+   unsigned chunks () const { return _chunks.load(std::memory_order_relaxed); }
+   /// Returns the number of pieces that can be handed out without growing.
+   unsigned capacity () const { return ((_firstChunk << chunks()) - _firstChunk); }
+
+//------------------------------------------------------------------------------
+// Private Methods
+private:
+   /// Returns the chunk holding the piece with the given index, and sets offset to its place in the chunk.
+   unsigned chunkOf (unsigned index, unsigned& offset) const {
+      unsigned c = 31 - __builtin_clz((index >> _shift) + 1);
+      offset = index - ((_firstChunk << c) - _firstChunk);
+      return c;
+   }
+   std::atomic<unsigned>& next (unsigned index) const;
+   /// Adds a chunk and pushes its pieces onto the stack. Returns false if malloc fails.
+   bool grow ();
+   /// Pushes the chain of pieces first..last (indices + 1, already linked) onto the stack.
+   void push (unsigned first, unsigned last);
+};
+
+
+#endif // ESTDLIB_CONCURRENT_POOL_F
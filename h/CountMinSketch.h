@@ -0,0 +1,116 @@
+//==============================================================================
+// CountMinSketch.h
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_COUNT_MIN_SKETCH
+#define ESTDLIB_COUNT_MIN_SKETCH
+
+#include "HashFunctions.h"
+
+
+//==============================================================================
+// Class CountMinSketch
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*
+ * A CountMinSketch estimates how many times each hash has been added, using
+ * a fixed amount of memory (depth rows of width 32 bit counters). Each add
+ * increments one counter in every row, and estimate returns the smallest of
+ * a hash's counters. Estimates are never too low. With probability at least
+ * 1 - e^-depth they are too high by at most e / width times the total of all
+ * counts (see errorBound).
+ *
+ * The counter used in row i is (h1 + i * h2) mod width, where h1 and h2 are
+ * two mixes of the hash (see HashFunctions.h). width is rounded up to a power
+ * of two.
+ *
+ * Two CountMinSketches with the same dimensions can be merged (eg one per
+ * thread) by adding their counters, which uses SSE2 when it's available.
+ * Counters wrap around if they pass 2^32 - 1.
+ */
+
+//------------------------------------------------------------------------------
+class CountMinSketch {
+//------------------------------------------------------------------------------
+// Members
+private:
+   unsigned* _count;    // depth rows of width counters
+   unsigned _width;
+   unsigned _mask;      // _width - 1
+   unsigned _depth;
+   unsigned long long _total;   // sum of all counts added
+
+//------------------------------------------------------------------------------
+// Public Methods
+public:
+   //---------------------------------------------------------------------------
+   // Ctors and Dtors
+   CountMinSketch (unsigned width = 2048, unsigned depth = 4);
+   CountMinSketch (CountMinSketch const& cms);
+   CountMinSketch& operator= (CountMinSketch const& cms);
+   ~CountMinSketch () { delete[] _count; }
+
+   //---------------------------------------------------------------------------
+   // Basic Interaction
+   inline void add (unsigned hash, unsigned count = 1);
+   // Returns an estimate of the total count added for hash (never less than the true total).
+   inline unsigned estimate (unsigned hash) const;
+   // Convenience versions for any KEY with "unsigned hash() const".
+   template<class KEY> void addKey (KEY const& key, unsigned count = 1) { add(key.hash(), count); }
+   template<class KEY> unsigned estimateKey (KEY const& key) const { return estimate(key.hash()); }
+   // Adds all of the counts that were added to cms (which must have the same width and depth).
+   void merge (CountMinSketch const& cms);
+   // Forgets all counts.
+   void clear ();
+
+   unsigned width () const { return _width; }
+   unsigned depth () const { return _depth; }
+   unsigned bytes () const { return _width * _depth * sizeof(unsigned); }
+   unsigned long long total () const { return _total; }
+   // Estimates exceed true counts by at most this much, with probability at least 1 - e^-depth.
+   double errorBound () const;
+
+//------------------------------------------------------------------------------
+// Private Methods
+private:
+   static unsigned h1 (unsigned hash) { return hash1(hash); }
+   static unsigned h2 (unsigned hash) { return hash2(hash, 0xc0c0a) | 1; }
+};
+
+
+//==============================================================================
+// Inline Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+void CountMinSketch::add (unsigned hash, unsigned count) {
+   unsigned index = h1(hash);
+   unsigned step = h2(hash);
+   unsigned* row = _count;
+   for (unsigned i=0; i<_depth; ++i) {
+      row[index & _mask] += count;
+      index += step;
+      row += _width;
+   }
+   _total += count;
+}
+
+//------------------------------------------------------------------------------
+unsigned CountMinSketch::estimate (unsigned hash) const {
+   unsigned index = h1(hash);
+   unsigned step = h2(hash);
+   unsigned const* row = _count;
+   unsigned smallest = ~0u;
+   for (unsigned i=0; i<_depth; ++i) {
+      if (row[index & _mask] < smallest)
+         smallest = row[index & _mask];
+      index += step;
+      row += _width;
+   }
+   return smallest;
+}
+
+
+#endif // ESTDLIB_COUNT_MIN_SKETCH
@@ -0,0 +1,119 @@
+//==============================================================================
+// Epoch.h
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_EPOCH
+#define ESTDLIB_EPOCH
+
+#include <atomic>
+#include <vector>
+
+
+//==============================================================================
+// Class Epoch
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*
+ * Epoch based memory reclamation, for lock free containers.
+ *
+ * A thread that reads a container holds a Guard, which pins it to the current
+ * global epoch. Memory that has been unlinked from the container is handed to
+ * Guard::retire instead of being freed, since other threads may still be
+ * reading it. The global epoch only advances when every pinned thread has
+ * seen the current one, so memory retired in epoch e can't be reachable by
+ * anyone once the global epoch reaches e + 2, and is freed then.
+ *
+ * Each Guard claims one of a fixed number of slots (threads get a slot they
+ * tend to keep, so claiming one is usually a single uncontended CAS). A slot
+ * keeps the memory retired while it was held, in three lists (one per
+ * epoch mod 3), so retiring never locks or allocates (beyond growing a list).
+ * Memory that is still waiting when the Epoch is destroyed is freed then.
+ *
+ * Guards nest: a Guard made while the thread already holds one (on the same
+ * Epoch) just shares its slot. So container operations pin internally, and a
+ * reader that runs many operations (or walks a range) holds one Guard around
+ * all of them. A thread must not hold a Guard forever, though, since that
+ * stops memory from being reclaimed.
+ */
+
+//------------------------------------------------------------------------------
+class Epoch {
+//------------------------------------------------------------------------------
+// SubClasses
+public:
+   /// Frees memory that was retired.
+   typedef void (*Reclaimer) (void* ptr);
+private:
+   struct Retired {
+      void* _ptr;
+      Reclaimer _reclaim;
+   };
+
+   /// Per thread state (padded so that the _pinned words of different slots don't share cache lines).
+   struct Slot {
+      std::atomic<unsigned> _pinned;   ///< (epoch << 1) | 1 while a Guard holds the slot, otherwise 0
+      std::atomic<bool> _owned;        ///< true while a Guard holds the slot
+      unsigned _limboEpoch[3];         ///< the epoch the memory in each list was retired in
+      std::vector<Retired> _limbo[3];  ///< retired memory, by epoch mod 3
+      unsigned _retires;               ///< retires since this slot last tried to advance the epoch
+      char _pad[64];
+      Slot (): _pinned(0), _owned(false), _retires(0) { _limboEpoch[0] = _limboEpoch[1] = _limboEpoch[2] = 0; }
+   };
+
+public:
+   /// Pins the calling thread while it exists.
+   class Guard {
+   private:
+      Epoch* _epoch;
+      Slot* _slot;
+   public:
+      Guard (Epoch& epoch): _epoch(&epoch), _slot(epoch.pin()) {}
+      Guard (Guard&& guard): _epoch(guard._epoch), _slot(guard._slot) { guard._slot = 0; }
+      Guard (Guard const&) = delete;
+      Guard& operator= (Guard const&) = delete;
+      ~Guard () { if (_slot) _epoch->unpin(_slot); }
+      /// Frees ptr (with reclaim) once no thread can be reading it.
+      void retire (void* ptr, Reclaimer reclaim) { _epoch->retire(_slot, ptr, reclaim); }
+   };
+   friend class Guard;
+
+//------------------------------------------------------------------------------
+// Members
+private:
+   static const unsigned _slots = 128;
+   static const unsigned _retiresPerAdvance = 64;
+   std::atomic<unsigned> _epoch;  ///< the global epoch
+   Slot _slot[_slots];
+
+//------------------------------------------------------------------------------
+// Public Methods
+public:
+   Epoch (): _epoch(1) {}
+   Epoch (Epoch const&) = delete;
+   Epoch& operator= (Epoch const&) = delete;
+   /// Frees everything that was retired (no Guards may exist).
+   ~Epoch ();
+
+   /// Returns a Guard that pins the calling thread.
+   Guard guard () { return Guard(*this); }
+   unsigned epoch () const { return _epoch.load(std::memory_order_relaxed); }
+   /// Returns the number of retired pieces of memory that haven't been freed yet (no Guards may exist).
+   unsigned waiting () const;
+
+//------------------------------------------------------------------------------
+// Private Methods
+private:
+   Slot* pin ();
+   void unpin (Slot* slot);
+   void retire (Slot* slot, void* ptr, Reclaimer reclaim);
+   /// Advances the global epoch if every pinned slot has seen the current one.
+   bool tryAdvance ();
+   /// Frees the lists of slot that were retired at least two epochs before epoch.
+   static void reclaim (Slot* slot, unsigned epoch);
+   static void reclaim (std::vector<Retired>& limbo);
+};
+
+
+#endif // ESTDLIB_EPOCH
@@ -0,0 +1,92 @@
+//==============================================================================
+// HyperLogLog.h
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_HYPER_LOG_LOG
+#define ESTDLIB_HYPER_LOG_LOG
+
+#include "HashFunctions.h"
+
+
+//==============================================================================
+// Class HyperLogLog
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*
+ * A HyperLogLog estimates the number of distinct hashes added to it, using a
+ * fixed amount of memory (2^precision bytes) no matter how many there are.
+ * The standard error of the estimate is about 1.04 / sqrt(2^precision), so
+ * with the default precision of 14 it uses 16 KB and is within about 0.8%.
+ *
+ * Each hash is mixed with hash1 (which is a bijection, so distinct hashes
+ * stay distinct). The top precision bits of the mixed hash choose a
+ * register, and the register keeps the largest number of leading zeros (+ 1)
+ * seen in the remaining bits. Registers are stored one per byte.
+ *
+ * Two HyperLogLogs with the same precision can be merged (eg one per thread):
+ * the result is the same as if all of the hashes had been added to one.
+ * Merging and estimating use SSE2 when it's available.
+ *
+ * Since hashes are 32 bits, estimates over a few hundred million are
+ * corrected for hash collisions, and become less accurate.
+ */
+
+//------------------------------------------------------------------------------
+class HyperLogLog {
+//------------------------------------------------------------------------------
+// Members
+private:
+   unsigned char* _register;
+   unsigned _precision;    // log2 of the number of registers
+   unsigned _registers;
+
+//------------------------------------------------------------------------------
+// Public Methods
+public:
+   //---------------------------------------------------------------------------
+   // Ctors and Dtors
+   // precision must be between 4 and 18.
+   HyperLogLog (unsigned precision = 14);
+   HyperLogLog (HyperLogLog const& hll);
+   HyperLogLog& operator= (HyperLogLog const& hll);
+   ~HyperLogLog () { delete[] _register; }
+
+   //---------------------------------------------------------------------------
+   // Basic Interaction
+   inline void add (unsigned hash);
+   // Convenience version for any KEY with "unsigned hash() const".
+   template<class KEY> void addKey (KEY const& key) { add(key.hash()); }
+   // Adds all of the hashes that were added to hll (which must have the same precision).
+   void merge (HyperLogLog const& hll);
+   // Returns the estimated number of distinct hashes added.
+   double estimate () const;
+   // Forgets all hashes.
+   void clear ();
+
+   unsigned precision () const { return _precision; }
+   unsigned registers () const { return _registers; }
+   unsigned bytes () const { return _registers; }
+   // The standard error of estimate, relative to the true count.
+   double relativeError () const;
+};
+
+
+//==============================================================================
+// Inline Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+void HyperLogLog::add (unsigned hash) {
+   unsigned mixed = hash1(hash);
+   unsigned index = mixed >> (32 - _precision);
+   // The low bit ensures the rank is at most 33 - _precision (when the remaining bits are all zero).
+   unsigned rest = (mixed << _precision) | (1u << (_precision - 1));
+   unsigned char rank = __builtin_clz(rest) + 1;
+   if (rank > _register[index])
+      _register[index] = rank;
+}
+
+
+#endif // ESTDLIB_HYPER_LOG_LOG
@@ -91,6 +91,8 @@ public:
    unsigned remainingBytesOfActiveBlock () const;
    /// Returns the size that the MemoryPool plans to make the next block it allocates.
    unsigned sizeOfNextAllocatedBlock () const;
+   /// Makes the next block the MemoryPool allocates able to hold size bytes.
+   void setSizeOfNextAllocatedBlock (unsigned size);
    /// Returns the minimum size a donated block can be before being thrown away.
    unsigned minimumDonationSize () const;
    
@@ -224,6 +226,17 @@ inline unsigned MemoryPool::sizeOfNextAllocatedBlock () const
    return _newBlockSize;
 }
 
+//------------------------------------------------------------------------------
+// Makes the next block the MemoryPool allocates able to hold size bytes.
+/**
+ * Like the initialSize given to the constructor, this doesn't include the
+ * MemoryBlock at the beginning of the block. Later blocks grow from this size.
+ */
+inline void MemoryPool::setSizeOfNextAllocatedBlock (unsigned size)
+{
+   _newBlockSize = sizeof(MemoryBlock) + size;
+}
+
 //------------------------------------------------------------------------------
 // Returns the minimum size that a donated block can be before being thrown away.
 inline unsigned MemoryPool::minimumDonationSize () const
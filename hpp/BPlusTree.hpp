@@ -0,0 +1,692 @@
+//==============================================================================
+// BPlusTree.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_BPLUS_TREE
+#define ESTDLIB_BPLUS_TREE
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <utility>
+#include "Wrap.hpp"
+#include "NodeSearch.hpp"
+
+
+//==============================================================================
+// An ordered container with the SkipList interface, stored in a B+-tree.
+//==============================================================================
+/**
+ * BPlusTree has the same add, remove, find, findLow and findHigh methods and
+ * Iterators as SkipList, and like it keeps items in order (using ITEM < ITEM,
+ * and ITEM < KEY and ITEM == KEY for searches) and may hold several equal
+ * items. A search reads one node per level instead of chasing a pointer per
+ * lane step, so large trees are much kinder to the cache.
+ *
+ * Nodes span LINES cache lines (or more, if four items wouldn't fit), and
+ * are allocated on cache line boundaries with posix_memalign. Leaves hold
+ * the items in order and are linked in both directions, so Iterators just
+ * walk along them. Inner nodes hold count keys followed by count+1
+ * children, where key i is a copy of the first item under child i+1. These
+ * are kept up to date as items are removed, so they are always copies of
+ * items in the tree (which matters when ITEM is a pointer). Nodes are kept
+ * at least half full by borrowing from or merging with a neighbour.
+ *
+ * The search within a node is done by NodeSearch, with SIMD for integer
+ * items.
+ *
+ * Unlike SkipList's, Iterators point at a place in a leaf, and so are
+ * invalidated by any add or remove.
+ */
+
+template<typename ITEM, unsigned LINES = 4>
+class BPlusTree {
+//------------------------------------------------------------------------------
+// SubClasses
+private:
+   typedef Wrap<ITEM> W;
+
+   /// Leaves are followed in memory by an array of leafItems ITEMs, count of which are in use.
+   struct Leaf {
+      Leaf* next;
+      Leaf* prev;
+      unsigned count;
+   };
+   /// Inner nodes are followed by an array of innerKeys keys and then one of innerKeys+1 children.
+   /** The children are Leaves in the lowest inner level, and Inners above that. */
+   struct Inner {
+      unsigned count;  ///< number of keys (there is one more child)
+   };
+
+   static const unsigned lineBytes = 64;
+   static const unsigned itemsOffset = (sizeof(Leaf) + alignof(W) - 1) / alignof(W) * alignof(W);
+   static const unsigned leafBytes = itemsOffset + 4*sizeof(W) <= LINES*lineBytes ? LINES*lineBytes
+                                   : (itemsOffset + 4*sizeof(W) + lineBytes - 1) / lineBytes * lineBytes;
+   static const unsigned keysOffset = (sizeof(Inner) + alignof(W) - 1) / alignof(W) * alignof(W);
+   static const unsigned innerMin = keysOffset + 4*sizeof(W) + sizeof(void*) - 1 + 5*sizeof(void*);
+   static const unsigned innerBytes = innerMin <= LINES*lineBytes ? LINES*lineBytes
+                                    : (innerMin + lineBytes - 1) / lineBytes * lineBytes;
+   static const unsigned maxHeight = 32;
+
+public:
+   /// The most ITEMs a leaf holds.
+   static const unsigned leafItems = (leafBytes - itemsOffset) / sizeof(W);
+   /// The most keys an inner node holds.
+   static const unsigned innerKeys = (innerBytes - keysOffset - sizeof(void*) - (sizeof(void*) - 1)) / (sizeof(W) + sizeof(void*));
+
+private:
+   static const unsigned childrenOffset = (keysOffset + innerKeys*sizeof(W) + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+   static const unsigned minLeafItems = leafItems / 2;
+   static const unsigned minInnerKeys = (innerKeys - 1) / 2;
+
+   static W* items (Leaf* leaf) { return reinterpret_cast<W*>(reinterpret_cast<char*>(leaf) + itemsOffset); }
+   static W const* items (Leaf const* leaf) { return reinterpret_cast<W const*>(reinterpret_cast<char const*>(leaf) + itemsOffset); }
+   static W* keys (Inner* node) { return reinterpret_cast<W*>(reinterpret_cast<char*>(node) + keysOffset); }
+   static W const* keys (Inner const* node) { return reinterpret_cast<W const*>(reinterpret_cast<char const*>(node) + keysOffset); }
+   static void** children (Inner* node) { return reinterpret_cast<void**>(reinterpret_cast<char*>(node) + childrenOffset); }
+   static void* const* children (Inner const* node) { return reinterpret_cast<void* const*>(reinterpret_cast<char const*>(node) + childrenOffset); }
+
+   /// The inner nodes passed through on the way to a leaf, and which child was taken from each.
+   struct Step {
+      Inner* node;
+      unsigned child;
+   };
+
+public:
+   /// Cautiously iterates over the BPlusTree.
+   class ConstIterator {
+   friend class BPlusTree;
+   protected:
+      Leaf const* _leaf;
+      unsigned _index;
+   public:
+      ConstIterator (): _leaf(0), _index(0) {}
+      ConstIterator (Leaf const* leaf, unsigned index): _leaf(leaf), _index(index) {}
+      bool valid () const { return _leaf; }
+      typename W::CRef cref () const { return items(_leaf)[_index].cref(); }
+      typename W::CPtr cptr () const { return items(_leaf)[_index].cptr(); }
+      typename W::Ex   ex   () const { return items(_leaf)[_index].ex(); }
+      // All the following methods will crash if called on an invalid Iterator.
+      ConstIterator& operator++ () {
+         if (++_index == _leaf->count) {
+            _leaf = _leaf->next;
+            _index = 0;
+         }
+         return *this;
+      }
+      bool operator<  (ConstIterator itr) const { return this->cref() <  itr.cref(); }
+      bool operator<= (ConstIterator itr) const { return this->cref() <= itr.cref(); }
+      bool operator>  (ConstIterator itr) const { return this->cref() >  itr.cref(); }
+      bool operator>= (ConstIterator itr) const { return this->cref() >= itr.cref(); }
+   };
+
+   /// Iterates over the BPlusTree. (Items must not be changed in ways that change their order.)
+   class Iterator : public ConstIterator {
+   friend class BPlusTree;
+   private:
+      explicit Iterator (ConstIterator itr): ConstIterator(itr) {}
+   public:
+      Iterator (): ConstIterator() {}
+      Iterator (Leaf* leaf, unsigned index): ConstIterator(leaf, index) {}
+      typename W::Ref ref () const { return items(const_cast<Leaf*>(this->_leaf))[this->_index].ref(); }
+      typename W::Ptr ptr () const { return items(const_cast<Leaf*>(this->_leaf))[this->_index].ptr(); }
+      Iterator& operator++ () { ConstIterator::operator++(); return *this; }
+      bool operator<  (Iterator itr) const { return this->cref() <  itr.cref(); }
+      bool operator<= (Iterator itr) const { return this->cref() <= itr.cref(); }
+      bool operator>  (Iterator itr) const { return this->cref() >  itr.cref(); }
+      bool operator>= (Iterator itr) const { return this->cref() >= itr.cref(); }
+   };
+
+// Member data
+private:
+   void* _root;         ///< a Leaf if _height is 0, otherwise an Inner
+   unsigned _height;    ///< number of inner levels above the leaves
+   Leaf* _first;        ///< the leftmost leaf
+   unsigned _size;      ///< number of items
+   unsigned _leaves;    ///< number of leaves
+   unsigned _inners;    ///< number of inner nodes
+
+// Interface
+public:
+   BPlusTree ();
+   ~BPlusTree ();
+   BPlusTree (BPlusTree const&) = delete;
+   BPlusTree& operator= (BPlusTree const&) = delete;
+
+   /// Adds a new ITEM to the BPlusTree (before any equal ones).
+   Iterator add (typename W::Ex item);
+   /// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+   template<typename KEY> bool remove (KEY const& key);
+
+   /// Attempts to find an ITEM in the BPlusTree with the specified KEY.
+   template<typename KEY> Iterator find (KEY const& key) { return Iterator(constThis().find(key)); }
+   /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY.
+   template<typename KEY> Iterator findLow (KEY const& key) { return Iterator(constThis().findLow(key)); }
+   /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY.
+   template<typename KEY> Iterator findHigh (KEY const& key) { return Iterator(constThis().findHigh(key)); }
+
+   /// Attempts to find an ITEM in the BPlusTree with the specified KEY.
+   template<typename KEY> ConstIterator find (KEY const& key) const;
+   /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY.
+   template<typename KEY> ConstIterator findLow (KEY const& key) const;
+   /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY.
+   template<typename KEY> ConstIterator findHigh (KEY const& key) const;
+
+   /// Returns an Iterator to the first ITEM in the BPlusTree.
+   Iterator iterator () { return Iterator(_first->count ? _first : 0, 0); }
+   /// Returns a ConstIterator to the first ITEM in the BPlusTree.
+   ConstIterator constIterator () const { return ConstIterator(_first->count ? _first : 0, 0); }
+
+   /// Returns the number of items in the BPlusTree.
+   unsigned size () const { return _size; }
+   /// Returns the number of inner levels above the leaves.
+   unsigned height () const { return _height; }
+   /// Returns the memory taken by the nodes.
+   unsigned long bytes () const { return (unsigned long)_leaves * leafBytes + (unsigned long)_inners * innerBytes; }
+
+// Private Methods
+private:
+   BPlusTree const& constThis () const { return *this; }
+   static void* allocNode (unsigned bytes);
+   Leaf* newLeaf ();
+   Inner* newInner ();
+   void freeLeaf (Leaf* leaf);
+   void freeInner (Inner* node);
+   void destroy (void* node, unsigned height);
+   /// Returns the leaf key belongs in (to the left of any equal items), filling path if it isn't null.
+   template<typename KEY> Leaf* descend (KEY const& key, Step* path) const;
+   /// Moves path on to the leaf after leaf. Returns it, or null if leaf was the last.
+   Leaf* nextLeaf (Step* path) const;
+   /// Adds key and the child to its right to the inner node at the end of path, splitting up the tree as needed.
+   void insertChild (Step* path, W const& key, void* child);
+   /// Adds key at i in node (which has room), and child after it.
+   static void insertKey (Inner* node, unsigned i, W const& key, void* child);
+   /// Updates the key for the leaf at the end of path, after its first item has changed.
+   void updateKey (Step* path, W const& first);
+   void rebalanceLeaf (Step* path, Leaf* leaf);
+   void rebalanceInner (Step* path, unsigned level);
+
+   /// Moves count items from from to to, which may overlap if to is lower.
+   static void moveDown (W* to, W* from, unsigned count);
+   /// Moves count items from from to to, which may overlap if to is higher.
+   static void moveUp (W* to, W* from, unsigned count);
+
+// Debug Methods
+public:
+   void printStats () const;
+};
+
+
+//==============================================================================
+// Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Constructor
+template<typename ITEM, unsigned LINES>
+BPlusTree<ITEM, LINES>::BPlusTree ()
+   : _height(0), _size(0), _leaves(0), _inners(0)
+{
+   _first = newLeaf();
+   _first->next = 0;
+   _first->prev = 0;
+   _root = _first;
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+template<typename ITEM, unsigned LINES>
+BPlusTree<ITEM, LINES>::~BPlusTree ()
+{
+   destroy(_root, _height);
+}
+
+//------------------------------------------------------------------------------
+// Adds an ITEM to the BPlusTree.
+template<typename ITEM, unsigned LINES>
+typename BPlusTree<ITEM, LINES>::Iterator BPlusTree<ITEM, LINES>::add (typename W::Ex item)
+{
+   Step path[maxHeight];
+   Leaf* leaf = descend(item, path);
+   unsigned i = NodeSearch::countLess(items(leaf), leaf->count, ::cref(item));
+
+   // A full leaf gives its top half to a new leaf after it.
+   if (leaf->count == leafItems) {
+      Leaf* right = newLeaf();
+      unsigned half = (leafItems + 1) / 2;
+      moveDown(items(right), items(leaf) + half, leafItems - half);
+      right->count = leafItems - half;
+      leaf->count = half;
+      right->next = leaf->next;
+      right->prev = leaf;
+      if (leaf->next)
+         leaf->next->prev = right;
+      leaf->next = right;
+      insertChild(path, items(right)[0], right);
+      if (i > half) {
+         leaf = right;
+         i -= half;
+      }
+   }
+
+   // (i is never 0 unless leaf is the first, so no key changes.)
+   moveUp(items(leaf) + i + 1, items(leaf) + i, leaf->count - i);
+   new(&items(leaf)[i]) W(item);
+   ++leaf->count;
+   ++_size;
+   return Iterator(leaf, i);
+}
+
+//------------------------------------------------------------------------------
+// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+template<typename ITEM, unsigned LINES>
+template<typename KEY>
+bool BPlusTree<ITEM, LINES>::remove (KEY const& key)
+{
+   Step path[maxHeight];
+   Leaf* leaf = descend(key, path);
+   unsigned i = NodeSearch::countLess(items(leaf), leaf->count, ::cref(key));
+   if (i == leaf->count) {
+      leaf = nextLeaf(path);
+      i = 0;
+   }
+   if (!leaf or !(items(leaf)[i].cref() == ::cref(key)))
+      return false;
+
+   items(leaf)[i].~W();
+   moveDown(items(leaf) + i, items(leaf) + i + 1, leaf->count - i - 1);
+   --leaf->count;
+   --_size;
+   if (i == 0 and leaf->count)
+      updateKey(path, items(leaf)[0]);
+   if (leaf->count < minLeafItems and _height)
+      rebalanceLeaf(path, leaf);
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Attempts to find an ITEM in the BPlusTree with the specified KEY.
+template<typename ITEM, unsigned LINES>
+template<typename KEY>
+typename BPlusTree<ITEM, LINES>::ConstIterator BPlusTree<ITEM, LINES>::find (KEY const& key) const
+{
+   ConstIterator itr = findHigh(key);
+   return itr.valid() and itr.cref() == ::cref(key) ? itr : ConstIterator();
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY.
+template<typename ITEM, unsigned LINES>
+template<typename KEY>
+typename BPlusTree<ITEM, LINES>::ConstIterator BPlusTree<ITEM, LINES>::findLow (KEY const& key) const
+{
+   ConstIterator itr = findHigh(key);
+   if (itr.valid() and itr.cref() == ::cref(key))
+      return itr;
+   // Step back to the item before.
+   Leaf const* leaf = itr._leaf;
+   unsigned i = itr._index;
+   if (!leaf) {
+      leaf = descend(key, 0);
+      i = leaf->count;
+   }
+   if (i)
+      return ConstIterator(leaf, i-1);
+   leaf = leaf->prev;
+   return leaf ? ConstIterator(leaf, leaf->count-1) : ConstIterator();
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY.
+template<typename ITEM, unsigned LINES>
+template<typename KEY>
+typename BPlusTree<ITEM, LINES>::ConstIterator BPlusTree<ITEM, LINES>::findHigh (KEY const& key) const
+{
+   Leaf const* leaf = descend(key, 0);
+   unsigned i = NodeSearch::countLess(items(leaf), leaf->count, ::cref(key));
+   // If every item in the leaf is less than key, the first one that isn't starts the next leaf.
+   if (i == leaf->count)
+      return ConstIterator(leaf->next, 0);
+   return ConstIterator(leaf, i);
+}
+
+
+//------------------------------------------------------------------------------
+// Private Methods
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned LINES>
+void* BPlusTree<ITEM, LINES>::allocNode (unsigned bytes)
+{
+   void* node;
+   if (posix_memalign(&node, lineBytes, bytes)) {
+      throw("Error from BPlusTree: could not allocate memory.\n");
+   }
+   return node;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned LINES>
+typename BPlusTree<ITEM, LINES>::Leaf* BPlusTree<ITEM, LINES>::newLeaf ()
+{
+   Leaf* leaf = static_cast<Leaf*>(allocNode(leafBytes));
+   leaf->count = 0;
+   ++_leaves;
+   return leaf;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned LINES>
+typename BPlusTree<ITEM, LINES>::Inner* BPlusTree<ITEM, LINES>::newInner ()
+{
+   Inner* node = static_cast<Inner*>(allocNode(innerBytes));
+   node->count = 0;
+   ++_inners;
+   return node;
+}
+
+//------------------------------------------------------------------------------
+// Frees an empty leaf.
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::freeLeaf (Leaf* leaf)
+{
+   free(leaf);
+   --_leaves;
+}
+
+//------------------------------------------------------------------------------
+// Frees an inner node whose keys have all been moved or destroyed.
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::freeInner (Inner* node)
+{
+   free(node);
+   --_inners;
+}
+
+//------------------------------------------------------------------------------
+// Destroys and frees node and everything under it.
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::destroy (void* node, unsigned height)
+{
+   if (height == 0) {
+      Leaf* leaf = static_cast<Leaf*>(node);
+      for (unsigned i=0; i<leaf->count; ++i)
+         items(leaf)[i].~W();
+      freeLeaf(leaf);
+      return;
+   }
+   Inner* inner = static_cast<Inner*>(node);
+   for (unsigned i=0; i<=inner->count; ++i)
+      destroy(children(inner)[i], height-1);
+   for (unsigned i=0; i<inner->count; ++i)
+      keys(inner)[i].~W();
+   freeInner(inner);
+}
+
+//------------------------------------------------------------------------------
+// Returns the leaf key belongs in (to the left of any equal items).
+/**
+ * Child i of an inner node holds the items from key i-1 to key i, so taking
+ * the child numbered by how many keys are less than key gives the leftmost
+ * leaf that could hold key. Equal items may run on into the leaves after
+ * it, and if every item in the leaf is less than key, the first one that
+ * isn't starts the next leaf.
+ */
+template<typename ITEM, unsigned LINES>
+template<typename KEY>
+typename BPlusTree<ITEM, LINES>::Leaf* BPlusTree<ITEM, LINES>::descend (KEY const& key, Step* path) const
+{
+   void* node = _root;
+   for (unsigned level=0; level<_height; ++level) {
+      Inner* inner = static_cast<Inner*>(node);
+      unsigned child = NodeSearch::countLess(keys(inner), inner->count, ::cref(key));
+      if (path) {
+         path[level].node = inner;
+         path[level].child = child;
+      }
+      node = children(inner)[child];
+   }
+   return static_cast<Leaf*>(node);
+}
+
+//------------------------------------------------------------------------------
+// Moves path on to the next leaf. Returns it, or null (leaving path alone) if there isn't one.
+template<typename ITEM, unsigned LINES>
+typename BPlusTree<ITEM, LINES>::Leaf* BPlusTree<ITEM, LINES>::nextLeaf (Step* path) const
+{
+   unsigned level = _height;
+   while (level > 0 and path[level-1].child == path[level-1].node->count)
+      --level;
+   if (level == 0)
+      return 0;
+   void* node = children(path[level-1].node)[++path[level-1].child];
+   for (; level<_height; ++level) {
+      path[level].node = static_cast<Inner*>(node);
+      path[level].child = 0;
+      node = children(path[level].node)[0];
+   }
+   return static_cast<Leaf*>(node);
+}
+
+//------------------------------------------------------------------------------
+// Adds key and the child to its right to the inner node at the end of path, splitting up the tree as needed.
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::insertChild (Step* path, W const& newKey, void* newChild)
+{
+   W key(newKey);
+   void* child = newChild;
+   for (unsigned level=_height; level>0; --level) {
+      Inner* node = path[level-1].node;
+      unsigned i = path[level-1].child;
+      if (node->count < innerKeys) {
+         insertKey(node, i, key, child);
+         return;
+      }
+
+      // A full node gives the keys after its middle one to a new node, and the middle one goes up.
+      Inner* right = newInner();
+      unsigned middle = innerKeys / 2;
+      right->count = innerKeys - middle - 1;
+      moveDown(keys(right), keys(node) + middle + 1, right->count);
+      for (unsigned j=0; j<=right->count; ++j)
+         children(right)[j] = children(node)[middle + 1 + j];
+      W up(std::move(keys(node)[middle]));
+      keys(node)[middle].~W();
+      node->count = middle;
+      // (When i is middle, key goes at the end of node.)
+      if (i <= middle) {
+         insertKey(node, i, key, child);
+      } else {
+         insertKey(right, i - middle - 1, key, child);
+      }
+      key = up;
+      child = right;
+   }
+
+   // The root was split, so a new one goes above it.
+   Inner* root = newInner();
+   new(&keys(root)[0]) W(key);
+   children(root)[0] = _root;
+   children(root)[1] = child;
+   root->count = 1;
+   _root = root;
+   ++_height;
+}
+
+//------------------------------------------------------------------------------
+// Adds key at i in node (which has room), and child after it.
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::insertKey (Inner* node, unsigned i, W const& key, void* child)
+{
+   moveUp(keys(node) + i + 1, keys(node) + i, node->count - i);
+   for (unsigned j=node->count+1; j>i+1; --j)
+      children(node)[j] = children(node)[j-1];
+   new(&keys(node)[i]) W(key);
+   children(node)[i+1] = child;
+   ++node->count;
+}
+
+//------------------------------------------------------------------------------
+// Updates the key for the leaf at the end of path, after its first item has changed.
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::updateKey (Step* path, W const& first)
+{
+   // The key is in the lowest node the leaf isn't the first thing under (if there is one).
+   for (unsigned level=_height; level>0; --level) {
+      if (path[level-1].child) {
+         keys(path[level-1].node)[path[level-1].child - 1] = first;
+         return;
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Refills a leaf that is less than half full from a neighbour, or merges them.
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::rebalanceLeaf (Step* path, Leaf* leaf)
+{
+   Inner* parent = path[_height-1].node;
+   unsigned k = path[_height-1].child;
+   if (k == 0) {
+      ++k;
+   }
+   // The neighbours are children k-1 and k, and keys(parent)[k-1] is between them.
+   Leaf* left = static_cast<Leaf*>(children(parent)[k-1]);
+   Leaf* right = static_cast<Leaf*>(children(parent)[k]);
+
+   if (left->count + right->count <= leafItems) {
+      moveDown(items(left) + left->count, items(right), right->count);
+      left->count += right->count;
+      left->next = right->next;
+      if (right->next)
+         right->next->prev = left;
+      freeLeaf(right);
+      keys(parent)[k-1].~W();
+      moveDown(keys(parent) + k-1, keys(parent) + k, parent->count - k);
+      for (unsigned j=k; j<parent->count; ++j)
+         children(parent)[j] = children(parent)[j+1];
+      --parent->count;
+      if (parent->count < minInnerKeys)
+         rebalanceInner(path, _height-1);
+   } else if (leaf == left) {
+      // Move the first of right's items to the end of left.
+      unsigned moves = (left->count + right->count) / 2 - left->count;
+      moveDown(items(left) + left->count, items(right), moves);
+      moveDown(items(right), items(right) + moves, right->count - moves);
+      left->count += moves;
+      right->count -= moves;
+      keys(parent)[k-1] = items(right)[0];
+   } else {
+      // Move the last of left's items to the start of right.
+      unsigned moves = (left->count + right->count) / 2 - right->count;
+      moveUp(items(right) + moves, items(right), right->count);
+      moveDown(items(right), items(left) + left->count - moves, moves);
+      left->count -= moves;
+      right->count += moves;
+      keys(parent)[k-1] = items(right)[0];
+   }
+}
+
+//------------------------------------------------------------------------------
+// Refills the inner node at path[level] (which is too empty) from a neighbour, or merges them.
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::rebalanceInner (Step* path, unsigned level)
+{
+   Inner* node = path[level].node;
+   if (level == 0) {
+      // The root may have any number of keys, but once it has none its only child becomes the root.
+      if (node->count == 0) {
+         _root = children(node)[0];
+         freeInner(node);
+         --_height;
+      }
+      return;
+   }
+
+   Inner* parent = path[level-1].node;
+   unsigned k = path[level-1].child;
+   if (k == 0) {
+      ++k;
+   }
+   Inner* left = static_cast<Inner*>(children(parent)[k-1]);
+   Inner* right = static_cast<Inner*>(children(parent)[k]);
+
+   if (left->count + right->count < innerKeys) {
+      // The key between them comes down between left's keys and right's.
+      moveDown(keys(left) + left->count, keys(parent) + k-1, 1);
+      moveDown(keys(left) + left->count + 1, keys(right), right->count);
+      for (unsigned j=0; j<=right->count; ++j)
+         children(left)[left->count + 1 + j] = children(right)[j];
+      left->count += right->count + 1;
+      freeInner(right);
+      moveDown(keys(parent) + k-1, keys(parent) + k, parent->count - k);
+      for (unsigned j=k; j<parent->count; ++j)
+         children(parent)[j] = children(parent)[j+1];
+      --parent->count;
+      if (parent->count < minInnerKeys)
+         rebalanceInner(path, level-1);
+   } else if (node == left) {
+      // Rotate right's first child to the end of left, through the parent's key.
+      moveDown(keys(left) + left->count, keys(parent) + k-1, 1);
+      children(left)[left->count + 1] = children(right)[0];
+      ++left->count;
+      moveDown(keys(parent) + k-1, keys(right), 1);
+      moveDown(keys(right), keys(right) + 1, right->count - 1);
+      for (unsigned j=0; j<right->count; ++j)
+         children(right)[j] = children(right)[j+1];
+      --right->count;
+   } else {
+      // Rotate left's last child to the start of right, through the parent's key.
+      moveUp(keys(right) + 1, keys(right), right->count);
+      for (unsigned j=right->count+1; j>0; --j)
+         children(right)[j] = children(right)[j-1];
+      moveDown(keys(right), keys(parent) + k-1, 1);
+      children(right)[0] = children(left)[left->count];
+      ++right->count;
+      moveDown(keys(parent) + k-1, keys(left) + left->count - 1, 1);
+      --left->count;
+   }
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::moveDown (W* to, W* from, unsigned count)
+{
+   for (unsigned i=0; i<count; ++i) {
+      new(&to[i]) W(std::move(from[i]));
+      from[i].~W();
+   }
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::moveUp (W* to, W* from, unsigned count)
+{
+   for (unsigned i=count; i>0; --i) {
+      new(&to[i-1]) W(std::move(from[i-1]));
+      from[i-1].~W();
+   }
+}
+
+
+//==============================================================================
+// Debug Methods
+//==============================================================================
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned LINES>
+void BPlusTree<ITEM, LINES>::printStats () const
+{
+   std::cout << "===== BPlusTree Stats =====\n";
+   std::cout << "Items:         " << _size << '\n';
+   std::cout << "Height:        " << _height << '\n';
+   std::cout << "Leaves:        " << _leaves << " (" << leafItems << " items, " << leafBytes << " bytes each)\n";
+   std::cout << "Inner nodes:   " << _inners << " (" << innerKeys << " keys, " << innerBytes << " bytes each)\n";
+   std::cout << "Leaf fill:     " << (_leaves ? double(_size) / (_leaves * leafItems) : 0.0) << '\n';
+   std::cout << "Bytes:         " << bytes() << '\n';
+   std::cout << '\n';
+}
+
+#endif // ESTDLIB_BPLUS_TREE
@@ -0,0 +1,209 @@
+//==============================================================================
+// ConcurrentQueue.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_CONCURRENT_QUEUE
+#define ESTDLIB_CONCURRENT_QUEUE
+
+#include <atomic>
+#include <new>
+#include "ConcurrentPoolF.h"
+#include "Wrap.hpp"
+
+
+//==============================================================================
+// A lock free multiple producer, single consumer queue.
+//==============================================================================
+/**
+ * Any number of threads may add to a ConcurrentQueue at once, but only one
+ * thread at a time may remove from it. Items come out in the order their adds
+ * took effect, so the items from each producer come out in the order it added
+ * them.
+ *
+ * This is Vyukov's intrusive MPSC queue. Links point to the Link added after
+ * them, as in LinkedList. An add is one exchange of _head and one store to
+ * the old head's next pointer, so producers never wait for each other or for
+ * the consumer. The consumer follows next pointers from _tail, and a stub
+ * Link keeps the queue from ever being empty of Links, so the consumer never
+ * touches _head except to put the stub back. A producer that has exchanged
+ * _head but not yet linked the old head hides its item, and everything added
+ * after it, until it does: remove returns false then, as if the queue were
+ * empty, and a later remove finds them.
+ *
+ * Links come from a ConcurrentPoolF, which may be shared with other queues
+ * (its pieces must be at least sizeof(Link)), so adding and removing never
+ * mallocs once the pool has grown enough. A producer that builds its own
+ * Links (from any allocator) can instead use addLink and removeLink, which
+ * don't touch the pool.
+ */
+
+template<typename ITEM>
+class ConcurrentQueue {
+//------------------------------------------------------------------------------
+// SubClasses
+private:
+   typedef Wrap<ITEM> W;
+
+public:
+   /// The part of a Link the queue uses (the stub is just this).
+   struct Hook {
+      std::atomic<Hook*> _next;
+   };
+
+   struct Link : Hook {
+      W _item;
+      Link (typename W::Ex item): _item(item) {}
+   };
+
+// Member data
+private:
+   char _pad0[64];
+   std::atomic<Hook*> _head;  ///< the Link added last (exchanged by producers)
+   char _pad1[64];            ///< keeps the producers' cache line apart from the consumer's
+   Hook* _tail;               ///< the Link to remove next, or the stub (consumer only)
+   Hook _stub;
+   ConcurrentPoolF* _pool;    ///< where Links come from
+   bool _sharedPool;          ///< true if the pool is shared (and thus should not be deleted)
+
+// Interface
+public:
+   ConcurrentQueue (ConcurrentPoolF* pool = 0);
+   /// Removes any items left (no other thread may be using the queue).
+   ~ConcurrentQueue ();
+   ConcurrentQueue (ConcurrentQueue const&) = delete;
+   ConcurrentQueue& operator= (ConcurrentQueue const&) = delete;
+
+   /// Adds an ITEM (any thread). Returns false if the pool couldn't grow.
+   inline bool add (typename W::Ex item);
+   /// Removes the oldest ITEM into item (consumer only). Returns false if there wasn't one.
+   inline bool remove (ITEM& item);
+
+   /// Adds a Link that you have constructed yourself (any thread).
+   inline void addLink (Link* link);
+   /// Removes the oldest Link, which is then yours (consumer only). Returns a null pointer if there wasn't one.
+   inline Link* removeLink ();
+
+   /// Returns true if there is nothing to remove (consumer only).
+   bool empty () const { return _tail == &_stub and !_stub._next.load(std::memory_order_acquire); }
+   ConcurrentPoolF& pool () const { return *_pool; }
+
+// Private Methods
+private:
+   inline void push (Hook* hook);
+};
+
+
+//==============================================================================
+// Inline Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Adds an ITEM (any thread).
+template<typename ITEM>
+bool ConcurrentQueue<ITEM>::add (typename W::Ex item) {
+   void* memory = _pool->alloc();
+   if (!memory)
+      return false;
+   push(new(memory) Link(item));
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Removes the oldest ITEM into item (consumer only).
+template<typename ITEM>
+bool ConcurrentQueue<ITEM>::remove (ITEM& item) {
+   Link* link = removeLink();
+   if (!link)
+      return false;
+   item = link->_item.t();
+   link->~Link();
+   _pool->free(link);
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Adds a Link that you have constructed yourself (any thread).
+template<typename ITEM>
+void ConcurrentQueue<ITEM>::addLink (Link* link) {
+   push(link);
+}
+
+//------------------------------------------------------------------------------
+// Removes the oldest Link (consumer only).
+/**
+ * _tail is only handed back once its next pointer is set, and then no
+ * producer will touch it again, so the Link can be reused right away.
+ */
+template<typename ITEM>
+typename ConcurrentQueue<ITEM>::Link* ConcurrentQueue<ITEM>::removeLink () {
+   Hook* tail = _tail;
+   Hook* next = tail->_next.load(std::memory_order_acquire);
+   if (tail == &_stub) {
+      if (!next)
+         return 0;
+      _tail = tail = next;
+      next = next->_next.load(std::memory_order_acquire);
+   }
+   if (next) {
+      _tail = next;
+      return static_cast<Link*>(tail);
+   }
+   // tail is the last Link, unless a producer is still linking one after it.
+   if (tail != _head.load(std::memory_order_acquire))
+      return 0;
+   // Put the stub back behind tail, so tail can go.
+   push(&_stub);
+   next = tail->_next.load(std::memory_order_acquire);
+   if (next) {
+      _tail = next;
+      return static_cast<Link*>(tail);
+   }
+   return 0;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM>
+void ConcurrentQueue<ITEM>::push (Hook* hook) {
+   hook->_next.store(0, std::memory_order_relaxed);
+   Hook* prev = _head.exchange(hook, std::memory_order_acq_rel);
+   prev->_next.store(hook, std::memory_order_release);
+}
+
+
+//==============================================================================
+// Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Constructor
+template<typename ITEM>
+ConcurrentQueue<ITEM>::ConcurrentQueue (ConcurrentPoolF* pool)
+   : _head(&_stub), _tail(&_stub)
+{
+   _stub._next.store(0, std::memory_order_relaxed);
+   if (pool) {
+      if (pool->itemSize() < sizeof(Link))
+         throw("Error from ConcurrentQueue constructor: the pool's pieces are too small for a Link.\n");
+      _pool = pool;
+      _sharedPool = true;
+   } else {
+      _pool = new ConcurrentPoolF(sizeof(Link), alignof(Link));
+      _sharedPool = false;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+template<typename ITEM>
+ConcurrentQueue<ITEM>::~ConcurrentQueue () {
+   while (Link* link = removeLink()) {
+      link->~Link();
+      _pool->free(link);
+   }
+   if (!_sharedPool)
+      delete _pool;
+}
+
+
+#endif // ESTDLIB_CONCURRENT_QUEUE
@@ -0,0 +1,170 @@
+//==============================================================================
+// ConcurrentRing.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_CONCURRENT_RING
+#define ESTDLIB_CONCURRENT_RING
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include "Wrap.hpp"
+
+
+//==============================================================================
+// A lock free bounded multiple producer, multiple consumer queue.
+//==============================================================================
+/**
+ * Any number of threads may add to and remove from a ConcurrentRing at once.
+ * It holds at most capacity items (a power of two, and at least 2, since with
+ * one cell a full ring and an empty one look the same): add returns false
+ * when it is full, and remove returns false when it is empty.
+ *
+ * This is Vyukov's bounded MPMC queue. Each cell of the ring has a sequence
+ * number that says whose turn it is: a producer claims position pos (with a
+ * CAS on _addPos) when the cell's sequence is pos, and hands it over by
+ * setting it to pos + 1; a consumer claims it (with a CAS on _removePos) when
+ * it is pos + 1, and hands it back by setting it to pos + capacity. So
+ * producers only contend with producers, and consumers with consumers, and
+ * each item costs one CAS on each side.
+ *
+ * Items are kept in the cells themselves, which are allocated once, so
+ * nothing is allocated per item. (To pass large items, pass pointers to them,
+ * eg. to memory from a ConcurrentPoolF.)
+ */
+
+template<typename ITEM>
+class ConcurrentRing {
+//------------------------------------------------------------------------------
+// SubClasses
+private:
+   typedef Wrap<ITEM> W;
+
+   struct Cell {
+      std::atomic<size_t> _sequence;
+      alignas(W) char _slot[sizeof(W)];
+      W* item () { return reinterpret_cast<W*>(_slot); }
+   };
+
+// Member data
+private:
+   Cell* _cells;
+   size_t _mask;                   ///< capacity - 1
+   char _pad0[64];
+   std::atomic<size_t> _addPos;    ///< the next position to add at
+   char _pad1[64];
+   std::atomic<size_t> _removePos; ///< the next position to remove from
+   char _pad2[64];
+
+// Interface
+public:
+   /// capacity (at least 2) is rounded up to a power of two.
+   ConcurrentRing (unsigned capacity);
+   /// Destroys any items left (no other thread may be using the ring).
+   ~ConcurrentRing ();
+   ConcurrentRing (ConcurrentRing const&) = delete;
+   ConcurrentRing& operator= (ConcurrentRing const&) = delete;
+
+   /// Adds an ITEM. Returns false if the ring is full.
+   inline bool add (typename W::Ex item);
+   /// Removes the oldest ITEM into item. Returns false if the ring is empty.
+   inline bool remove (ITEM& item);
+
+   unsigned capacity () const { return _mask + 1; }
+   /// Returns the number of items (which other threads may be changing).
+   unsigned size () const {
+      size_t added = _addPos.load(std::memory_order_relaxed);
+      size_t removed = _removePos.load(std::memory_order_relaxed);
+      return added > removed ? added - removed : 0;
+   }
+};
+
+
+//==============================================================================
+// Inline Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Adds an ITEM. Returns false if the ring is full.
+template<typename ITEM>
+bool ConcurrentRing<ITEM>::add (typename W::Ex item) {
+   size_t pos = _addPos.load(std::memory_order_relaxed);
+   Cell* cell;
+   while (true) {
+      cell = &_cells[pos & _mask];
+      size_t sequence = cell->_sequence.load(std::memory_order_acquire);
+      ptrdiff_t turn = static_cast<ptrdiff_t>(sequence - pos);
+      if (turn == 0) {
+         if (_addPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+      } else if (turn < 0) {
+         return false;   // the cell still holds the item from a lap ago
+      } else {
+         pos = _addPos.load(std::memory_order_relaxed);
+      }
+   }
+   new(cell->item()) W(item);
+   cell->_sequence.store(pos + 1, std::memory_order_release);
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Removes the oldest ITEM into item. Returns false if the ring is empty.
+template<typename ITEM>
+bool ConcurrentRing<ITEM>::remove (ITEM& item) {
+   size_t pos = _removePos.load(std::memory_order_relaxed);
+   Cell* cell;
+   while (true) {
+      cell = &_cells[pos & _mask];
+      size_t sequence = cell->_sequence.load(std::memory_order_acquire);
+      ptrdiff_t turn = static_cast<ptrdiff_t>(sequence - (pos + 1));
+      if (turn == 0) {
+         if (_removePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+      } else if (turn < 0) {
+         return false;   // nothing has been added at pos yet
+      } else {
+         pos = _removePos.load(std::memory_order_relaxed);
+      }
+   }
+   item = cell->item()->t();
+   cell->item()->~W();
+   cell->_sequence.store(pos + _mask + 1, std::memory_order_release);
+   return true;
+}
+
+
+//==============================================================================
+// Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Constructor
+template<typename ITEM>
+ConcurrentRing<ITEM>::ConcurrentRing (unsigned capacity)
+   : _addPos(0), _removePos(0)
+{
+   if (capacity < 2)
+      throw("Error from ConcurrentRing constructor: capacity must be at least 2.\n");
+   size_t cells = 1;
+   while (cells < capacity)
+      cells <<= 1;
+   _mask = cells - 1;
+   _cells = new Cell[cells];
+   for (size_t i=0; i<cells; ++i)
+      _cells[i]._sequence.store(i, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+template<typename ITEM>
+ConcurrentRing<ITEM>::~ConcurrentRing () {
+   size_t added = _addPos.load(std::memory_order_relaxed);
+   for (size_t pos = _removePos.load(std::memory_order_relaxed); pos != added; ++pos)
+      _cells[pos & _mask].item()->~W();
+   delete[] _cells;
+}
+
+
+#endif // ESTDLIB_CONCURRENT_RING
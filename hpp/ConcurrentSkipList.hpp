@@ -0,0 +1,621 @@
+//==============================================================================
+// ConcurrentSkipList.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_CONCURRENT_SKIPLIST
+#define ESTDLIB_CONCURRENT_SKIPLIST
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include "Epoch.h"
+#include "Wrap.hpp"
+#include "Random.h"
+
+
+//==============================================================================
+// A lock free skiplist.
+//==============================================================================
+/**
+ * ConcurrentSkipList has the same find, findLow and findHigh methods as
+ * SkipList, but any number of threads may add, remove and search at once.
+ * Like SkipList it keeps items in order (using ITEM < ITEM, and ITEM < KEY
+ * and ITEM == KEY for searches), and it may hold several equal items.
+ *
+ * Each lane is a lock free linked list in the style of Harris, Fraser and
+ * Herlihy & Shavit. A Link's next pointers carry a mark in their low bit. A
+ * Link is removed by marking its next pointers from its top lane down; the
+ * thread that marks lane 0 has removed it. Marked Links are then unlinked
+ * from each lane with CAS, by the remover and by any search that passes
+ * them. New Links are linked into lane 0 first (which is when they join the
+ * list) and then into their express lanes, one CAS each.
+ *
+ * Links are malloced, and are only freed through an Epoch (see Epoch.h):
+ * every operation pins the calling thread while it runs, and unlinked Links
+ * are retired rather than freed. Iterators point directly at Links, so they
+ * may only be used while the thread holds a Guard (from pin()). For example,
+ * to scan a range:
+ *
+ *   ConcurrentSkipList<Event>::Guard guard = list.pin();
+ *   for (auto itr = list.findHigh(start); itr.valid() and itr.cref() < end; ++itr)
+ *      ...
+ *
+ * A Link that is being linked into its express lanes while another thread
+ * removes it is retired by whichever of the two finishes last, so it is never
+ * retired while it could still be linked.
+ *
+ * There is a fixed maximum number of lanes (maxLanes). The lanes in use grow
+ * with the list, as in SkipList: a new Link gets at most one more lane than
+ * the tallest Link so far. Each thread draws lane counts from its own
+ * XorShift32.
+ */
+
+template<typename ITEM>
+class ConcurrentSkipList {
+//------------------------------------------------------------------------------
+// SubClasses
+private:
+   typedef Wrap<ITEM> W;
+
+public:
+   static const unsigned maxLanes = 32;
+   typedef Epoch::Guard Guard;
+
+private:
+   /// The links that form the list.
+   struct Link {
+      W item;
+      unsigned lanes;
+      /// 1 while the adding thread is still linking express lanes, | 2 once the Link has been removed
+      std::atomic<unsigned> state;
+      std::atomic<uintptr_t> next[1]; // this is really the first item in an array of lanes pointers (with marks)
+
+      Link (typename W::Ex item, unsigned lanes): item(item), lanes(lanes), state(1) {
+         for (unsigned i=0; i<lanes; ++i)
+            new(&next[i]) std::atomic<uintptr_t>(0);
+      }
+      static unsigned footprint (unsigned lanes) { return sizeof(Link) + (lanes-1)*sizeof(std::atomic<uintptr_t>); }
+   };
+
+   static Link* ptr (uintptr_t next) { return reinterpret_cast<Link*>(next & ~uintptr_t(1)); }
+   static bool marked (uintptr_t next) { return next & 1; }
+   static uintptr_t bits (Link* link) { return reinterpret_cast<uintptr_t>(link); }
+
+public:
+   /// Iterates over the ConcurrentSkipList (only while a Guard is held), skipping removed items.
+   class ConstIterator {
+   friend class ConcurrentSkipList;
+   protected:
+      Link const* _current;
+   public:
+      ConstIterator (): _current(0) {}
+      ConstIterator (Link const* link): _current(link) {}
+      bool valid () const { return _current; }
+      typename W::CRef cref () const { return _current->item.cref(); }
+      typename W::CPtr cptr () const { return _current->item.cptr(); }
+      typename W::Ex   ex   () const { return _current->item.ex(); }
+      /// true if the item has been removed (since the Iterator reached it)
+      bool removed () const { return marked(_current->next[0].load(std::memory_order_acquire)); }
+      ConstIterator& operator++ ();
+   };
+
+   /// Iterates over the ConcurrentSkipList. (Items must not be changed in ways that change their order.)
+   class Iterator : public ConstIterator {
+   public:
+      Iterator (): ConstIterator() {}
+      Iterator (Link* link): ConstIterator(link) {}
+      typename W::Ref ref () const { return const_cast<Link*>(this->_current)->item.ref(); }
+      typename W::Ptr ptr () const { return const_cast<Link*>(this->_current)->item.ptr(); }
+      Iterator& operator++ () { ConstIterator::operator++(); return *this; }
+   };
+
+// Member data
+private:
+   Epoch* _epoch;       ///< reclaims removed Links
+   bool _sharedEpoch;   ///< true if the Epoch is shared (and thus should not be deleted)
+   Link* _head;         ///< dummy link at the head of the list (with maxLanes lanes)
+   float _linkProb;     ///< probability of new entry linking to lane n is _linkProb^n
+   std::atomic<unsigned> _lanes;  ///< number of lanes in use (the most any Link has)
+   std::atomic<unsigned> _size;   ///< number of items
+
+// Interface
+public:
+   ConcurrentSkipList (float linkProb = 0.25, Epoch* epoch = 0);
+   /// Frees every Link (no other thread may be using the list).
+   ~ConcurrentSkipList ();
+   ConcurrentSkipList (ConcurrentSkipList const&) = delete;
+   ConcurrentSkipList& operator= (ConcurrentSkipList const&) = delete;
+
+   /// Returns a Guard, which must be held while Iterators are used.
+   Guard pin () { return Guard(*_epoch); }
+
+   /// Adds a new ITEM to the ConcurrentSkipList.
+   Iterator add (typename W::Ex item);
+   /// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+   template<typename KEY> bool remove (KEY const& key);
+   /// Removes the ITEM itr points to. Returns false if another thread removed it first.
+   bool remove (ConstIterator itr);
+   bool remove (Iterator itr) { return remove(static_cast<ConstIterator>(itr)); }
+
+   /// Attempts to find an ITEM in the ConcurrentSkipList with the specified KEY.
+   template<typename KEY> Iterator find (KEY const& key);
+   /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY.
+   template<typename KEY> Iterator findLow (KEY const& key);
+   /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY.
+   template<typename KEY> Iterator findHigh (KEY const& key);
+
+   /// Attempts to find an ITEM in the ConcurrentSkipList with the specified KEY.
+   template<typename KEY> ConstIterator find (KEY const& key) const;
+   /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY.
+   template<typename KEY> ConstIterator findLow (KEY const& key) const;
+   /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY.
+   template<typename KEY> ConstIterator findHigh (KEY const& key) const;
+
+   /// Returns an Iterator to the first ITEM in the ConcurrentSkipList.
+   Iterator iterator () { return Iterator(firstLive(_head)); }
+   /// Returns a ConstIterator to the first ITEM in the ConcurrentSkipList.
+   ConstIterator constIterator () const { return ConstIterator(firstLive(_head)); }
+
+   /// Returns the number of items in the ConcurrentSkipList (which other threads may be changing).
+   unsigned size () const { return _size.load(std::memory_order_relaxed); }
+   unsigned lanes () const { return _lanes.load(std::memory_order_relaxed); }
+
+// Private Methods
+private:
+   /// Fills preds and succs with the last Link before key, and the first at or after it, in the lanes below lanes (at least).
+   template<typename KEY> void search (KEY const& key, Link** preds, Link** succs, unsigned lanes) const;
+   /// Returns the last Link before key (possibly _head), without changing the list.
+   template<typename KEY> Link* searchLow (KEY const& key) const;
+   /// Returns low (the last Link before key) if it hasn't been removed, or else the last Link before key that hasn't been.
+   template<typename KEY> Link* lastLive (Link* low, KEY const& key) const;
+   /// Returns the first Link after link (or link itself if include is true) that hasn't been removed.
+   static Link* firstLive (Link const* link, bool include = false);
+   /// Marks link as removed. Returns true if this thread did it.
+   bool mark (Link* link);
+   /// Unlinks link from every lane it is in.
+   void unlink (Link* link);
+   /// Retires link, if the thread that added it is done with it.
+   void release (Link* link, Guard& guard, unsigned done);
+   unsigned chooseNewLanes () const;
+   static void reclaim (void* link);
+};
+
+
+//==============================================================================
+// Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Constructor
+template<typename ITEM>
+ConcurrentSkipList<ITEM>::ConcurrentSkipList (float linkProb, Epoch* epoch)
+   : _linkProb(linkProb), _lanes(1), _size(0)
+{
+   // Ensure linkProb is valid.
+   if (0.0 >= _linkProb or _linkProb >= 1.0) {
+      throw("Error from ConcurrentSkipList constructor: linkProb must be between 0 and 1.\n");
+   }
+
+   // Set up Epoch
+   if (epoch) {
+      _sharedEpoch = true;
+      _epoch = epoch;
+   } else {
+      _sharedEpoch = false;
+      _epoch = new Epoch;
+   }
+
+   // The head's item is never constructed or looked at.
+   _head = static_cast<Link*>(malloc(Link::footprint(maxLanes)));
+   if (!_head) {
+      throw("Error from ConcurrentSkipList constructor: could not allocate memory.\n");
+   }
+   _head->lanes = maxLanes;
+   new(&_head->state) std::atomic<unsigned>(0);
+   for (unsigned i=0; i<maxLanes; ++i)
+      new(&_head->next[i]) std::atomic<uintptr_t>(0);
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+template<typename ITEM>
+ConcurrentSkipList<ITEM>::~ConcurrentSkipList ()
+{
+   // Removed Links are only in the Epoch, and every Link in lane 0 is only there.
+   Link* link = ptr(_head->next[0].load(std::memory_order_relaxed));
+   while (link) {
+      Link* next = ptr(link->next[0].load(std::memory_order_relaxed));
+      if (!marked(link->next[0].load(std::memory_order_relaxed)))
+         reclaim(link);
+      link = next;
+   }
+   free(_head);
+   if (!_sharedEpoch)
+      delete _epoch;
+}
+
+//------------------------------------------------------------------------------
+// Adds an ITEM to the ConcurrentSkipList.
+template<typename ITEM>
+typename ConcurrentSkipList<ITEM>::Iterator ConcurrentSkipList<ITEM>::add (typename W::Ex item)
+{
+   Guard guard(*_epoch);
+   unsigned newLanes = chooseNewLanes();
+   Link* newLink = new( malloc(Link::footprint(newLanes)) ) Link(item, newLanes);
+   Link* preds[maxLanes];
+   Link* succs[maxLanes];
+
+   // Link into lane 0, which adds the item to the list.
+   while (true) {
+      search(newLink->item.cref(), preds, succs, newLanes);
+      for (unsigned i=0; i<newLanes; ++i)
+         newLink->next[i].store(bits(succs[i]), std::memory_order_relaxed);
+      uintptr_t expected = bits(succs[0]);
+      if (preds[0]->next[0].compare_exchange_strong(expected, bits(newLink), std::memory_order_acq_rel))
+         break;
+   }
+   _size.fetch_add(1, std::memory_order_relaxed);
+
+   // Raise the number of lanes in use if this is the tallest Link.
+   unsigned lanes = _lanes.load(std::memory_order_relaxed);
+   while (newLanes > lanes and !_lanes.compare_exchange_weak(lanes, newLanes, std::memory_order_relaxed));
+
+   // Link into the express lanes, unless the Link is removed in the meantime.
+   for (unsigned i=1; i<newLanes; ++i) {
+      while (true) {
+         uintptr_t next = newLink->next[i].load(std::memory_order_acquire);
+         if (marked(next))
+            goto linked;
+         if (ptr(next) != succs[i]) {
+            // point the new Link at the successor found by the last search
+            if (!newLink->next[i].compare_exchange_strong(next, bits(succs[i]), std::memory_order_acq_rel))
+               goto linked;   // it was marked
+         }
+         uintptr_t expected = bits(succs[i]);
+         if (preds[i]->next[i].compare_exchange_strong(expected, bits(newLink), std::memory_order_acq_rel))
+            break;
+         search(newLink->item.cref(), preds, succs, newLanes);
+      }
+   }
+linked:
+   // If the Link was removed while it was being linked, it may have been
+   // linked into a lane after the remover unlinked it from that lane.
+   if (marked(newLink->next[0].load(std::memory_order_seq_cst)))
+      unlink(newLink);
+   release(newLink, guard, 1);
+   return Iterator(newLink);
+}
+
+//------------------------------------------------------------------------------
+// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+template<typename ITEM>
+template<typename KEY>
+bool ConcurrentSkipList<ITEM>::remove (KEY const& key)
+{
+   Guard guard(*_epoch);
+   Link* preds[maxLanes];
+   Link* succs[maxLanes];
+   while (true) {
+      search(key, preds, succs, 1);
+      Link* link = firstLive(succs[0], true);
+      if (!link or !(link->item.cref() == cref(key)))
+         return false;
+      if (mark(link)) {
+         _size.fetch_sub(1, std::memory_order_relaxed);
+         unlink(link);
+         release(link, guard, 2);
+         return true;
+      }
+      // another thread removed it first, so look for another equal item
+   }
+}
+
+//------------------------------------------------------------------------------
+// Removes the ITEM itr points to. Returns false if another thread removed it first.
+template<typename ITEM>
+bool ConcurrentSkipList<ITEM>::remove (ConstIterator itr)
+{
+   Guard guard(*_epoch);
+   Link* link = const_cast<Link*>(itr._current);
+   if (!link or !mark(link))
+      return false;
+   _size.fetch_sub(1, std::memory_order_relaxed);
+   unlink(link);
+   release(link, guard, 2);
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Attempts to find an ITEM in the ConcurrentSkipList with the specified KEY.
+template<typename ITEM>
+template<typename KEY>
+typename ConcurrentSkipList<ITEM>::Iterator ConcurrentSkipList<ITEM>::find (KEY const& key)
+{
+   Guard guard(*_epoch);
+   Link* link = firstLive(searchLow(key));
+   return Iterator( link and link->item.cref() == cref(key) ? link : 0 );
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY.
+/**
+ * The Iterator is invalid if every ITEM is larger than key.
+ */
+template<typename ITEM>
+template<typename KEY>
+typename ConcurrentSkipList<ITEM>::Iterator ConcurrentSkipList<ITEM>::findLow (KEY const& key)
+{
+   Guard guard(*_epoch);
+   Link* low = searchLow(key);
+   Link* link = firstLive(low);
+   if (link and link->item.cref() == cref(key))
+      return Iterator(link);
+   low = lastLive(low, key);
+   return Iterator( low == _head ? 0 : low );
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY.
+template<typename ITEM>
+template<typename KEY>
+typename ConcurrentSkipList<ITEM>::Iterator ConcurrentSkipList<ITEM>::findHigh (KEY const& key)
+{
+   Guard guard(*_epoch);
+   return Iterator( firstLive(searchLow(key)) );
+}
+
+//------------------------------------------------------------------------------
+// Attempts to find an ITEM in the ConcurrentSkipList with the specified KEY.
+template<typename ITEM>
+template<typename KEY>
+typename ConcurrentSkipList<ITEM>::ConstIterator ConcurrentSkipList<ITEM>::find (KEY const& key) const
+{
+   Guard guard(*_epoch);
+   Link* link = firstLive(searchLow(key));
+   return ConstIterator( link and link->item.cref() == cref(key) ? link : 0 );
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY.
+template<typename ITEM>
+template<typename KEY>
+typename ConcurrentSkipList<ITEM>::ConstIterator ConcurrentSkipList<ITEM>::findLow (KEY const& key) const
+{
+   Guard guard(*_epoch);
+   Link* low = searchLow(key);
+   Link* link = firstLive(low);
+   if (link and link->item.cref() == cref(key))
+      return ConstIterator(link);
+   low = lastLive(low, key);
+   return ConstIterator( low == _head ? 0 : low );
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY.
+template<typename ITEM>
+template<typename KEY>
+typename ConcurrentSkipList<ITEM>::ConstIterator ConcurrentSkipList<ITEM>::findHigh (KEY const& key) const
+{
+   Guard guard(*_epoch);
+   return ConstIterator( firstLive(searchLow(key)) );
+}
+
+
+//==============================================================================
+// Private Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Fills preds and succs with the last Link before key, and the first at or after it, in the lanes below lanes (at least).
+/**
+ * The search starts in the top lane in use, or lane lanes-1 if that is
+ * higher (a Link that adds a lane is linked into it before _lanes is raised).
+ * Marked Links that the search passes are unlinked. If an unlinking CAS fails
+ * (because the predecessor changed or was marked itself) the search starts
+ * over from the head.
+ */
+template<typename ITEM>
+template<typename KEY>
+void ConcurrentSkipList<ITEM>::search (KEY const& key, Link** preds, Link** succs, unsigned lanes) const
+{
+   unsigned inUse = _lanes.load(std::memory_order_acquire);
+   if (lanes < inUse)
+      lanes = inUse;
+retry:
+   Link* pred = _head;
+   for (int lane = lanes-1; lane >= 0; --lane) {
+      Link* curr = ptr(pred->next[lane].load(std::memory_order_acquire));
+      while (curr) {
+         uintptr_t succ = curr->next[lane].load(std::memory_order_acquire);
+         while (marked(succ)) {
+            uintptr_t expected = bits(curr);
+            if (!pred->next[lane].compare_exchange_strong(expected, succ & ~uintptr_t(1), std::memory_order_acq_rel))
+               goto retry;
+            curr = ptr(succ);
+            if (!curr)
+               break;
+            succ = curr->next[lane].load(std::memory_order_acquire);
+         }
+         if (curr and curr->item.cref() < cref(key)) {
+            pred = curr;
+            curr = ptr(succ);
+         } else {
+            break;
+         }
+      }
+      preds[lane] = pred;
+      succs[lane] = curr;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Returns the last Link before key (possibly _head), without changing the list.
+/**
+ * Readers don't help unlink removed Links; they just step over them.
+ */
+template<typename ITEM>
+template<typename KEY>
+typename ConcurrentSkipList<ITEM>::Link* ConcurrentSkipList<ITEM>::searchLow (KEY const& key) const
+{
+   Link* pred = _head;
+   for (int lane = _lanes.load(std::memory_order_acquire) - 1; lane >= 0; --lane) {
+      Link* curr = ptr(pred->next[lane].load(std::memory_order_acquire));
+      while (curr and curr->item.cref() < cref(key)) {
+         pred = curr;
+         curr = ptr(curr->next[lane].load(std::memory_order_acquire));
+      }
+   }
+   return pred;
+}
+
+//------------------------------------------------------------------------------
+// Returns low (the last Link before key) if it hasn't been removed, or else the last Link before key that hasn't been.
+/**
+ * Lane 0 can't be walked backwards, so when low has been removed this
+ * searches again for the last Link before low's item, and walks forward from
+ * there to key, keeping the last live Link it passes. That Link may have
+ * been removed too (if there was no live Link between it and key), in which
+ * case it goes round again, each time from a smaller item, until it reaches
+ * a live Link or _head.
+ */
+template<typename ITEM>
+template<typename KEY>
+typename ConcurrentSkipList<ITEM>::Link* ConcurrentSkipList<ITEM>::lastLive (Link* low, KEY const& key) const
+{
+   while (low != _head and marked(low->next[0].load(std::memory_order_acquire))) {
+      Link* live = searchLow(low->item.cref());
+      for (Link* curr = ptr(live->next[0].load(std::memory_order_acquire)); curr and curr->item.cref() < cref(key); ) {
+         uintptr_t next = curr->next[0].load(std::memory_order_acquire);
+         if (!marked(next))
+            live = curr;
+         curr = ptr(next);
+      }
+      low = live;
+   }
+   return low;
+}
+
+//------------------------------------------------------------------------------
+// Returns the first Link after link (or link itself if include is true) that hasn't been removed.
+template<typename ITEM>
+typename ConcurrentSkipList<ITEM>::Link* ConcurrentSkipList<ITEM>::firstLive (Link const* link, bool include)
+{
+   if (!link)
+      return 0;
+   Link* curr = include ? const_cast<Link*>(link) : ptr(link->next[0].load(std::memory_order_acquire));
+   while (curr) {
+      uintptr_t next = curr->next[0].load(std::memory_order_acquire);
+      if (!marked(next))
+         return curr;
+      curr = ptr(next);
+   }
+   return 0;
+}
+
+//------------------------------------------------------------------------------
+// Marks link as removed. Returns true if this thread did it.
+/**
+ * The express lanes are marked from the top down, then lane 0, which decides
+ * which thread removed the Link.
+ */
+template<typename ITEM>
+bool ConcurrentSkipList<ITEM>::mark (Link* link)
+{
+   for (unsigned lane = link->lanes-1; lane > 0; --lane)
+      link->next[lane].fetch_or(1, std::memory_order_acq_rel);
+   uintptr_t next = link->next[0].load(std::memory_order_acquire);
+   while (!marked(next)) {
+      if (link->next[0].compare_exchange_weak(next, next | 1, std::memory_order_acq_rel))
+         return true;
+   }
+   return false;
+}
+
+//------------------------------------------------------------------------------
+// Unlinks link from every lane it is in.
+/**
+ * search unlinks marked Links it passes, but stops at the first Link equal to
+ * the key, so with equal items link may be further along. Each lane is
+ * walked from the search's predecessor across the equal items.
+ */
+template<typename ITEM>
+void ConcurrentSkipList<ITEM>::unlink (Link* link)
+{
+   Link* preds[maxLanes];
+   Link* succs[maxLanes];
+retry:
+   search(link->item.cref(), preds, succs, link->lanes);
+   for (int lane = link->lanes-1; lane >= 0; --lane) {
+      Link* pred = preds[lane];
+      Link* curr = succs[lane];
+      while (curr and curr != link and !(link->item.cref() < curr->item.cref())) {
+         pred = curr;
+         curr = ptr(curr->next[lane].load(std::memory_order_acquire));
+      }
+      if (curr != link)
+         continue;   // not in this lane
+      uintptr_t expected = bits(link);
+      uintptr_t next = link->next[lane].load(std::memory_order_acquire) & ~uintptr_t(1);
+      if (!pred->next[lane].compare_exchange_strong(expected, next, std::memory_order_acq_rel))
+         goto retry;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Retires link, if the thread that added it is done with it.
+/**
+ * The adding thread clears the 1 bit of state when it is done linking
+ * express lanes, and the removing thread sets the 2 bit once it has unlinked
+ * the Link. Whichever comes second retires it.
+ */
+template<typename ITEM>
+void ConcurrentSkipList<ITEM>::release (Link* link, Guard& guard, unsigned done)
+{
+   bool last = done == 1
+      ? link->state.fetch_and(~1u, std::memory_order_acq_rel) & 2
+      : !(link->state.fetch_or(2, std::memory_order_acq_rel) & 1);
+   if (last)
+      guard.retire(link, &reclaim);
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM>
+unsigned ConcurrentSkipList<ITEM>::chooseNewLanes () const
+{
+   static std::atomic<unsigned> seeds(0);
+   thread_local XorShift32 rand(0x5c1a11ed + seeds.fetch_add(1, std::memory_order_relaxed), 0xadefceed);
+   unsigned limit = _lanes.load(std::memory_order_relaxed) + 1;
+   if (limit > maxLanes)
+      limit = maxLanes;
+   double random = rand.f64();
+   unsigned newLanes(1);
+   double cutoff(_linkProb);
+   while (newLanes < limit and random <= cutoff) {
+      ++newLanes;
+      cutoff *= _linkProb;
+   }
+   return newLanes;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM>
+void ConcurrentSkipList<ITEM>::reclaim (void* memory)
+{
+   Link* link = static_cast<Link*>(memory);
+   link->item.~W();
+   free(link);
+}
+
+//------------------------------------------------------------------------------
+// Moves to the next item that hasn't been removed.
+template<typename ITEM>
+typename ConcurrentSkipList<ITEM>::ConstIterator& ConcurrentSkipList<ITEM>::ConstIterator::operator++ ()
+{
+   _current = firstLive(_current);
+   return *this;
+}
+
+
+#endif // ESTDLIB_CONCURRENT_SKIPLIST
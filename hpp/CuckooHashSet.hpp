@@ -0,0 +1,541 @@
+//==============================================================================
+// CuckooHashSet.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_CUCKOO_HASH_SET
+#define ESTDLIB_CUCKOO_HASH_SET
+
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "Wrap.hpp"
+#include "HashFunctions.h"
+
+
+//==============================================================================
+// Theory
+//==============================================================================
+/*
+ * Requirements:
+ * The same as for HashSet: ITEM must have a method "unsigned hash() const",
+ * and "==" must be defined for two ITEMs. As with HashSet, ITEM can be an
+ * object type or a pointer type, and find accepts any KEY with KEY.hash()
+ * and ITEM == KEY defined (or a pointer to one).
+ *
+ * Implementation Details:
+ * A CuckooHashSet is an array of buckets, each of which has four slots. Every
+ * item can live in one of two buckets, which are chosen by two different
+ * mixes (see HashFunctions.h) of the item's hash. A bucket stores the full
+ * hash of each of its items next to the items themselves, and is aligned to a
+ * cache line. So as long as four ITEMs and their hashes fit in a cache line
+ * (ie ITEM is a pointer, or an object of at most 11 bytes), find touches at
+ * most two cache lines, no matter how full the set is.
+ *
+ * When both of a new item's buckets are full, it takes a random slot in one
+ * of them, and the item that was there moves to its other bucket (possibly
+ * displacing another item, and so on). If this chain of displacements gets
+ * too long, the item left over goes into a small stash, which find only
+ * searches when it is not empty. Only when the stash is full does the set
+ * double its number of buckets. This way the set can be filled to well over
+ * 90% of its slots (see the maxLoad constructor argument).
+ *
+ * Adding items can move existing items between slots, so pointers and
+ * references to items (and iterators) are invalidated by add.
+ */
+
+
+//==============================================================================
+// Class CuckooHashSet<ITEM>
+//==============================================================================
+
+template<class ITEM>
+class CuckooHashSet {
+//------------------------------------------------------------------------------
+// Constants and SubClasses
+private:
+   typedef Wrap<ITEM> W;
+
+   static const unsigned _ways = 4;        ///< slots per bucket
+   static const unsigned _stashSize = 8;   ///< slots in the stash
+   static const unsigned _maxKicks = 256;  ///< longest chain of displacements before using the stash
+   static const unsigned _lineBytes = 64;
+
+   /// Four slots, the hashes of the items in them, and a record of which are used.
+   struct alignas(_lineBytes) Bucket {
+      unsigned _hash[_ways];
+      unsigned _used;      ///< bit i is set if slot i holds an item
+      alignas(W) unsigned char _slot[_ways][sizeof(W)];
+      W& item (unsigned i) { return *reinterpret_cast<W*>(_slot[i]); }
+      W const& item (unsigned i) const { return *reinterpret_cast<W const*>(_slot[i]); }
+      /// Returns a mask of the used slots whose items have the specified hash.
+      unsigned matches (unsigned hash) const {
+         unsigned m = 0;
+         for (unsigned i=0; i<_ways; ++i)
+            m |= unsigned(_hash[i] == hash) << i;
+         return m & _used;
+      }
+   };
+
+//------------------------------------------------------------------------------
+// Iterators
+public:
+   /// Iterates through the items in a CuckooHashSet (bucket by bucket, then the stash).
+   class ConstIterator {
+   protected:
+      CuckooHashSet const* _set;
+      unsigned _bucket;   ///< current bucket (equal to _set->_buckets when in the stash)
+      unsigned _slot;     ///< current slot in the bucket or stash
+   public:
+      ConstIterator (CuckooHashSet const& set): _set(&set), _bucket(0), _slot(0) { findUsedSlot(); }
+      bool valid () const { return _bucket < _set->_buckets or _slot < _set->_stashed; }
+      typename W::CRef cref () const { return w().cref(); }
+      typename W::CPtr cptr () const { return w().cptr(); }
+      ConstIterator& operator++ () { ++_slot; findUsedSlot(); return *this; }
+   protected:
+      W const& w () const {
+         return _bucket < _set->_buckets ? _set->_bucket[_bucket].item(_slot) : _set->stashItem(_slot);
+      }
+   private:
+      void findUsedSlot ();
+   };
+   friend class ConstIterator;
+
+   /// Iterates through the items in a CuckooHashSet, allowing changes to them.
+   class Iterator : public ConstIterator {
+   public:
+      Iterator (CuckooHashSet& set): ConstIterator(set) {}
+      typename W::Ref ref () const { return const_cast<W&>(this->w()).ref(); }
+      typename W::Ptr ptr () const { return const_cast<W&>(this->w()).ptr(); }
+      Iterator& operator++ () { ConstIterator::operator++(); return *this; }
+   };
+
+//------------------------------------------------------------------------------
+// Member Data
+private:
+   void* _memory;        ///< what malloc gave us (_bucket is aligned within it)
+   Bucket* _bucket;      ///< array of buckets
+   unsigned _buckets;    ///< length of _bucket (always a power of 2)
+   unsigned _mask;       ///< _buckets - 1
+   unsigned _size;       ///< number of items in the set
+   unsigned _trigger;    ///< the set doubles when _size would exceed _trigger
+   float _maxLoad;       ///< fraction of slots that may be used before doubling
+   unsigned _stashed;    ///< number of items in the stash
+   unsigned _kicks;      ///< counts displacements (used to choose which slot to take)
+   unsigned _stashHash[_stashSize];
+   alignas(W) unsigned char _stash[_stashSize][sizeof(W)];
+
+//------------------------------------------------------------------------------
+// Interface
+public:
+   /// Makes room for initialCapacity items. The set doubles when more than maxLoad of its slots are used.
+   CuckooHashSet (unsigned initialCapacity, float maxLoad = 0.95);
+   ~CuckooHashSet ();
+   CuckooHashSet (CuckooHashSet const&) = delete;
+   CuckooHashSet& operator= (CuckooHashSet const&) = delete;
+
+   /// Adds a new item. If the item is already in the set, it returns a reference to the existing item.
+   typename W::Ref add (typename W::Ex item);
+   /// Returns a pointer to the corresponding item, or a null pointer if the item is not in the set.
+   template<class KEY> typename W::CPtr find (KEY const& key) const;
+   /// Returns a pointer to the corresponding item, or a null pointer if the item is not in the set.
+   template<class KEY> typename W::Ptr find (KEY const& key) {
+      W const* w = findW(key);
+      return w ? const_cast<W*>(w)->ptr() : 0;
+   }
+   /// Removes the corresponding item. Returns false if it wasn't in the set.
+   template<class KEY> bool remove (KEY const& key);
+   /// Removes all items, without changing the number of buckets.
+   void clear ();
+
+   unsigned size () const { return _size; }
+   unsigned buckets () const { return _buckets; }
+   unsigned capacity () const { return _buckets * _ways; }   ///< number of slots (not counting the stash)
+   float load () const { return float(_size) / float(capacity()); }
+   unsigned stashed () const { return _stashed; }
+
+   Iterator      iterator      () { return Iterator(*this); }
+   ConstIterator constIterator () const { return ConstIterator(*this); }
+
+// Private Methods
+private:
+   void allocate (unsigned buckets);
+   // Computes the two buckets that an item with the specified hash may live in.
+   void buckets (unsigned hash, unsigned& b1, unsigned& b2) const {
+      unsigned mixed = hash1(hash);
+      b1 = mixed & _mask;
+      b2 = hash1(mixed + 0x9e3779b9) & _mask;
+      if (b2 == b1)
+         b2 ^= 1 & _mask;
+   }
+   template<class KEY> W const* findW (KEY const& key) const;
+   // Puts an item (not already in the set) in one of its buckets or the stash.
+   bool place (unsigned hash, W const& item);
+   // Tries to put the item in a free slot of one of its buckets.
+   bool placeFree (unsigned hash, W const& item);
+   // Doubles the number of buckets (or more, if the items don't fit in twice as many).
+   void grow ();
+   // Moves everything into a table with the specified number of buckets. Returns false if they don't fit.
+   bool rebuild (unsigned buckets);
+   void tooManyCollisions (unsigned buckets) const;
+   W& stashItem (unsigned i) { return *reinterpret_cast<W*>(_stash[i]); }
+   W const& stashItem (unsigned i) const { return *reinterpret_cast<W const*>(_stash[i]); }
+};
+
+
+//==============================================================================
+// Public Methods
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Constructor
+template<class ITEM>
+CuckooHashSet<ITEM>::CuckooHashSet (unsigned initialCapacity, float maxLoad)
+: _memory(0), _bucket(0), _buckets(0), _mask(0), _size(0), _maxLoad(maxLoad), _stashed(0), _kicks(0)
+{
+   if (0.0 >= _maxLoad or _maxLoad > 1.0) {
+      throw("Error from CuckooHashSet constructor: maxLoad must be between 0 and 1.\n");
+   }
+   // enough buckets for initialCapacity items at maxLoad, rounded up to a power of two
+   unsigned buckets = 2;
+   while (buckets * _ways * _maxLoad < initialCapacity)
+      buckets <<= 1;
+   allocate(buckets);
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+template<class ITEM>
+CuckooHashSet<ITEM>::~CuckooHashSet ()
+{
+   clear();
+   free(_memory);
+}
+
+//------------------------------------------------------------------------------
+// Adds a new item. If the item is already in the set, it returns a reference to the existing item.
+template<class ITEM>
+typename Wrap<ITEM>::Ref CuckooHashSet<ITEM>::add (typename W::Ex item)
+{
+   W const* existing = findW(item);
+   if (existing)
+      return const_cast<W*>(existing)->ref();
+
+   if (_size == _trigger)
+      grow();
+   unsigned hash = cref(item).hash();
+   W w(item);
+   while (!place(hash, w)) {
+      tooManyCollisions(_buckets);
+      grow();
+   }
+   ++_size;
+   // the new item may have been displaced while the others were shuffled around
+   return const_cast<W*>(findW(item))->ref();
+}
+
+//------------------------------------------------------------------------------
+// Returns a pointer to the corresponding item, or a null pointer if the item is not in the set.
+template<class ITEM>
+template<class KEY>
+typename Wrap<ITEM>::CPtr CuckooHashSet<ITEM>::find (KEY const& key) const
+{
+   W const* w = findW(key);
+   return w ? w->cptr() : 0;
+}
+
+//------------------------------------------------------------------------------
+// Removes the corresponding item. Returns false if it wasn't in the set.
+template<class ITEM>
+template<class KEY>
+bool CuckooHashSet<ITEM>::remove (KEY const& key)
+{
+   unsigned hash = cref(key).hash();
+   unsigned b[2];
+   buckets(hash, b[0], b[1]);
+   for (unsigned j=0; j<2; ++j) {
+      Bucket& bucket = _bucket[b[j]];
+      for (unsigned m = bucket.matches(hash); m; m &= m - 1) {
+         unsigned i = __builtin_ctz(m);
+         if (bucket.item(i).cref() == cref(key)) {
+            bucket.item(i).~W();
+            bucket._used &= ~(1u << i);
+            --_size;
+            return true;
+         }
+      }
+   }
+   for (unsigned i=0; i<_stashed; ++i) {
+      if (_stashHash[i] == hash and stashItem(i).cref() == cref(key)) {
+         // move the last stashed item into the hole
+         stashItem(i).~W();
+         --_stashed;
+         if (i != _stashed) {
+            new(_stash[i]) W(stashItem(_stashed));
+            stashItem(_stashed).~W();
+            _stashHash[i] = _stashHash[_stashed];
+         }
+         --_size;
+         return true;
+      }
+   }
+   return false;
+}
+
+//------------------------------------------------------------------------------
+// Removes all items, without changing the number of buckets.
+template<class ITEM>
+void CuckooHashSet<ITEM>::clear ()
+{
+   for (unsigned b=0; b<_buckets; ++b) {
+      for (unsigned i=0; i<_ways; ++i) {
+         if (_bucket[b]._used & (1u << i))
+            _bucket[b].item(i).~W();
+      }
+      _bucket[b]._used = 0;
+   }
+   for (unsigned i=0; i<_stashed; ++i)
+      stashItem(i).~W();
+   _stashed = 0;
+   _size = 0;
+}
+
+
+//==============================================================================
+// Private Methods
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Allocates an empty array of buckets (the old one, if any, must already have been dealt with).
+template<class ITEM>
+void CuckooHashSet<ITEM>::allocate (unsigned buckets)
+{
+   _memory = malloc(buckets * sizeof(Bucket) + _lineBytes);
+   if (!_memory) {
+      throw("Could not allocate memory in CuckooHashSet.");
+   }
+   uintptr_t start = reinterpret_cast<uintptr_t>(_memory);
+   _bucket = reinterpret_cast<Bucket*>((start + _lineBytes - 1) & ~uintptr_t(_lineBytes - 1));
+   _buckets = buckets;
+   _mask = buckets - 1;
+   _trigger = static_cast<unsigned>(_buckets * _ways * _maxLoad);
+   for (unsigned b=0; b<_buckets; ++b)
+      _bucket[b]._used = 0;
+}
+
+//------------------------------------------------------------------------------
+// Returns the Wrap holding the corresponding item, or a null pointer.
+template<class ITEM>
+template<class KEY>
+typename CuckooHashSet<ITEM>::W const* CuckooHashSet<ITEM>::findW (KEY const& key) const
+{
+   unsigned hash = cref(key).hash();
+   unsigned b1, b2;
+   buckets(hash, b1, b2);
+   Bucket const* bucket = &_bucket[b1];
+   // Start loading the second bucket while we search the first.
+   __builtin_prefetch(&_bucket[b2]);
+   for (unsigned m = bucket->matches(hash); m; m &= m - 1) {
+      unsigned i = __builtin_ctz(m);
+      if (bucket->item(i).cref() == cref(key))
+         return &bucket->item(i);
+   }
+   bucket = &_bucket[b2];
+   for (unsigned m = bucket->matches(hash); m; m &= m - 1) {
+      unsigned i = __builtin_ctz(m);
+      if (bucket->item(i).cref() == cref(key))
+         return &bucket->item(i);
+   }
+   for (unsigned i=0; i<_stashed; ++i) {
+      if (_stashHash[i] == hash and stashItem(i).cref() == cref(key))
+         return &stashItem(i);
+   }
+   return 0;
+}
+
+//------------------------------------------------------------------------------
+// Tries to put the item in a free slot of one of its buckets.
+template<class ITEM>
+bool CuckooHashSet<ITEM>::placeFree (unsigned hash, W const& item)
+{
+   unsigned b[2];
+   buckets(hash, b[0], b[1]);
+   for (unsigned j=0; j<2; ++j) {
+      Bucket& bucket = _bucket[b[j]];
+      unsigned freeSlots = ~bucket._used & ((1u << _ways) - 1);
+      if (freeSlots) {
+         unsigned i = __builtin_ctz(freeSlots);
+         new(bucket._slot[i]) W(item);
+         bucket._hash[i] = hash;
+         bucket._used |= 1u << i;
+         return true;
+      }
+   }
+   return false;
+}
+
+//------------------------------------------------------------------------------
+// Puts an item (not already in the set) in one of its buckets or the stash.
+/**
+ * If both of the item's buckets are full, it displaces an item from one of
+ * them, which then goes to its other bucket, and so on (a random walk).
+ * After _maxKicks displacements, whichever item is left over goes in the
+ * stash. If the stash is full too, nothing changes and this returns false.
+ */
+template<class ITEM>
+bool CuckooHashSet<ITEM>::place (unsigned hash, W const& item)
+{
+   if (placeFree(hash, item))
+      return true;
+   if (_stashed == _stashSize)
+      return false;
+
+   W carried(item);
+   unsigned b1, b2;
+   buckets(hash, b1, b2);
+   unsigned b = (_kicks & 1) ? b2 : b1;
+   for (unsigned kick=0; kick<_maxKicks; ++kick) {
+      // swap the carried item with one in bucket b
+      Bucket& bucket = _bucket[b];
+      unsigned i = (++_kicks + hash) & (_ways - 1);
+      W displaced(bucket.item(i));
+      unsigned displacedHash = bucket._hash[i];
+      bucket.item(i) = carried;
+      bucket._hash[i] = hash;
+      carried = displaced;
+      hash = displacedHash;
+
+      // the displaced item goes to its other bucket
+      buckets(hash, b1, b2);
+      if (placeFree(hash, carried))
+         return true;
+      b = (b == b1) ? b2 : b1;
+   }
+
+   new(_stash[_stashed]) W(carried);
+   _stashHash[_stashed] = hash;
+   ++_stashed;
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Doubles the number of buckets (or more, if the items don't fit in twice as many).
+template<class ITEM>
+void CuckooHashSet<ITEM>::grow ()
+{
+   unsigned buckets = _buckets << 1;
+   while (!rebuild(buckets)) {
+      buckets <<= 1;
+      tooManyCollisions(buckets);
+   }
+}
+
+//------------------------------------------------------------------------------
+// Moves everything into a table with the specified number of buckets.
+/**
+ * Items are copied into the new table (their stored hashes are reused, so
+ * ITEM::hash isn't called). If some item can't be placed, the new table is
+ * thrown away, nothing changes, and this returns false.
+ */
+template<class ITEM>
+bool CuckooHashSet<ITEM>::rebuild (unsigned newBuckets)
+{
+   void* oldMemory = _memory;
+   Bucket* oldBucket = _bucket;
+   unsigned oldBuckets = _buckets;
+   unsigned oldStashed = _stashed;
+   unsigned oldStashHash[_stashSize];
+   alignas(W) unsigned char oldStash[_stashSize][sizeof(W)];
+   for (unsigned i=0; i<_stashed; ++i) {
+      new(oldStash[i]) W(stashItem(i));
+      stashItem(i).~W();
+      oldStashHash[i] = _stashHash[i];
+   }
+
+   allocate(newBuckets);
+   _stashed = 0;
+   bool placed = true;
+   for (unsigned b=0; placed and b<oldBuckets; ++b) {
+      for (unsigned i=0; placed and i<_ways; ++i) {
+         if (oldBucket[b]._used & (1u << i))
+            placed = place(oldBucket[b]._hash[i], oldBucket[b].item(i));
+      }
+   }
+   for (unsigned i=0; placed and i<oldStashed; ++i)
+      placed = place(oldStashHash[i], *reinterpret_cast<W*>(oldStash[i]));
+
+   if (placed) {
+      // the originals are no longer needed
+      std::swap(_memory, oldMemory);
+      std::swap(_bucket, oldBucket);
+      std::swap(_buckets, oldBuckets);
+   }
+   // destroy whichever table we aren't keeping (and put the old stash back if we are keeping the old table)
+   unsigned newStashed = _stashed;
+   for (unsigned b=0; b<_buckets; ++b) {
+      for (unsigned i=0; i<_ways; ++i) {
+         if (_bucket[b]._used & (1u << i))
+            _bucket[b].item(i).~W();
+      }
+   }
+   if (!placed) {
+      for (unsigned i=0; i<newStashed; ++i)
+         stashItem(i).~W();
+   }
+   for (unsigned i=0; i<oldStashed; ++i) {
+      if (!placed) {
+         new(_stash[i]) W(*reinterpret_cast<W*>(oldStash[i]));
+         _stashHash[i] = oldStashHash[i];
+      }
+      reinterpret_cast<W*>(oldStash[i])->~W();
+   }
+   free(_memory);
+
+   _memory = oldMemory;
+   _bucket = oldBucket;
+   _buckets = oldBuckets;
+   _mask = _buckets - 1;
+   _trigger = static_cast<unsigned>(_buckets * _ways * _maxLoad);
+   _stashed = placed ? newStashed : oldStashed;
+   return placed;
+}
+
+//------------------------------------------------------------------------------
+// Throws if items don't fit even though less than half the slots would be used.
+/**
+ * With any reasonable hash function this never happens. But no more than
+ * 2 * 4 + 8 items with exactly the same hash can ever be stored, so with a
+ * very poor one, doubling the table would go on forever.
+ */
+template<class ITEM>
+void CuckooHashSet<ITEM>::tooManyCollisions (unsigned buckets) const
+{
+   if (_size < buckets * _ways / 2) {
+      throw("Error from CuckooHashSet: too many items have the same hash.\n");
+   }
+}
+
+
+//==============================================================================
+// Iterator Methods
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Advances _bucket and _slot until they point to an item (or past the end of the stash).
+template<class ITEM>
+void CuckooHashSet<ITEM>::ConstIterator::findUsedSlot ()
+{
+   while (_bucket < _set->_buckets) {
+      unsigned remaining = _set->_bucket[_bucket]._used >> _slot;
+      if (_slot < _ways and remaining) {
+         _slot += __builtin_ctz(remaining);
+         return;
+      }
+      ++_bucket;
+      _slot = 0;
+   }
+}
+
+
+#endif // ESTDLIB_CUCKOO_HASH_SET
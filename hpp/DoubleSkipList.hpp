@@ -3,7 +3,9 @@
 
 #include <iostream>
 #include <cstdlib>
-#include "MemoryPool.h"
+#include <cstring>
+#include "MemoryPoolF.h"
+#include "SkipListStats.hpp"
 
 
 //==============================================================================
@@ -12,12 +14,23 @@
 /**
  * It stores pointers to arbitrary ITEMs.
  *
- * Need description of memory layout!
+ * Links are allocated from one MemoryPoolF per lane count, and removed Links
+ * are freed back to it to be reused (as in SkipList).
+ *
+ * Express lanes record their widths, so ITEMs can be found by index (at) and
+ * counted below a key (rank) in O(log n), as in SkipList.
+ *
+ * The last Link in each lane is kept too, so the first and last ITEMs can be
+ * taken off (popFront, popBack) without a search, and an ITEM can be moved
+ * to its new place after its key changes (relink). That makes it an indexed
+ * priority queue, where the Iterators returned by add are the handles.
+ *
+ * STATS counts the costs of searches, as for SkipList (see SkipListStats.hpp).
  *
  * Should be Wrapped!
  */
 
-template<class ITEM>
+template<class ITEM, class STATS = NoSkipListStats>
 class DoubleSkipList {
 //------------------------------------------------------------------------------
 // SubClasses
@@ -26,14 +39,20 @@ private:
    struct Link {
       ITEM* item;
       Link* prev;
+      unsigned lanes; ///< lanes allocated (it is linked into at most this many)
+      unsigned linked; ///< lanes it is linked into (fewer than lanes once a lane has been dropped)
       Link* next; // this is really the first item in an array of pointers to Links
-      // express lanes go here
+      // express lanes go here, followed by their widths
       
       Link*& nextInLane (unsigned lane) { return (&next)[lane]; }
       Link* const& nextInLane (unsigned lane) const { return (&next)[lane]; }
+      // Places from this Link to the next one in an express lane (lane > 0), or to size()+1 if there is none.
+      unsigned& widthInLane (unsigned lane) { return reinterpret_cast<unsigned*>(&next + lanes)[lane-1]; }
+      unsigned widthInLane (unsigned lane) const { return reinterpret_cast<unsigned const*>(&next + lanes)[lane-1]; }
+      unsigned width (unsigned lane) const { return lane ? widthInLane(lane) : 1; }
       // Returns the amount of extra memory required for a Link with the specified number of lanes.
       // This much memory must be placed immediately after the Link itself.
-      static unsigned footprint (unsigned lanes) { return sizeof(Link) + (lanes-1)*sizeof(Link*); }
+      static unsigned footprint (unsigned lanes) { return sizeof(Link) + (lanes-1)*(sizeof(Link*) + sizeof(unsigned)); }
    };
 
 public:
@@ -84,19 +103,23 @@ public:
 //------------------------------------------------------------------------------
 // Member data
 private:
-   MemoryPool* _pool;   ///< memory pool where links are created
+   MemoryPoolF** _pools;   ///< _pools[i] holds the Links with i+1 lanes (_classes long array)
+   unsigned _classes;   ///< number of pools (the most lanes the DoubleSkipList has had)
    unsigned _lanes;     ///< Number of lanes (starts at 1). Every Link links to lane 0.
    Link* _head;         ///< Points to dummy link at head of the list.
+   Link** _tails;       ///< the last Link in each lane, or _head if it is empty (_lanes long array)
    /// number of items in each lane (_lanes long array)
    /** Note that _items[0] is the total number of items in the DoubleSkipList. */
    unsigned* _items;
    double _linkProb;    ///< probability of new entry linking to lane n is _linkProb^n
    double _trigger;     ///< new lane is added when _items[0] exceeds _trigger == 1/(_linkProb^_lanes)
+   mutable STATS _stats; ///< counts the costs of searches (see SkipListStats.hpp)
    
    // Working Memory
    /// Points to last Links visited in each lane. Used for insertions.
    /** This should be pulled off the stack when needed, not stored here. */
    Link** _lastStops;
+   unsigned* _lastRanks; ///< index+1 of each of _lastStops (0 for _head)
    
 //------------------------------------------------------------------------------
 // Interface
@@ -107,6 +130,24 @@ public:
    /// Adds a new ITEM to the DoubleSkipList.
    Iterator add (ITEM& item);
    Iterator add (ITEM* item);
+   /// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+   template<class KEY> bool remove (KEY const& key);
+   /// Removes the ITEM itr points to, and returns an Iterator to the ITEM after it.
+   Iterator remove (Iterator itr);
+   /// Moves the ITEM itr points to to its place after its key has changed, and returns an Iterator to it.
+   Iterator relink (Iterator itr);
+   /// Removes the first ITEM and returns it, or 0 if the DoubleSkipList is empty.
+   ITEM* popFront ();
+   /// Removes the last ITEM and returns it, or 0 if the DoubleSkipList is empty.
+   ITEM* popBack ();
+   /// Removes the ITEM at index (counting from 0). Returns false if there isn't one.
+   bool erase (unsigned index);
+
+   /// Returns an Iterator to the ITEM at index (counting from 0), or an invalid one if there isn't one.
+   Iterator at (unsigned index);
+   ConstIterator at (unsigned index) const;
+   /// Returns the number of ITEMs less than key (the index of the first one not less).
+   template<class KEY> unsigned rank (KEY const& key) const;
 
    /// Attempts to find an ITEM in the DoubleSkipList with the specified KEY.
    template<class KEY> Iterator find (KEY const& key);
@@ -126,7 +167,10 @@ public:
    Iterator begin ();
    /// Returns a ConstIterator to the first ITEM in the DoubleSkipList.
    ConstIterator constBegin () const;
-//      Iterator end ();        ///< Returns an Iterator to the last ITEM in the DoubleSkipList.
+   /// Returns an Iterator to the last ITEM in the DoubleSkipList.
+   Iterator end ();
+   /// Returns a ConstIterator to the last ITEM in the DoubleSkipList.
+   ConstIterator constEnd () const;
    
    // Profiling methods
    unsigned size () const; ///< Returns the number of items in the DoubleSkipList.
@@ -134,12 +178,29 @@ public:
 // Private Methods
 private:
    void resize ();
+   void shrink ();
+   void sizePools ();
+   /// Fills _lastStops with the last Link before key in each lane.
+   template<class KEY> void findLastStops (KEY const& key);
+   /// Fills _lastStops with the last Link before place (index+1) in each lane.
+   void findLastStopsAt (unsigned place);
+   /// Returns the Link at place (index+1), or _head for 0.
+   Link* linkAt (unsigned place) const;
+   /// Returns the place (index+1) of link, found by running from it to the end of the list.
+   unsigned placeOf (Link const* link) const;
+   /// Links link into its first link->linked lanes, at its ITEM's place. _items[0] must already count it.
+   void attach (Link* link);
+   /// Takes link (at place, its index+1) out of every lane. _lastStops must be found first.
+   void detach (Link* link, unsigned place);
+   void unlink (Link* link, unsigned place);
    unsigned chooseNewLanes () const;
    
 // Debug Methods
 public:
    void printStats () const;
    void print () const;
+   /// Returns the STATS policy, which has counted the costs of the operations so far.
+   STATS& stats () const { return _stats; }
 };
 
 
@@ -150,8 +211,8 @@ public:
 
 //------------------------------------------------------------------------------
 // Constructor
-template<class ITEM>
-inline DoubleSkipList<ITEM>::DoubleSkipList (unsigned initialCapacity, double linkProb)
+template<class ITEM, class STATS>
+inline DoubleSkipList<ITEM, STATS>::DoubleSkipList (unsigned initialCapacity, double linkProb)
    : _lanes(1), _linkProb(linkProb), _trigger(1.0/linkProb)
 {
    // Ensure linkProb is valid.
@@ -159,69 +220,112 @@ inline DoubleSkipList<ITEM>::DoubleSkipList (unsigned initialCapacity, double li
       throw("Error from DoubleSkipList constructor: linkProb must be between 0 and 1.\n");
    }
 
-   // Find the right number of lanes to start out with,
-   // and calculate how much memory we expect these lanes to take up.
+   // Find the right number of lanes to start out with.
    double inverseLinkProb = 1.0/_linkProb;
-   double compoundedLinkProb = _linkProb;
-   double probSum = 0;
    while (initialCapacity > static_cast<unsigned>(_trigger)) {
       ++_lanes;
       _trigger *= inverseLinkProb;
-      probSum += compoundedLinkProb;
-      compoundedLinkProb *= _linkProb;
    }
-   unsigned linkMemory = static_cast<unsigned>( static_cast<double>(initialCapacity)*probSum ) * sizeof(Link*);
-   _pool = new MemoryPool(initialCapacity*sizeof(Link) + linkMemory, sizeof(ITEM*));
+
+   // Set up a MemoryPoolF for each number of lanes.
+   _classes = _lanes;
+   _pools = static_cast<MemoryPoolF**> (malloc(_classes * sizeof(MemoryPoolF*)));
+   for (unsigned i=0; i<_classes; ++i) {
+      _pools[i] = new MemoryPoolF;
+      _pools[i]->setItemSize(Link::footprint(i+1), alignof(Link));
+      _pools[i]->setMinFree(1);
+   }
+   sizePools();
 
    // Allocate other members.
    _head      = static_cast<Link*>     (calloc(1, Link::footprint(_lanes)));
+   _tails     = static_cast<Link**>    (malloc(_lanes * sizeof(Link*)));
    _lastStops = static_cast<Link**>    (calloc(_lanes, sizeof(Link*)));
+   _lastRanks = static_cast<unsigned*> (calloc(_lanes, sizeof(unsigned)));
    _items     = static_cast<unsigned*> (calloc(_lanes, sizeof(unsigned)));
+   _head->lanes = _lanes;
+   _head->linked = _lanes;
+   for (unsigned i=1; i<_lanes; ++i)
+      _head->widthInLane(i) = 1;
+   for (unsigned i=0; i<_lanes; ++i)
+      _tails[i] = _head;
 }
 
 //------------------------------------------------------------------------------
 // Destructor
-template<class ITEM>
-inline DoubleSkipList<ITEM>::~DoubleSkipList ()
+template<class ITEM, class STATS>
+inline DoubleSkipList<ITEM, STATS>::~DoubleSkipList ()
 {
    free(_head);
+   free(_tails);
    free(_lastStops);
+   free(_lastRanks);
    free(_items);
-   delete _pool;
+   for (unsigned i=0; i<_classes; ++i)
+      delete _pools[i];
+   free(_pools);
 }
 
 //------------------------------------------------------------------------------
 // Adds an item.
-template<class ITEM>
-inline typename DoubleSkipList<ITEM>::Iterator DoubleSkipList<ITEM>::add (ITEM* item)
+template<class ITEM, class STATS>
+inline typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::add (ITEM* item)
 {
    return add(*item);
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to the first ITEM in the DoubleSkipList.
-template<class ITEM>
-inline typename DoubleSkipList<ITEM>::Iterator DoubleSkipList<ITEM>::begin ()
+template<class ITEM, class STATS>
+inline typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::begin ()
 {
    return Iterator(_head->next);
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to the first ITEM in the DoubleSkipList.
-template<class ITEM>
-inline typename DoubleSkipList<ITEM>::ConstIterator DoubleSkipList<ITEM>::constBegin () const
+template<class ITEM, class STATS>
+inline typename DoubleSkipList<ITEM, STATS>::ConstIterator DoubleSkipList<ITEM, STATS>::constBegin () const
 {
    return ConstIterator(_head->next);
 }
 
 //------------------------------------------------------------------------------
-//Returns an Iterator to the last ITEM in the DoubleSkipList.
-// Implement Me! //
+// Returns an Iterator to the ITEM at index (counting from 0), or an invalid one if there isn't one.
+template<class ITEM, class STATS>
+inline typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::at (unsigned index)
+{
+   return Iterator(index < _items[0] ? linkAt(index + 1) : 0);
+}
+
+//------------------------------------------------------------------------------
+// Returns a ConstIterator to the ITEM at index (counting from 0), or an invalid one if there isn't one.
+template<class ITEM, class STATS>
+inline typename DoubleSkipList<ITEM, STATS>::ConstIterator DoubleSkipList<ITEM, STATS>::at (unsigned index) const
+{
+   return ConstIterator(index < _items[0] ? linkAt(index + 1) : 0);
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to the last ITEM in the DoubleSkipList.
+template<class ITEM, class STATS>
+inline typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::end ()
+{
+   return Iterator(_tails[0] != _head ? _tails[0] : 0);
+}
+
+//------------------------------------------------------------------------------
+// Returns a ConstIterator to the last ITEM in the DoubleSkipList.
+template<class ITEM, class STATS>
+inline typename DoubleSkipList<ITEM, STATS>::ConstIterator DoubleSkipList<ITEM, STATS>::constEnd () const
+{
+   return ConstIterator(_tails[0] != _head ? _tails[0] : 0);
+}
 
 //------------------------------------------------------------------------------
 // Returns the number of items in the DoubleSkipList.
-template<class ITEM>
-inline unsigned DoubleSkipList<ITEM>::size () const
+template<class ITEM, class STATS>
+inline unsigned DoubleSkipList<ITEM, STATS>::size () const
 {
    return _items[0];
 }
@@ -233,8 +337,8 @@ inline unsigned DoubleSkipList<ITEM>::size () const
 
 //------------------------------------------------------------------------------
 // Adds an ITEM to the DoubleSkipList.
-template<class ITEM>
-typename DoubleSkipList<ITEM>::Iterator DoubleSkipList<ITEM>::add (ITEM& item)
+template<class ITEM, class STATS>
+typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::add (ITEM& item)
 {
    unsigned newLanes;
 
@@ -246,176 +350,360 @@ typename DoubleSkipList<ITEM>::Iterator DoubleSkipList<ITEM>::add (ITEM& item)
       newLanes = chooseNewLanes(); // Otherwise choose a random number of express lanes to link to.
    }
    
-   // Incremement lane counts for each express lane used by the new Link. (We already incremented _item[0].)
-   for (unsigned i=1; i<newLanes; ++i)
+   // Allocate memory for new Link.
+   Link* newLink = static_cast<Link*>( _pools[newLanes-1]->alloc() );
+   newLink->lanes = newLanes;
+   newLink->linked = newLanes;
+   newLink->item = &item;
+   attach(newLink);
+   _stats.added();
+   
+   // Return an Iterator pointing to the new Link.
+   return Iterator(newLink);
+}
+
+//------------------------------------------------------------------------------
+// Links link into its first link->linked lanes, at its ITEM's place. _items[0] must already count it.
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::attach (Link* link)
+{
+   // Incremement lane counts for each express lane used by the Link.
+   for (unsigned i=1; i<link->linked; ++i)
       ++_items[i];
    
-   // Find where to insert the new item, remembering where we have to change lanes (using _lastStops).
+   // Find where to insert the item, remembering where we have to change lanes (using _lastStops).
+   findLastStops(*(link->item));
+   
+   // Link in all forward pointing pointers of the Link, splitting the widths of the lanes it is in.
+   unsigned place = _lastRanks[0] + 1;
+   for (unsigned lane=0; lane < link->linked; ++lane) {
+      Link* stop = _lastStops[lane];
+      link->nextInLane(lane) = stop->nextInLane(lane);
+      stop->nextInLane(lane) = link;
+      if (!link->nextInLane(lane))
+         _tails[lane] = link;
+      if (lane) {
+         unsigned before = place - _lastRanks[lane];
+         link->widthInLane(lane) = stop->widthInLane(lane) + 1 - before;
+         stop->widthInLane(lane) = before;
+      }
+   }
+   // The lanes above it pass over one more place.
+   for (unsigned lane = link->linked; lane < _lanes; ++lane)
+      ++_lastStops[lane]->widthInLane(lane);
+   
+   // Set the prev pointers.
+   if (link->next)
+      link->next->prev = link;
+   link->prev = _lastStops[0];
+}
+
+//------------------------------------------------------------------------------
+// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+template<class ITEM, class STATS>
+template<class KEY>
+bool DoubleSkipList<ITEM, STATS>::remove (KEY const& key)
+{
+   findLastStops(key);
+   Link* link = _lastStops[0]->next;
+   if (!link or !(*(link->item) == key)) {
+      _stats.removed();
+      return false;
+   }
+   unlink(link, _lastRanks[0] + 1);
+   _stats.removed();
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Removes the ITEM itr points to, and returns an Iterator to the ITEM after it.
+/**
+ * Iterators to other ITEMs remain valid. The Link is found by its place
+ * rather than its key, so this takes O(log n) however many equal ITEMs there
+ * are, and works on an ITEM whose key has been changed.
+ */
+template<class ITEM, class STATS>
+typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::remove (Iterator itr)
+{
+   Link* link = itr._current;
+   Link* next = link->next;
+   unsigned place = placeOf(link);
+   findLastStopsAt(place);
+   unlink(link, place);
+   _stats.removed();
+   return Iterator(next);
+}
+
+//------------------------------------------------------------------------------
+// Moves the ITEM itr points to to its place after its key has changed, and returns an Iterator to it.
+/**
+ * An ITEM that is still in order is left where it is. Otherwise its Link is
+ * taken out and put back in at the new place, keeping its lanes, so nothing
+ * is freed or allocated and itr stays valid.
+ */
+template<class ITEM, class STATS>
+typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::relink (Iterator itr)
+{
+   Link* link = itr._current;
+   ITEM* item = link->item;
+   if ((link->prev == _head or !(*item < *(link->prev->item))) and (!link->next or !(*(link->next->item) < *item)))
+      return itr;
+   unsigned place = placeOf(link);
+   findLastStopsAt(place);
+   detach(link, place);
+   ++_items[0];
+   attach(link);
+   _stats.added();
+   return itr;
+}
+
+//------------------------------------------------------------------------------
+// Removes the first ITEM and returns it, or 0 if the DoubleSkipList is empty.
+/**
+ * The last stop before it in every lane is _head.
+ */
+template<class ITEM, class STATS>
+ITEM* DoubleSkipList<ITEM, STATS>::popFront ()
+{
+   Link* link = _head->next;
+   if (!link)
+      return 0;
+   ITEM* item = link->item;
+   for (unsigned lane=0; lane<_lanes; ++lane) {
+      _lastStops[lane] = _head;
+      _lastRanks[lane] = 0;
+   }
+   unlink(link, 1);
+   _stats.removed();
+   return item;
+}
+
+//------------------------------------------------------------------------------
+// Removes the last ITEM and returns it, or 0 if the DoubleSkipList is empty.
+/**
+ * The last stop in each lane the Link isn't in is that lane's tail, whose
+ * width reaches size()+1. Only in the few lanes it is in does the stop have
+ * to be found, going along from the stop in the lane above.
+ */
+template<class ITEM, class STATS>
+ITEM* DoubleSkipList<ITEM, STATS>::popBack ()
+{
+   Link* link = _tails[0];
+   if (link == _head)
+      return 0;
+   ITEM* item = link->item;
+   unsigned place = _items[0];
+
    unsigned lane = _lanes-1;
-   _lastStops[lane] = _head;
+   unsigned rank = 0;
+   Link* stop = _head;
    while (true) {
-      while (_lastStops[lane]->nextInLane(lane) and *(_lastStops[lane]->nextInLane(lane)->item) < item) {
-         _lastStops[lane] = _lastStops[lane]->nextInLane(lane);
+      if (_tails[lane] != link) {
+         stop = _tails[lane];
+         rank = place + 1 - stop->width(lane);
+      } else {
+         while (stop->nextInLane(lane) != link) {
+            rank += stop->width(lane);
+            stop = stop->nextInLane(lane);
+            _stats.step();
+         }
       }
+      _lastStops[lane] = stop;
+      _lastRanks[lane] = rank;
 
       if (lane == 0) {
          break;
       } else {
-         _lastStops[lane-1] = _lastStops[lane];
          --lane;
+         _stats.drop();
       }
    }
-   
-   // Allocate memory for new Link.
-   Link* newLink = static_cast<Link*>( _pool->alloc(Link::footprint(newLanes)) );
-   
-   // Link in all forward pointing pointers of the new Link. (Note that lane == 0 at this point.)
-   while (lane < newLanes) {
-      newLink->nextInLane(lane) = _lastStops[lane]->nextInLane(lane);
-      _lastStops[lane]->nextInLane(lane) = newLink;
-      ++lane;
+   unlink(link, place);
+   _stats.removed();
+   return item;
+}
+
+//------------------------------------------------------------------------------
+// Removes the ITEM at index (counting from 0). Returns false if there isn't one.
+template<class ITEM, class STATS>
+bool DoubleSkipList<ITEM, STATS>::erase (unsigned index)
+{
+   if (index >= _items[0])
+      return false;
+   findLastStopsAt(index + 1);
+   unlink(_lastStops[0]->next, index + 1);
+   _stats.removed();
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Returns the number of ITEMs less than key (the index of the first one not less).
+template<class ITEM, class STATS>
+template<class KEY>
+unsigned DoubleSkipList<ITEM, STATS>::rank (KEY const& key) const
+{
+   unsigned lane = _lanes-1;
+   unsigned rank = 0;
+   Link const* currentLink = _head;
+   while (true) {
+      while (currentLink->nextInLane(lane) and *(currentLink->nextInLane(lane)->item) < key) {
+         rank += currentLink->width(lane);
+         currentLink = currentLink->nextInLane(lane);
+         _stats.step();
+      }
+      if (lane == 0) {
+         break;
+      } else {
+         --lane;
+         _stats.drop();
+      }
    }
-   
-   // Set prev and item pointers of the new Link.
-   if (newLink->next)
-      newLink->next->prev = newLink;
-   newLink->prev = _lastStops[0];
-   newLink->item = &item;
-   
-   // Return an Iterator pointing to the new Link.
-   return Iterator(newLink);
+   _stats.found();
+   return rank;
 }
 
 //------------------------------------------------------------------------------
 // Attempts to find an ITEM in the DoubleSkipList with the specified KEY.
-template<class ITEM>
+template<class ITEM, class STATS>
 template<class KEY>
-typename DoubleSkipList<ITEM>::Iterator DoubleSkipList<ITEM>::find (KEY const& key)
+typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::find (KEY const& key)
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and *(currentLink->nextInLane(lane)->item) < key) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return Iterator( (currentLink->next and *(currentLink->next->item) == key) ? currentLink->next : 0 );
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY.
-template<class ITEM>
+template<class ITEM, class STATS>
 template<class KEY>
-typename DoubleSkipList<ITEM>::Iterator DoubleSkipList<ITEM>::findLow (KEY const& key)
+typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::findLow (KEY const& key)
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and *(currentLink->nextInLane(lane)->item) < key) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return Iterator( currentLink->next and *(currentLink->next->item) == key ? currentLink->next : currentLink );
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY.
-template<class ITEM>
+template<class ITEM, class STATS>
 template<class KEY>
-typename DoubleSkipList<ITEM>::Iterator DoubleSkipList<ITEM>::findHigh (KEY const& key)
+typename DoubleSkipList<ITEM, STATS>::Iterator DoubleSkipList<ITEM, STATS>::findHigh (KEY const& key)
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and *(currentLink->nextInLane(lane)->item) < key) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return Iterator( currentLink->next );
 }
 
 
 //------------------------------------------------------------------------------
 // Attempts to find an ITEM in the DoubleSkipList with the specified KEY.
-template<class ITEM>
+template<class ITEM, class STATS>
 template<class KEY>
-typename DoubleSkipList<ITEM>::ConstIterator DoubleSkipList<ITEM>::find (KEY const& key) const
+typename DoubleSkipList<ITEM, STATS>::ConstIterator DoubleSkipList<ITEM, STATS>::find (KEY const& key) const
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and *(currentLink->nextInLane(lane)->item) < key) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return ConstIterator( (currentLink->next and *(currentLink->next->item) == key) ? currentLink->next : 0 );
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY.
-template<class ITEM>
+template<class ITEM, class STATS>
 template<class KEY>
-typename DoubleSkipList<ITEM>::ConstIterator DoubleSkipList<ITEM>::findLow (KEY const& key) const
+typename DoubleSkipList<ITEM, STATS>::ConstIterator DoubleSkipList<ITEM, STATS>::findLow (KEY const& key) const
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and *(currentLink->nextInLane(lane)->item) < key) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return ConstIterator( currentLink->next and *(currentLink->next->item) == key ? currentLink->next : currentLink );
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY.
-template<class ITEM>
+template<class ITEM, class STATS>
 template<class KEY>
-typename DoubleSkipList<ITEM>::ConstIterator DoubleSkipList<ITEM>::findHigh (KEY const& key) const
+typename DoubleSkipList<ITEM, STATS>::ConstIterator DoubleSkipList<ITEM, STATS>::findHigh (KEY const& key) const
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and *(currentLink->nextInLane(lane)->item) < key) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return ConstIterator( currentLink->next );
 }
 
@@ -427,8 +715,8 @@ typename DoubleSkipList<ITEM>::ConstIterator DoubleSkipList<ITEM>::findHigh (KEY
  * No extra lanes are added to existing items; it simply becomes possible for
  * new links to be formed with the new lane.
  */
-template<class ITEM>
-void DoubleSkipList<ITEM>::resize ()
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::resize ()
 {
    // Change state members.
    ++_lanes;
@@ -436,27 +724,241 @@ void DoubleSkipList<ITEM>::resize ()
 
    // Allocate new memory.
    Link*     newHead      = static_cast<Link*>     (malloc(Link::footprint(_lanes)));
+   Link**    newTails     = static_cast<Link**>    (malloc(_lanes * sizeof(Link*)));
    Link**    newLastStops = static_cast<Link**>    (malloc(_lanes * sizeof(Link*)));
+   unsigned* newLastRanks = static_cast<unsigned*> (malloc(_lanes * sizeof(unsigned)));
    unsigned* newItems     = static_cast<unsigned*> (malloc(_lanes * sizeof(unsigned)));
 
-   // Fill new memory.
+   // Fill new memory. The new lane spans the whole list: one more place than
+   // there are Links in the lane below.
+   newHead->item = 0;
+   newHead->prev = 0;
+   newHead->lanes = _lanes;
+   newHead->linked = _lanes;
+   unsigned width = 0;
+   for (Link* link = _head; link; link = link->nextInLane(_lanes-2))
+      width += link->width(_lanes-2);
+   for (unsigned i=0; i<_lanes-1; ++i) {
+      newHead->nextInLane(i) = _head->nextInLane(i);
+      if (i)
+         newHead->widthInLane(i) = _head->widthInLane(i);
+   }
    newHead->nextInLane(_lanes-1) = 0;
-   memcpy(newHead, _head, Link::footprint(_lanes-1));
+   newHead->widthInLane(_lanes-1) = width;
+   for (unsigned i=0; i<_lanes-1; ++i)
+      newTails[i] = _tails[i] != _head ? _tails[i] : newHead;
+   newTails[_lanes-1] = newHead;
    newItems[_lanes-1] = 0;
    memcpy(newItems, _items, (_lanes-1)*sizeof(unsigned));
 
    // Free old memory, swap in new memory.
    free(_head);
+   free(_tails);
    free(_lastStops);
+   free(_lastRanks);
    free(_items);
    _head = newHead;
+   _tails = newTails;
    _lastStops = newLastStops;
+   _lastRanks = newLastRanks;
    _items = newItems;
+   if (_head->next)
+      _head->next->prev = _head;
+
+   // Add a pool for Links with the new number of lanes (unless one is left from before a shrink).
+   if (_lanes > _classes) {
+      _pools = static_cast<MemoryPoolF**> (realloc(_pools, _lanes * sizeof(MemoryPoolF*)));
+      _pools[_classes] = new MemoryPoolF;
+      _pools[_classes]->setItemSize(Link::footprint(_lanes), alignof(Link));
+      _pools[_classes]->setMinFree(1);
+      ++_classes;
+   }
+   sizePools();
+}
+
+//------------------------------------------------------------------------------
+// Drops the top express lane.
+/**
+ * The Links in the top lane are left as they are; they just aren't reached
+ * through it any more (see SkipList::shrink). They do stop counting it as
+ * one they are linked into.
+ */
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::shrink ()
+{
+   for (Link* link = _head->nextInLane(_lanes-1); link; link = link->nextInLane(_lanes-1))
+      --link->linked;
+   --_lanes;
+   _trigger *= _linkProb;
+   sizePools();
+}
+
+//------------------------------------------------------------------------------
+// Tells each pool how many Links to make room for when it next runs out.
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::sizePools ()
+{
+   double expected = _trigger;
+   for (unsigned i=0; i<_lanes; ++i) {
+      double links = i+1 < _lanes ? expected * (1.0 - _linkProb) : expected;
+      _pools[i]->setNextBlockSize(links < 16.0 ? 16 : static_cast<unsigned>(links));
+      expected *= _linkProb;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Fills _lastStops with the last Link before key in each lane.
+template<class ITEM, class STATS>
+template<class KEY>
+void DoubleSkipList<ITEM, STATS>::findLastStops (KEY const& key)
+{
+   unsigned lane = _lanes-1;
+   unsigned rank = 0;
+   Link* stop = _head;
+   while (true) {
+      while (stop->nextInLane(lane) and *(stop->nextInLane(lane)->item) < key) {
+         rank += stop->width(lane);
+         stop = stop->nextInLane(lane);
+         _stats.step();
+      }
+      _lastStops[lane] = stop;
+      _lastRanks[lane] = rank;
+
+      if (lane == 0) {
+         break;
+      } else {
+         --lane;
+         _stats.drop();
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Fills _lastStops with the last Link before place (index+1) in each lane.
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::findLastStopsAt (unsigned place)
+{
+   unsigned lane = _lanes-1;
+   unsigned rank = 0;
+   Link* stop = _head;
+   while (true) {
+      while (rank + stop->width(lane) < place) {
+         rank += stop->width(lane);
+         stop = stop->nextInLane(lane);
+         _stats.step();
+      }
+      _lastStops[lane] = stop;
+      _lastRanks[lane] = rank;
+
+      if (lane == 0) {
+         break;
+      } else {
+         --lane;
+         _stats.drop();
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Returns the Link at place (index+1), or _head for 0.
+template<class ITEM, class STATS>
+typename DoubleSkipList<ITEM, STATS>::Link* DoubleSkipList<ITEM, STATS>::linkAt (unsigned place) const
+{
+   unsigned lane = _lanes-1;
+   unsigned rank = 0;
+   Link* currentLink = _head;
+   while (true) {
+      while (rank + currentLink->width(lane) <= place) {
+         rank += currentLink->width(lane);
+         currentLink = currentLink->nextInLane(lane);
+         _stats.step();
+      }
+      if (lane == 0) {
+         break;
+      } else {
+         --lane;
+         _stats.drop();
+      }
+   }
+   _stats.found();
+   return currentLink;
+}
+
+//------------------------------------------------------------------------------
+// Returns the place (index+1) of link, found by running from it to the end of the list.
+/**
+ * Going along the top lane of each Link reached only ever climbs, so this
+ * takes O(log n) steps, as a search does, without comparing any ITEMs.
+ */
+template<class ITEM, class STATS>
+unsigned DoubleSkipList<ITEM, STATS>::placeOf (Link const* link) const
+{
+   unsigned toEnd = 0;
+   while (true) {
+      unsigned lane = link->linked - 1;
+      toEnd += link->width(lane);
+      if (!link->nextInLane(lane))
+         break;
+      link = link->nextInLane(lane);
+      _stats.step();
+   }
+   return _items[0] + 1 - toEnd;
+}
+
+//------------------------------------------------------------------------------
+// Unlinks link (at place, its index+1) from every lane, and frees it. _lastStops must be found first.
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::unlink (Link* link, unsigned place)
+{
+   detach(link, place);
+   _pools[link->lanes-1]->free(link);
+
+   // Drop the top lane once there are well under as many items as it was added for.
+   if (_lanes > 1 and _items[0] < _trigger * _linkProb * _linkProb)
+      shrink();
+}
+
+//------------------------------------------------------------------------------
+// Takes link (at place, its index+1) out of every lane. _lastStops must be found first.
+/**
+ * Lane 0 is unlinked through prev. The express lanes are searched from their
+ * last stops for the last Link before place (see SkipList::unlink). Links
+ * may have memory for lanes they aren't in (see shrink), so whether link is in
+ * a lane is told by whether that Link's width reaches it.
+ */
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::detach (Link* link, unsigned place)
+{
+   link->prev->next = link->next;
+   if (link->next)
+      link->next->prev = link->prev;
+   else
+      _tails[0] = link->prev;
+   --_items[0];
+
+   for (unsigned lane=1; lane<_lanes; ++lane) {
+      Link* stop = _lastStops[lane];
+      unsigned rank = _lastRanks[lane];
+      while (rank + stop->widthInLane(lane) < place) {
+         rank += stop->widthInLane(lane);
+         stop = stop->nextInLane(lane);
+         _stats.step();
+      }
+      if (rank + stop->widthInLane(lane) == place) {
+         stop->nextInLane(lane) = link->nextInLane(lane);
+         stop->widthInLane(lane) += link->widthInLane(lane) - 1;
+         if (!stop->nextInLane(lane))
+            _tails[lane] = stop;
+         --_items[lane];
+      } else {
+         --stop->widthInLane(lane);
+      }
+   }
 }
 
 //------------------------------------------------------------------------------
-template<class ITEM>
-unsigned DoubleSkipList<ITEM>::chooseNewLanes () const
+template<class ITEM, class STATS>
+unsigned DoubleSkipList<ITEM, STATS>::chooseNewLanes () const
 {
    double random(drand48());
    unsigned newLanes(1);
@@ -478,8 +980,8 @@ unsigned DoubleSkipList<ITEM>::chooseNewLanes () const
 //==============================================================================
 
 //------------------------------------------------------------------------------
-template<class ITEM>
-void DoubleSkipList<ITEM>::printStats () const
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::printStats () const
 {
    std::cout << "DoubleSkipList Stats\n";
    std::cout << "Items: " << _items[0] << "\nLanes: " << _lanes << '\n';
@@ -489,8 +991,8 @@ void DoubleSkipList<ITEM>::printStats () const
 }
 
 //------------------------------------------------------------------------------
-template<class ITEM>
-void DoubleSkipList<ITEM>::print () const
+template<class ITEM, class STATS>
+void DoubleSkipList<ITEM, STATS>::print () const
 {
    std::cout << "Printing DoubleSkipList\n";
    Iterator itr(_head);
@@ -0,0 +1,115 @@
+//==============================================================================
+// FilteredHashSet.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_FILTERED_HASH_SET
+#define ESTDLIB_FILTERED_HASH_SET
+
+#include "HashSet.hpp"
+#include "BloomFilter.h"
+
+
+//==============================================================================
+// Class FilteredHashSet<ITEM, POOL, STATS>
+//==============================================================================
+/*
+ * A HashSet with a BloomFilter in front of it. Every added item's hash is also
+ * added to the filter, and find only searches the HashSet if the filter says
+ * the key may be there. This pays off when most lookups miss (as in main.cpp),
+ * since a miss then costs one cache line in the filter, instead of a bin and
+ * (usually) a HashNode in the HashSet.
+ *
+ * The filter can't forget hashes, so removed items leave false positives behind
+ * until the filter is rebuilt. It is rebuilt (from the items' hashes) whenever
+ * the number of items outgrows it, at which point its capacity is doubled.
+ *
+ * The requirements on ITEM are the same as for HashSet.
+ */
+
+template<class ITEM, class POOL, class STATS = HashSetNoStats>
+class FilteredHashSet {
+//------------------------------------------------------------------------------
+// Types
+public:
+   typedef HashSet<ITEM, POOL, STATS> Set;
+   typedef typename Set::Iterator Iterator;
+   typedef typename Set::ConstIterator ConstIterator;
+private:
+   typedef Wrap<ITEM> W;
+
+//------------------------------------------------------------------------------
+// Member Data
+private:
+   Set _set;
+   BloomFilter _filter;
+   unsigned _capacity;  ///< number of items the filter was sized for
+   float _bitsPerItem;  ///< filter bits per item of capacity
+
+//------------------------------------------------------------------------------
+// Interface
+public:
+   /// Arguments as for HashSet, plus the number of filter bits to use per item.
+   FilteredHashSet (unsigned initialBins, float bitsPerItem = 10, unsigned initialTrigger = 0)
+      : _set(initialBins, initialTrigger), _filter(initialBins, bitsPerItem),
+        _capacity(initialBins ? initialBins : 2), _bitsPerItem(bitsPerItem) {}
+
+   /// Adds a new item. If the item is already in the set, it returns a reference to the existing item.
+   typename W::Ref add (typename W::Ex item);
+   /// Returns a pointer to the corresponding item, or a null pointer if the item is not in the set.
+   template<class KEY> typename W::CPtr find (KEY const& key) const {
+      return _filter.mayContain(cref(key).hash()) ? _set.find(key) : 0;
+   }
+   /// Returns a pointer to the corresponding item, or a null pointer if the item is not in the set.
+   template<class KEY> typename W::Ptr find (KEY const& key) {
+      return _filter.mayContain(cref(key).hash()) ? _set.find(key) : 0;
+   }
+   template<class KEY> bool remove (KEY const& key) { return _set.remove(key); }
+   /// Clears all ITEMs from the set and the filter.
+   void clear () { _set.clear(); _filter.clear(); }
+   /// Rebuilds the filter from the items currently in the set (dropping hashes of removed items).
+   void rebuildFilter ();
+
+   unsigned size () const { return _set.size(); }
+   Iterator      iterator      () { return _set.iterator(); }
+   ConstIterator constIterator () const { return _set.constIterator(); }
+   /// The underlying HashSet and BloomFilter.
+   Set const& set () const { return _set; }
+   BloomFilter const& filter () const { return _filter; }
+};
+
+
+//==============================================================================
+// Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Adds a new item. If the item is already in the set, it returns a reference to the existing item.
+template<class ITEM, class POOL, class STATS>
+typename Wrap<ITEM>::Ref FilteredHashSet<ITEM, POOL, STATS>::add (typename W::Ex item)
+{
+   unsigned size = _set.size();
+   typename W::Ref added = _set.add(item);
+   if (_set.size() != size) {
+      if (_set.size() > _capacity) {
+         _capacity <<= 1;
+         rebuildFilter();
+      } else {
+         _filter.add(cref(item).hash());
+      }
+   }
+   return added;
+}
+
+//------------------------------------------------------------------------------
+// Rebuilds the filter from the items currently in the set (dropping hashes of removed items).
+template<class ITEM, class POOL, class STATS>
+void FilteredHashSet<ITEM, POOL, STATS>::rebuildFilter ()
+{
+   _filter.resize(_capacity, _bitsPerItem);
+   for (ConstIterator itr = _set.constIterator(); itr.valid(); ++itr)
+      _filter.add(itr.cref().hash());
+}
+
+
+#endif // ESTDLIB_FILTERED_HASH_SET
@@ -3,14 +3,29 @@
 // created           July      21 2010
 // templatized find  September  6 2010
 // added Wrap<ITEM>  January   28 2012
+// added relayout    October   18 2026
+// added telemetry   October   18 2026
+// added bin ranges  October   18 2026
+// added set algebra October   18 2026
+// added snapshots   October   18 2026
+// added arena mode  October   18 2026
+// added tagged bins October   18 2026
 //==============================================================================
 
 #ifndef HASH_SET_HPP
 #define HASH_SET_HPP
 
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <new>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include "MemoryPool.h"
 #include "Wrap.hpp"
 
 
@@ -34,7 +49,7 @@
  * can be used to look up objects in the HashSet. 
  *
  * Implementation Details:
- * A HashSet has an array of hash bins.
+ * A HashSet has an array of hash bins (stored in chunks, see Snapshots).
  * A hash bin is a linked list of pointers to items. All of the items
  * in the same hash bin have the same hash. Hashes are unsigned integers.
  * The length of the array of hash bins is always a power of two.
@@ -45,6 +60,67 @@
  * the number of hash bins, and start looking at the bottom n+1 bits of
  * each item's hash. (This occurs when the number of items in the HashSet
  * exceeds _trigger.)
+ *
+ * HashNodes are allocated from the memory pool in the order in which items are
+ * added, so the nodes of one chain are generally scattered all over the pool,
+ * and every hop along a chain is likely to be a cache miss. HashSet::relayout
+ * reallocates all nodes in bin order, so that each chain is contiguous (and
+ * neighboring bins' chains are adjacent). Since resizing splits every chain,
+ * sets with at least _relayoutThreshold items do this automatically after
+ * each resize.
+ *
+ * Telemetry:
+ * HashSet::telemetry returns a HashSetTelemetry, which describes the shape of
+ * the HashSet (load factor and a histogram of chain lengths). If the third
+ * template parameter is HashSetStats, it also reports the average number of
+ * HashNodes examined by successful and unsuccessful finds, and the number of
+ * resizes and the time they took. With the default, HashSetNoStats, none of
+ * this is recorded and the bookkeeping compiles away completely.
+ *
+ * Parallel Iteration:
+ * Bins are independent, so an iterator can be restricted to a range of bins,
+ * and different ranges can be walked by different threads at the same time
+ * (as long as nothing is added or removed meanwhile). parallelForEach does
+ * this: it splits the bins into chunks, and worker threads take chunks until
+ * none are left, so threads that hit crowded bins don't hold up the others.
+ *
+ * Set Algebra:
+ * unionWith, intersectWith and subtract never call ITEM::hash. Since bin
+ * counts are powers of two, bin i of the set with more bins only holds items
+ * that belong in bin (i & _mask) of the set with fewer, so each node is
+ * compared only against the nodes of one partner chain, and the hashes stored
+ * in the nodes are compared before the items are. (When both sets have the
+ * same number of bins, bin i simply pairs with bin i.) The chains are walked
+ * in parallel (see parallelForEach), but the memory pool isn't thread safe,
+ * so nodes are only allocated and freed by the calling thread.
+ *
+ * Snapshots:
+ * The bins are stored in chunks of 4096, and the HashSet reaches them
+ * through a table of pointers to chunks. HashSet::snapshot returns a
+ * Snapshot that shares the table, in constant time. Tables and chunks are
+ * reference counted, and the HashSet never changes one that is shared:
+ * before its first change after a snapshot it copies the table (which only
+ * points to the same chunks), and it copies a chunk (and the nodes in its
+ * chains) the first time it changes a bin in it. So Snapshots see the set
+ * exactly as it was, even from other threads, and only the parts of the set
+ * that have changed since are duplicated. Snapshots only ever decrement a
+ * table's (atomic) reference count; the HashSet keeps a list of the tables
+ * it has replaced, and frees them (and the chunks and nodes that only they
+ * used) once no Snapshots are using them. relayout does nothing while that
+ * list isn't empty, since it would move nodes that Snapshots can see.
+ *
+ * Tagged Bins:
+ * Most finds in some workloads miss, and a miss in a nonempty bin still
+ * reads the first node just to compare hashes. With BINS set to
+ * HashSetTaggedBins (x86-64 only) each bin keeps a small filter of its
+ * chain's hashes in the unused top bits of its pointer, so nearly all
+ * misses are answered from the bin array alone.
+ *
+ * Memory Pools:
+ * POOL is either MemoryPoolF or MemoryPool (see the wrappers below).
+ * MemoryPoolF can free nodes one at a time. MemoryPool can't, which makes
+ * the HashSet insert only, but it packs nodes with no bookkeeping at all, so
+ * it suits sets that are built once and then only searched.
  */
 
 
@@ -69,6 +145,7 @@ private:
    MemoryPoolF* _memPoolF;
 
 public:
+   static const bool canFree = true;
    MPW (): _memPoolF(nullptr) {}
    void construct (unsigned itemSize, unsigned alignSize, unsigned initialCapacity) {
       _memPoolF = new MemoryPoolF;
@@ -79,7 +156,11 @@ public:
    }
    ~MPW () { delete _memPoolF; }
    void* alloc () { return _memPoolF->alloc(); }
+   /// Tells the pool how many more items to make room for when it next runs out (0 changes nothing).
+   void expect (unsigned items) { if (items) _memPoolF->setNextBlockSize(items); }
    void donate (void* ptr, unsigned size) { _memPoolF->donate(ptr, size); }
+   /// Takes back memory that the HashSet malloced for bins.
+   void reclaim (void* ptr, unsigned size) { std::free(ptr); }
    void free (void* ptr) { _memPoolF->free(ptr); }
    void clear () { _memPoolF->clear(); }
 };
@@ -87,6 +168,13 @@ public:
 //------------------------------------------------------------------------------
 // Wrapper for MemoryPool
 /*
+ * MemoryPool can't free individual items, so HashSets that use it are insert
+ * only: remove, intersectWith and subtract don't compile. Nodes are bump
+ * allocated with no bookkeeping of their own. Nodes that the HashSet lets go of
+ * anyway (eg ones that only a released Snapshot was using) stay in the pool
+ * until it is cleared, and the bins the HashSet no longer needs are donated
+ * to the pool to hold more nodes.
+ */
 template<>
 struct MPW<MemoryPool> {
 private:
@@ -94,23 +182,155 @@ private:
    unsigned _size;
 
 public:
+   static const bool canFree = false;
    MPW (): _memPool(nullptr), _size(0) {}
    void construct (unsigned itemSize, unsigned alignSize, unsigned initialCapacity) {
-      _memPool = new MemoryPool(itemSize * initialCapacity, alignSize);
+      _size = alignSize * ( (itemSize + alignSize - 1) / alignSize );
+      _memPool = new MemoryPool(_size * initialCapacity, alignSize);
    }
    ~MPW () { delete _memPool; }
    void* alloc () { return _memPool->alloc(_size); }
+   /// Tells the pool how many more items to make room for when it next runs out (0 changes nothing).
+   void expect (unsigned items) { if (items) _memPool->setSizeOfNextAllocatedBlock(items * _size); }
    void donate (void* ptr, unsigned size) { _memPool->donate(ptr, size); }
+   /// Takes back memory that the HashSet malloced for bins (it becomes room for more nodes).
+   void reclaim (void* ptr, unsigned size) { _memPool->donate(ptr, size); }
+   void free (void*) {}
    void clear () { _memPool->clear(); }
 };
-*/
 
 
 //==============================================================================
-// Class HashSet<ITEM, POOL>
+// Telemetry
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/// A description of a HashSet's shape and performance (see HashSet::telemetry).
+struct HashSetTelemetry {
+   static const unsigned chainHistogramBins = 16;
+
+   // These are always filled in.
+   unsigned size;          ///< number of items
+   unsigned bins;          ///< number of bins
+   float loadFactor;       ///< size / bins
+   unsigned maxChain;      ///< number of HashNodes in the fullest bin
+   /// chains[i] is the number of bins with i HashNodes (the last entry counts all longer chains too)
+   unsigned chains[chainHistogramBins];
+
+   // These are only recorded by HashSets that use HashSetStats (otherwise recording is false).
+   bool recording;
+   unsigned long long hits;         ///< number of successful finds
+   unsigned long long hitProbes;    ///< HashNodes examined by successful finds
+   unsigned long long misses;       ///< number of unsuccessful finds
+   unsigned long long missProbes;   ///< HashNodes examined by unsuccessful finds
+   unsigned resizes;                ///< number of times the HashSet has doubled its bins
+   double resizeSeconds;            ///< total time spent resizing
+
+   double probesPerHit  () const { return hits   ? double(hitProbes)  / hits   : 0.0; }
+   double probesPerMiss () const { return misses ? double(missProbes) / misses : 0.0; }
+};
+
+//------------------------------------------------------------------------------
+/// Statistics policy that records nothing.
+struct HashSetNoStats {
+   void hit  (unsigned probes) {}
+   void miss (unsigned probes) {}
+   void startResize  () {}
+   void finishResize () {}
+   void reset () {}
+   void report (HashSetTelemetry& telemetry) const { telemetry.recording = false; }
+};
+
+//------------------------------------------------------------------------------
+/// Statistics policy that counts probes and times resizes.
+class HashSetStats {
+private:
+   unsigned long long _hits;
+   unsigned long long _hitProbes;
+   unsigned long long _misses;
+   unsigned long long _missProbes;
+   unsigned _resizes;
+   double _resizeSeconds;
+   std::chrono::steady_clock::time_point _resizeStart;
+
+public:
+   HashSetStats () { reset(); }
+   void hit  (unsigned probes) { ++_hits;   _hitProbes  += probes; }
+   void miss (unsigned probes) { ++_misses; _missProbes += probes; }
+   void startResize () { _resizeStart = std::chrono::steady_clock::now(); }
+   void finishResize () {
+      ++_resizes;
+      _resizeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _resizeStart).count();
+   }
+   void reset () {
+      _hits = _hitProbes = _misses = _missProbes = 0;
+      _resizes = 0;
+      _resizeSeconds = 0.0;
+   }
+   void report (HashSetTelemetry& telemetry) const {
+      telemetry.recording = true;
+      telemetry.hits = _hits;
+      telemetry.hitProbes = _hitProbes;
+      telemetry.misses = _misses;
+      telemetry.missProbes = _missProbes;
+      telemetry.resizes = _resizes;
+      telemetry.resizeSeconds = _resizeSeconds;
+   }
+};
+
+
+//==============================================================================
+// Bin Policies
+//==============================================================================
+
+/*
+ * A bin is stored as a pointer to the first HashNode in its chain. A bin
+ * policy can pack bits into the rest of the pointer (tag() bits for every
+ * hash in the chain), so that find can skip bins without touching their
+ * nodes. Empty bins are always zero.
+ */
+
+//------------------------------------------------------------------------------
+/// Bin policy for plain pointers (every bin with nodes is searched).
+struct HashSetPlainBins {
+   static const bool tagged = false;
+   static uintptr_t tag (unsigned hash) { return 0; }
+   static uintptr_t pointer (uintptr_t bin) { return bin; }
+   static bool mayContain (uintptr_t bin, unsigned hash) { return true; }
+};
+
+#if defined(__x86_64__) || defined(_M_X64)
+//------------------------------------------------------------------------------
+/// Bin policy that keeps a 16 bit filter of the chain's hashes in the top 16 bits of the pointer.
+/**
+ * x86-64 user space addresses fit in 47 bits (unless the process maps memory
+ * above that on purpose with 5 level paging), so the top 16 bits of a bin
+ * are free. Each hash sets two of them, picked by its top 8 bits (the bin
+ * number comes from the bottom bits). A find whose two bits aren't both set
+ * misses without reading any node. Chains at the usual load factors have one
+ * or two nodes, so nearly all misses are caught this way. removes make the
+ * filter be recomputed from the rest of the chain.
+ */
+struct HashSetTaggedBins {
+   static const bool tagged = true;
+   static const unsigned shift = 48;
+   static uintptr_t tag (unsigned hash) {
+      return (uintptr_t(1) << (shift + (hash >> 28))) | (uintptr_t(1) << (shift + ((hash >> 24) & 15)));
+   }
+   static uintptr_t pointer (uintptr_t bin) { return bin & ((uintptr_t(1) << shift) - 1); }
+   static bool mayContain (uintptr_t bin, unsigned hash) {
+      uintptr_t bits = tag(hash);
+      return (bin & bits) == bits;
+   }
+};
+#endif
+
+
+//==============================================================================
+// Class HashSet<ITEM, POOL, STATS, BINS>
 //==============================================================================
 
-template<class ITEM, class POOL>
+template<class ITEM, class POOL, class STATS = HashSetNoStats, class BINS = HashSetPlainBins>
 class HashSet {
 //------------------------------------------------------------------------------
 // SubClasses
@@ -127,52 +347,136 @@ private:
          : _next(nextNode), _item(item), _hash(hash) {}
    };
 
+   static const unsigned chunkShift = 12;
+   static const unsigned binsPerChunk = 1 << chunkShift;
+   static const unsigned chunkMask = binsPerChunk - 1;
+
+   /// A piece of the array of bins (see Snapshots in the Theory section).
+   struct BinChunk {
+      unsigned _refs;      ///< number of BinTables that point to this chunk (only changed by the HashSet)
+      HashNode* _bin[1];   ///< really min(bins, binsPerChunk) of them
+   };
+
+   /// The array of bins, as an array of BinChunks.
+   struct BinTable {
+      std::atomic<unsigned> _refs;  ///< 1 for the HashSet (while this is its table), plus 1 per Snapshot
+      unsigned _bins;
+      BinTable* _nextRetired;       ///< next table in the HashSet's list of retired tables
+      BinChunk* _chunk[1];          ///< really chunksFor(_bins) of them
+   };
+
 //------------------------------------------------------------------------------
 // Iterators
 public:
+   class Snapshot;
+
    /// Iterates through elements in a HashSet.
    class ConstIterator {
    private:
-      HashSet const* _hashSet;       ///< the HashSet that the Iterator is iterating through
+      BinTable* const* _table;       ///< the table of the HashSet (or Snapshot) that the Iterator is iterating through
       unsigned _currentBin;          ///< the number of the bin the Iterator is iterating through
+      unsigned _endBin;              ///< the Iterator stops before this bin
    protected:
       HashNode const* _currentNode;  ///< the HashNode that the Iterator is currently at
    public:
       ConstIterator (HashSet const& hashSet); ///< Constructor.
+      /// Iterates only through the items in bins beginBin to endBin - 1.
+      ConstIterator (HashSet const& hashSet, unsigned beginBin, unsigned endBin);
       bool valid () const { return _currentNode; } ///< false once everything has been iterated over
       typename W::CRef cref () const { return _currentNode->_item.cref(); }
       typename W::CPtr cptr () const { return _currentNode->_item.cptr(); }
       ConstIterator& operator++ ();       ///< Makes the Iterator point to the next ITEM in the HashSet.
    private:
+      friend class Snapshot;
+      ConstIterator (BinTable* const* table, unsigned beginBin, unsigned endBin);
       void findNextUsedBin ();       ///< Sets _currentBin to the index of the next nonempty bin in _hashSet.
    };
    friend class ConstIterator;
 
-   /// Iterates through elements in a HashSet without allowing changes.
+   /// Iterates through elements in a HashSet, allowing changes (but not to their hashes).
+   /**
+    * If Snapshots share any of the bins being iterated over, they are copied
+    * first. So if the HashSet has Snapshots, Iterators must not be created
+    * by several threads at once.
+    */
    class Iterator : public ConstIterator {
    public:
-      Iterator (HashSet& hashSet): ConstIterator(hashSet) {} ///< Constructor.
+      Iterator (HashSet& hashSet): ConstIterator(hashSet.unshare(0, hashSet._bins)) {} ///< Constructor.
+      /// Iterates only through the items in bins beginBin to endBin - 1.
+      Iterator (HashSet& hashSet, unsigned beginBin, unsigned endBin)
+         : ConstIterator(hashSet.unshare(beginBin, endBin), beginBin, endBin) {}
       typename W::Ref ref () const { return const_cast<HashNode*>(this->_currentNode)->_item.ref(); }
       typename W::Ptr ptr () const { return const_cast<HashNode*>(this->_currentNode)->_item.ptr(); }
       /// Makes the Iterator point to the next ITEM in the HashSet.
       Iterator& operator++ () { ConstIterator::operator++(); return *this; }
    };
 
+//------------------------------------------------------------------------------
+// Snapshots
+public:
+   /// A read only view of a HashSet, as it was when HashSet::snapshot was called.
+   /**
+    * Snapshots can be used (and copied and released) by other threads while
+    * the HashSet is changed. A Snapshot must be released (or destroyed)
+    * before its HashSet is.
+    */
+   class Snapshot {
+   private:
+      BinTable* _table;
+      unsigned _size;
+      friend class HashSet;
+      Snapshot (BinTable* table, unsigned size): _table(table), _size(size) {}
+   public:
+      Snapshot (): _table(0), _size(0) {}
+      Snapshot (Snapshot const& snapshot): _table(snapshot._table), _size(snapshot._size) {
+         if (_table)
+            _table->_refs.fetch_add(1, std::memory_order_relaxed);
+      }
+      Snapshot (Snapshot&& snapshot): _table(snapshot._table), _size(snapshot._size) { snapshot._table = 0; }
+      Snapshot& operator= (Snapshot snapshot) {
+         std::swap(_table, snapshot._table);
+         std::swap(_size, snapshot._size);
+         return *this;
+      }
+      ~Snapshot () { release(); }
+      /// Lets go of the HashSet's bins. (The HashSet reclaims them the next time it needs to.)
+      void release () {
+         if (_table)
+            _table->_refs.fetch_sub(1, std::memory_order_release);
+         _table = 0;
+         _size = 0;
+      }
+      /// false for Snapshots that have been released (or were never taken)
+      bool valid () const { return _table; }
+      unsigned size () const { return _size; }
+      /// Returns a pointer to the corresponding item, or a null pointer if the item wasn't in the HashSet.
+      template<class KEY> typename W::CPtr find (KEY const& key) const;
+      /// Returns a ConstIterator over the items in the Snapshot.
+      ConstIterator constIterator () const { return ConstIterator(&_table, 0, _table ? _table->_bins : 0); }
+   };
+
 //------------------------------------------------------------------------------
 // Member Data
 private:
    MPW<POOL> _pool;    ///< memory pool where HashNodes live
-   HashNode** _bin;    ///< array of bins
-   unsigned _bins;     ///< The length of the _bin array. Always a power of 2.
+   BinTable* _table;   ///< the bins
+   BinChunk** _chunk;  ///< _table->_chunk (kept here to save a step in find)
+   BinTable* _retired; ///< tables that Snapshots may still be using
+   unsigned _bins;     ///< The number of bins. Always a power of 2.
    unsigned _size;     ///< number of items in the HashSet
    unsigned _mask;     ///< _mask = _bins - 1. _mask & hash gives item's bin number.
    unsigned _trigger;  ///< hash map doubles in size when _size > _trigger
-   unsigned _maxNodes; ///< largest number of HashNodes in one bin
+   unsigned _relayoutThreshold; ///< resize calls relayout if there are at least this many items (0 means never)
+   mutable STATS _stats; ///< records probes and resizes (if STATS is HashSetStats)
 
 //------------------------------------------------------------------------------
 // Interface
 public:
+   /// HashSets with at least this many items call relayout after each resize (unless told otherwise).
+   static const unsigned defaultRelayoutThreshold = 1 << 16;
+
    HashSet (unsigned initialBins, unsigned initialTrigger = 0);
+   HashSet (HashSet const& hashSet);
    ~HashSet ();
    HashSet& operator= (HashSet const& hashSet);
 
@@ -181,14 +485,26 @@ public:
    /// Returns a pointer to the corresponding item, or a null pointer if the item is not in the HashSet.
    template<class KEY> typename W::CPtr find (KEY const& key) const;
    /// Returns a pointer to the corresponding item, or a null pointer if the item is not in the HashSet.
-   template<class KEY> typename W::Ptr  find (KEY const& key) {
-      return const_cast<ITEM*>(const_cast<HashSet const*>(this)->find(key));
-   }
-   // Note: remove can only be called with MemoryPoolF (MemoryPool will not work)
+   template<class KEY> typename W::Ptr  find (KEY const& key);
+   /// Removes the corresponding item, if there is one (only works with MemoryPoolF).
    template<class KEY> bool remove (KEY const& key);
+
+   /// Adds every item in hashSet that isn't already in this set (0 threads means one per hardware thread).
+   void unionWith (HashSet const& hashSet, unsigned threads = 0);
+   /// Removes every item that isn't also in hashSet (only works with MemoryPoolF).
+   void intersectWith (HashSet const& hashSet, unsigned threads = 0);
+   /// Removes every item that is also in hashSet (only works with MemoryPoolF).
+   void subtract (HashSet const& hashSet, unsigned threads = 0);
+
+   /// Returns a read only view of the HashSet as it is now, which other threads may use.
+   Snapshot snapshot ();
    
    /// Clears all ITEMs from the HashSet, without changing the number of bins.
    void clear ();
+   /// Reallocates all HashNodes in bin order, so that each bin's chain is contiguous in memory.
+   void relayout ();
+   /// Sets the minimum number of items for which resize automatically calls relayout (0 disables this).
+   void setRelayoutThreshold (unsigned threshold) { _relayoutThreshold = threshold; }
 
    /// Returns the number of items in the HashSet.
    unsigned size () const { return _size; }
@@ -196,13 +512,79 @@ public:
    Iterator      iterator      () { return Iterator(*this); }
    /// Returns a ConstIterator that points to some ITEM in the HashSet.
    ConstIterator constIterator () const { return ConstIterator(*this); }
+   /// Returns an Iterator over the items in bins beginBin to endBin - 1.
+   Iterator      iterator      (unsigned beginBin, unsigned endBin) { return Iterator(*this, beginBin, endBin); }
+   /// Returns a ConstIterator over the items in bins beginBin to endBin - 1.
+   ConstIterator constIterator (unsigned beginBin, unsigned endBin) const { return ConstIterator(*this, beginBin, endBin); }
+   /// Calls fn(item) for every item, from several threads at once (0 means one per hardware thread).
+   template<class FN> void parallelForEach (FN fn, unsigned threads = 0) const;
+   /// Calls fn(constIterator) for ConstIterators over chunks of bins that cover the set, from several threads at once.
+   template<class FN> void parallelForRanges (FN fn, unsigned threads = 0) const;
 
    unsigned bins () const { return _bins; }
+   /// Describes the shape of the HashSet, and its performance if STATS records it.
+   HashSetTelemetry telemetry () const;
+   /// Zeros the probe and resize counts (if STATS records them).
+   void resetTelemetry () { _stats.reset(); }
    void print () const;    /// A printing function for debugging purposes.
 
 // Private Methods
 private:
    void resize ();         ///< Doubles the length of _bin (and thus the functional capacity of the HashSet).
+   /// Calls fn(beginBin, endBin) for chunks that cover bins 0 to bins - 1, from several threads at once.
+   template<class FN> static void forBinRanges (unsigned bins, unsigned threads, FN fn);
+   /// Returns true if this set has an item equal to node's (using node's stored hash).
+   bool contains (HashNode const* node) const;
+   /// Adds an item that isn't in the set yet.
+   void addNew (typename W::Ex item, unsigned hash);
+   /// Removes (in parallel) the nodes for which hashSet.contains(node) == keep.
+   void removeWhere (HashSet const& hashSet, bool keep, unsigned threads);
+   /// Returns the matching node in a stored bin (or a null pointer), recording the probes.
+   template<class KEY> HashNode* findInChain (HashNode* bin, unsigned hash, KEY const& key) const;
+   /// Makes this set's bins and nodes copies of hashSet's (the set must be empty, and have as many bins).
+   void copyChains (HashSet const& hashSet);
+
+   // Bins and BinChunks
+   static unsigned chunksFor (unsigned bins) { return (bins + binsPerChunk - 1) >> chunkShift; }
+   static unsigned chunkBins (unsigned bins) { return bins < binsPerChunk ? bins : binsPerChunk; }
+   static HashNode*& binOf (BinTable* table, unsigned i) { return table->_chunk[i >> chunkShift]->_bin[i & chunkMask]; }
+   /// Returns the first node in bin i.
+   HashNode* bin (unsigned i) const { return first(slot(i)); }
+   /// Returns bin i as it is stored (with any bits the BINS policy packs into it).
+   HashNode* slot (unsigned i) const { return _chunk[i >> chunkShift]->_bin[i & chunkMask]; }
+   /// Returns the first node of a stored bin.
+   static HashNode* first (HashNode* bin) { return reinterpret_cast<HashNode*>(BINS::pointer(reinterpret_cast<uintptr_t>(bin))); }
+   /// Returns a stored bin for the chain starting with node, with the given tag bits.
+   static HashNode* tagged (HashNode* node, uintptr_t tag) { return reinterpret_cast<HashNode*>(reinterpret_cast<uintptr_t>(node) | tag); }
+   /// Returns the tag bits of a stored bin.
+   static uintptr_t tagOf (HashNode* bin) { return reinterpret_cast<uintptr_t>(bin) & ~BINS::pointer(~uintptr_t(0)); }
+   /// Returns the tag bits for the chain starting with node (which is walked only if BINS uses tags).
+   static uintptr_t chainTag (HashNode const* node);
+   static bool mayContain (HashNode* bin, unsigned hash) { return BINS::mayContain(reinterpret_cast<uintptr_t>(bin), hash); }
+   /// Adds a new node to the front of a stored bin.
+   void push (HashNode*& bin, typename W::Ex item, unsigned hash);
+   /// Returns bin i, which may be changed (only when nothing is shared with Snapshots).
+   HashNode*& binRef (unsigned i) { return _chunk[i >> chunkShift]->_bin[i & chunkMask]; }
+   /// Returns bin i, which may be changed (copying it first if Snapshots share it).
+   HashNode*& writableBin (unsigned i);
+   /// Copies whatever Snapshots share of bins beginBin to endBin - 1, so that it can be changed.
+   HashSet& unshare (unsigned beginBin, unsigned endBin);
+   /// true if no Snapshots (or tables they used) are still around, so nothing is shared.
+   bool exclusive ();
+   bool tableShared () const { return _table->_refs.load(std::memory_order_acquire) > 1; }
+   static BinChunk* newChunk (unsigned bins, bool zero);
+   static BinTable* newTable (unsigned bins, bool zeroChunks);
+   /// Replaces _table with a copy (pointing to the same chunks), and retires _table.
+   void detach ();
+   /// Returns a copy of chunk (with copies of its nodes), which replaces it in _table.
+   BinChunk* copyChunk (BinChunk* chunk);
+   /// The HashSet lets go of table (which Snapshots may still be using).
+   void retire (BinTable* table);
+   /// Frees the retired tables that no Snapshots are using anymore (or all of them if force is true).
+   void collect (bool force = false);
+   /// Lets go of table's chunks, and frees it. Nodes of chunks nobody uses anymore are freed if freeNodes is true.
+   void releaseTable (BinTable* table, bool freeNodes);
+   void installTable (BinTable* table) { _table = table; _chunk = table->_chunk; }
 };
 
 
@@ -231,9 +613,9 @@ private:
  * allowed in the HashSet before it resizes itself. If no initialTrigger is
  * supplied, the HashSet will set it equal to initialBins by default.
  */
-template<class ITEM, class POOL>
-HashSet<ITEM, POOL>::HashSet(unsigned initialBins, unsigned initialTrigger)
-   : _size(0), _maxNodes(0)
+template<class ITEM, class POOL, class STATS, class BINS>
+HashSet<ITEM, POOL, STATS, BINS>::HashSet(unsigned initialBins, unsigned initialTrigger)
+   : _retired(0), _size(0), _relayoutThreshold(defaultRelayoutThreshold)
 {
    // _bins cannot be zero because then the first add with fail
    _bins = initialBins ? initialBins : 2;
@@ -254,20 +636,33 @@ HashSet<ITEM, POOL>::HashSet(unsigned initialBins, unsigned initialTrigger)
 
    _mask = _bins - 1;
    _trigger = initialTrigger? initialTrigger : _bins;
-   
-   // calloc zeros memory
-   _bin = (HashNode**) calloc(_bins, sizeof(HashNode*));
-   if (!_bin) {
-      throw("Could not allocate memory in Geneva::HashSet constructor.");
-   }
+   installTable(newTable(_bins, true));
+}
+
+//------------------------------------------------------------------------------
+// Copy constructor
+/**
+ * This is a structural copy: the chains are copied node by node (in bin
+ * order, so each chain is contiguous), without hashing or comparing items.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+HashSet<ITEM, POOL, STATS, BINS>::HashSet (HashSet const& hashSet)
+   : _retired(0), _bins(hashSet._bins), _size(0), _mask(hashSet._mask), _trigger(hashSet._trigger),
+   _relayoutThreshold(hashSet._relayoutThreshold)
+{
+   _pool.construct(sizeof(HashNode), sizeof(HashNode*), hashSet._size ? hashSet._size : 2);
+   installTable(newTable(_bins, true));
+   copyChains(hashSet);
 }
 
 //------------------------------------------------------------------------------
 // destructor
-template<class ITEM, class POOL>
-inline HashSet<ITEM, POOL>::~HashSet ()
+template<class ITEM, class POOL, class STATS, class BINS>
+inline HashSet<ITEM, POOL, STATS, BINS>::~HashSet ()
 {
-   free(_bin);
+   // The nodes all go when the pool does, so only the tables and chunks need to be freed.
+   collect(true);
+   releaseTable(_table, false);
    // pool is implicitly deleted by deletion of MPW<POOL>
    //delete _pool;
 }
@@ -275,65 +670,52 @@ inline HashSet<ITEM, POOL>::~HashSet ()
 //------------------------------------------------------------------------------
 // Copies a HashSet.
 /**
- * Implementation Detail: This method calls add for every ITEM in the copied HashSet.
- * This means that it unnecessarily checks if these ITEMs are already in
- * the set being copied to. A private addNew method would be faster.
+ * Like the copy constructor, this copies the chains node by node, so items
+ * are neither hashed nor compared.
  */
-template<class ITEM, class POOL>
-HashSet<ITEM, POOL>& HashSet<ITEM, POOL>::operator= (HashSet<ITEM, POOL> const& hashSet)
+template<class ITEM, class POOL, class STATS, class BINS>
+HashSet<ITEM, POOL, STATS, BINS>& HashSet<ITEM, POOL, STATS, BINS>::operator= (HashSet<ITEM, POOL, STATS, BINS> const& hashSet)
 {
+   if (&hashSet == this)
+      return *this;
+   // After clear the table and its chunks are ours alone.
+   clear();
    if (_bins != hashSet._bins) {
-      _pool.donate(_bin, _bins * sizeof(HashNode*));
-      _bin = (HashNode**) calloc(hashSet._bins, sizeof(HashNode*));
+      releaseTable(_table, false);
       _bins = hashSet._bins;
       _mask = hashSet._mask;
-   } else {
-      std::memset(_bin, 0, _bins*sizeof(HashNode*));
+      installTable(newTable(_bins, true));
    }
    _trigger = hashSet._trigger;
-   _pool.clear();
-   _size = 0;
-   
-   for (typename HashSet::Iterator itr(hashSet); itr; ++itr) {
-      add(*itr);
-   }
-   
+   copyChains(hashSet);
    return *this;
 }
 
 //------------------------------------------------------------------------------
 // Adds a new item. If the item is already in the HashSet, it returns a reference to the existing item.
-template<class ITEM, class POOL>
-typename Wrap<ITEM>::Ref HashSet<ITEM, POOL>::add (typename W::Ex item)
+template<class ITEM, class POOL, class STATS, class BINS>
+typename Wrap<ITEM>::Ref HashSet<ITEM, POOL, STATS, BINS>::add (typename W::Ex item)
 {
    // figure out where it should go
    unsigned hash = cref(item).hash();
-   unsigned binNumber = hash & _mask;
-   HashNode* node = _bin[binNumber];
+   HashNode* stored = writableBin(hash & _mask);
 
    // check that it's not already there
-   unsigned nodes = 1;  // start at one because we're about to add one
-   while (node) {
-      if (node->_hash == hash and node->_item.cref() == cref(item))
-         return node->_item.ref();
-      node = node->_next;
-      ++nodes;
+   if (mayContain(stored, hash)) {
+      for (HashNode* node = first(stored); node; node = node->_next) {
+         if (node->_hash == hash and node->_item.cref() == cref(item))
+            return node->_item.ref();
+      }
    }
 
    // resize if necessary
-   if (++_size > _trigger) {
+   if (++_size > _trigger)
       resize();
-      binNumber = hash & _mask;
-   }
-
-   // see if this bin has the most nodes
-   if (nodes > _maxNodes) {
-      _maxNodes = nodes;
-   }
    
    // add a new HashNode
-   _bin[binNumber] = new(_pool.alloc()) HashNode(_bin[binNumber], item, hash);
-   return _bin[binNumber]->_item.ref();
+   HashNode*& bin = writableBin(hash & _mask);
+   push(bin, item, hash);
+   return first(bin)->_item.ref();
 }
 
 //------------------------------------------------------------------------------
@@ -344,62 +726,287 @@ typename Wrap<ITEM>::Ref HashSet<ITEM, POOL>::add (typename W::Ex item)
  * 1) properly defines unsigned KEY::hash() const
  * 2) can be compared to an ITEM using ITEM == KEY
  */
-template<class ITEM, class POOL>
+template<class ITEM, class POOL, class STATS, class BINS>
 template<class KEY>
-typename Wrap<ITEM>::CPtr HashSet<ITEM, POOL>::find (KEY const& key) const
+typename Wrap<ITEM>::CPtr HashSet<ITEM, POOL, STATS, BINS>::find (KEY const& key) const
 {
    unsigned hash = cref(key).hash();
-   HashNode* node = _bin[hash & _mask];
-   while (node) {
-      if (node->_hash == hash and node->_item.cref() == cref(key)) {
-         return node->_item.ptr();
-      }
-      node = node->_next;
-   }
-   return 0;
+   HashNode* node = findInChain(slot(hash & _mask), hash, key);
+   return node ? node->_item.cptr() : 0;
 }
 
 //------------------------------------------------------------------------------
-template<class ITEM, class POOL>
+// Returns a pointer to the corresponding item, or a null pointer if the item is not in the HashSet.
+/**
+ * Since the item may be changed through the pointer, if Snapshots share its
+ * bin the bin is copied, and the copy of the item is returned.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
 template<class KEY>
-bool HashSet<ITEM, POOL>::remove (KEY const& key) {
+typename Wrap<ITEM>::Ptr HashSet<ITEM, POOL, STATS, BINS>::find (KEY const& key)
+{
    unsigned hash = cref(key).hash();
-   HashNode* node = _bin[hash & _mask];
-   if (node->_hash == hash and node->_item.cref() == cref(key)) {
-      _bin[hash & _mask] = node->_next;
-      _pool.free(node);
-      return true;
+   unsigned i = hash & _mask;
+   HashNode* node = findInChain(slot(i), hash, key);
+   if (!node)
+      return 0;
+   if (tableShared() or _chunk[i >> chunkShift]->_refs > 1) {
+      // the copy is at the same place in the copied chain
+      unsigned position = 0;
+      for (HashNode* n = bin(i); n != node; n = n->_next)
+         ++position;
+      node = first(writableBin(i));
+      while (position--)
+         node = node->_next;
    }
-   HashNode* nextnode = node->_next;
-   while (nextnode) {
-      if (nextnode->_hash == hash and nextnode->_item.cref() == cref(key)) {
-         node->_next = nextnode->_next;
-         _pool.free(nextnode);
+   return node->_item.ptr();
+}
+
+//------------------------------------------------------------------------------
+template<class ITEM, class POOL, class STATS, class BINS>
+template<class KEY>
+bool HashSet<ITEM, POOL, STATS, BINS>::remove (KEY const& key) {
+   static_assert(MPW<POOL>::canFree, "HashSet::remove needs a pool that can free items (use MemoryPoolF)");
+   unsigned hash = cref(key).hash();
+   if (!mayContain(slot(hash & _mask), hash))
+      return false;
+   HashNode*& bin = writableBin(hash & _mask);
+   HashNode* head = first(bin);
+   for (HashNode** link = &head; *link; link = &(*link)->_next) {
+      HashNode* node = *link;
+      if (node->_hash == hash and node->_item.cref() == cref(key)) {
+         *link = node->_next;
+         bin = tagged(head, chainTag(head));
+         node->~HashNode();
+         _pool.free(node);
+         --_size;
          return true;
       }
-      node = nextnode;
-      nextnode = nextnode->_next;
    }
    return false;
 }
 
+//------------------------------------------------------------------------------
+// Adds every item in hashSet that isn't already in this set.
+/**
+ * First the missing items are found (in parallel, without changing either
+ * set). Then the set is resized once, to its final size, and the pool is told
+ * to expect that many new nodes, before they are added.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::unionWith (HashSet const& hashSet, unsigned threads)
+{
+   if (&hashSet == this)
+      return;
+   std::vector<HashNode const*> missing;
+   std::mutex mutex;
+   forBinRanges(hashSet._bins, threads, [this, &hashSet, &missing, &mutex] (unsigned beginBin, unsigned endBin) {
+      std::vector<HashNode const*> local;
+      for (unsigned i=beginBin; i<endBin; ++i) {
+         for (HashNode const* node = hashSet.bin(i); node; node = node->_next) {
+            if (!contains(node))
+               local.push_back(node);
+         }
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      missing.insert(missing.end(), local.begin(), local.end());
+   });
+
+   unsigned newSize = _size + missing.size();
+   while (newSize > _trigger)
+      resize();
+   _pool.expect(missing.size());
+   for (HashNode const* node : missing)
+      addNew(node->_item.ex(), node->_hash);
+}
+
+//------------------------------------------------------------------------------
+// Removes every item that isn't also in hashSet (only works with MemoryPoolF).
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::intersectWith (HashSet const& hashSet, unsigned threads)
+{
+   static_assert(MPW<POOL>::canFree, "HashSet::intersectWith needs a pool that can free items (use MemoryPoolF)");
+   if (&hashSet != this)
+      removeWhere(hashSet, false, threads);
+}
+
+//------------------------------------------------------------------------------
+// Removes every item that is also in hashSet (only works with MemoryPoolF).
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::subtract (HashSet const& hashSet, unsigned threads)
+{
+   static_assert(MPW<POOL>::canFree, "HashSet::subtract needs a pool that can free items (use MemoryPoolF)");
+   if (&hashSet == this)
+      clear();
+   else
+      removeWhere(hashSet, true, threads);
+}
+
+//------------------------------------------------------------------------------
+// Returns a read only view of the HashSet as it is now, which other threads may use.
+/**
+ * This takes constant time: the Snapshot shares the HashSet's table of bins.
+ * The next change to the HashSet copies the table (which is only an array of
+ * pointers to chunks of bins), and each chunk of bins (with its nodes) is
+ * copied the first time it is changed while a Snapshot shares it.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+typename HashSet<ITEM, POOL, STATS, BINS>::Snapshot HashSet<ITEM, POOL, STATS, BINS>::snapshot ()
+{
+   collect();
+   _table->_refs.fetch_add(1, std::memory_order_relaxed);
+   return Snapshot(_table, _size);
+}
+
 //------------------------------------------------------------------------------
 // Clears all ITEMs from the HashSet, without changing the number of bins.
-template<class ITEM, class POOL>
-void HashSet<ITEM, POOL>::clear ()
+/**
+ * If Snapshots still share any nodes, the HashSet starts over with a new
+ * table, and the old nodes are freed once the Snapshots are done with them.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::clear ()
 {
-   std::memset(_bin, 0, _bins*sizeof(HashNode*));
-   _pool.clear();
+   if (exclusive()) {
+      unsigned chunks = chunksFor(_bins);
+      for (unsigned i=0; i<chunks; ++i)
+         std::memset(_chunk[i]->_bin, 0, chunkBins(_bins) * sizeof(HashNode*));
+      _pool.clear();
+   } else {
+      BinTable* table = _table;
+      installTable(newTable(_bins, true));
+      retire(table);
+      collect();
+   }
    _size = 0;
 }
 
+//------------------------------------------------------------------------------
+// Reallocates all HashNodes in bin order, so that each bin's chain is contiguous in memory.
+/**
+ * The nodes are first copied (in bin order) to a temporary array. Then the
+ * memory pool is cleared, which keeps all of its blocks, and the nodes are
+ * allocated again one after another. Since a freshly cleared pool hands out
+ * consecutive pieces of its blocks, each chain ends up contiguous, and the
+ * chains of neighboring bins end up next to each other.
+ *
+ * This invalidates all pointers and references to items in the HashSet.
+ * If the temporary array can't be allocated, or Snapshots are still using
+ * any of the nodes, the HashSet is left as it is.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::relayout ()
+{
+   if (_size == 0 or !exclusive())
+      return;
+   HashNode* temp = static_cast<HashNode*>(malloc(_size * sizeof(HashNode)));
+   if (!temp)
+      return;
+
+   // Copy the chains into temp, in order. Within temp, a null _next marks the end of a chain.
+   HashNode* copy = temp;
+   for (unsigned i=0; i<_bins; ++i) {
+      for (HashNode* node = bin(i); node; node = node->_next) {
+         new(copy) HashNode(node->_next ? copy + 1 : 0, node->_item.ex(), node->_hash);
+         ++copy;
+      }
+   }
+
+   // Reallocate the chains (old bin pointers are only used to see which bins are nonempty).
+   _pool.clear();
+   copy = temp;
+   for (unsigned i=0; i<_bins; ++i) {
+      if (!bin(i))
+         continue;
+      HashNode* head;
+      HashNode** link = &head;
+      bool more;
+      do {
+         *link = new(_pool.alloc()) HashNode(0, copy->_item.ex(), copy->_hash);
+         link = &((*link)->_next);
+         more = copy->_next;
+         copy->~HashNode();
+         ++copy;
+      } while (more);
+      binRef(i) = tagged(head, tagOf(binRef(i)));
+   }
+   free(temp);
+}
+
+//------------------------------------------------------------------------------
+// Calls fn(item) for every item, from several threads at once (0 means one per hardware thread).
+/**
+ * fn is called with a const reference to each item, and must be safe to call
+ * from several threads at once (eg it can add into per-thread totals, or use
+ * atomics). Nothing may be added to or removed from the HashSet until
+ * parallelForEach returns. If fn throws, the program terminates.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+template<class FN>
+void HashSet<ITEM, POOL, STATS, BINS>::parallelForEach (FN fn, unsigned threads) const
+{
+   parallelForRanges([&fn] (ConstIterator itr) {
+      for (; itr.valid(); ++itr)
+         fn(itr.cref());
+   }, threads);
+}
+
+//------------------------------------------------------------------------------
+// Calls fn(constIterator) for ConstIterators over chunks of bins that cover the set, from several threads at once.
+/**
+ * This is useful for aggregation: fn can total up its chunk in local
+ * variables, and then combine the result with the others once (eg with a
+ * mutex or an atomic). The same rules apply as for parallelForEach.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+template<class FN>
+void HashSet<ITEM, POOL, STATS, BINS>::parallelForRanges (FN fn, unsigned threads) const
+{
+   forBinRanges(_bins, threads, [this, &fn] (unsigned beginBin, unsigned endBin) {
+      fn(ConstIterator(*this, beginBin, endBin));
+   });
+}
+
+//------------------------------------------------------------------------------
+// Describes the shape of the HashSet, and its performance if STATS records it.
+/**
+ * The chain length histogram is computed by walking every bin, so this takes
+ * time proportional to the size of the HashSet.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+HashSetTelemetry HashSet<ITEM, POOL, STATS, BINS>::telemetry () const
+{
+   HashSetTelemetry telemetry;
+   telemetry.size = _size;
+   telemetry.bins = _bins;
+   telemetry.loadFactor = float(_size) / float(_bins);
+   telemetry.maxChain = 0;
+   std::memset(telemetry.chains, 0, sizeof(telemetry.chains));
+   for (unsigned i=0; i<_bins; ++i) {
+      unsigned nodes = 0;
+      for (HashNode* node = bin(i); node; node = node->_next)
+         ++nodes;
+      if (nodes > telemetry.maxChain)
+         telemetry.maxChain = nodes;
+      if (nodes >= HashSetTelemetry::chainHistogramBins)
+         nodes = HashSetTelemetry::chainHistogramBins - 1;
+      ++telemetry.chains[nodes];
+   }
+
+   telemetry.hits = telemetry.hitProbes = telemetry.misses = telemetry.missProbes = 0;
+   telemetry.resizes = 0;
+   telemetry.resizeSeconds = 0.0;
+   _stats.report(telemetry);
+   return telemetry;
+}
+
 //------------------------------------------------------------------------------
 // printing function for debugging
-template<class ITEM, class POOL>
-void HashSet<ITEM, POOL>::print () const
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::print () const
 {
    for (unsigned i=0; i<_bins; ++i) {
-      HashNode* node = _bin[i];
+      HashNode* node = bin(i);
       std::cout << "Bin " << i << " : ";
       while(node) {
          std::cout << '{' << node->_hash << ", ";
@@ -413,50 +1020,450 @@ void HashSet<ITEM, POOL>::print () const
 }
 
 
+//==============================================================================
+// Snapshot Methods
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Returns a pointer to the corresponding item, or a null pointer if the item wasn't in the HashSet.
+template<class ITEM, class POOL, class STATS, class BINS>
+template<class KEY>
+typename Wrap<ITEM>::CPtr HashSet<ITEM, POOL, STATS, BINS>::Snapshot::find (KEY const& key) const
+{
+   if (!_table)
+      return 0;
+   unsigned hash = cref(key).hash();
+   HashNode* stored = binOf(_table, hash & (_table->_bins - 1));
+   if (!mayContain(stored, hash))
+      return 0;
+   for (HashNode const* node = first(stored); node; node = node->_next) {
+      if (node->_hash == hash and node->_item.cref() == cref(key))
+         return node->_item.cptr();
+   }
+   return 0;
+}
+
+
 //==============================================================================
 // Private HashSet Methods
 //==============================================================================
 
 //------------------------------------------------------------------------------
 // Doubles the length of _bin (and thus the functional capacity of the HashSet).
-template<class ITEM, class POOL>
-void HashSet<ITEM, POOL>::resize()
+/**
+ * Chunks that Snapshots share can't be changed, so their nodes are copied
+ * into the new bins instead of being moved.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::resize()
 {
+   _stats.startResize();
+   collect();
+   if (tableShared())
+      detach();
    unsigned newbins = _bins << 1;
-   HashNode** newbin = (HashNode**) malloc(newbins * sizeof(HashNode*));
+   BinTable* table = newTable(newbins, false);
    HashNode* node;
    HashNode* high;
    HashNode* low;
-   for (unsigned i=0; i<_bins; ++i) {
-      node = _bin[i];
-      // Makes high and low point to the pointers to the first HashNodes in their bins.
-      // This is why _next must be the first item in HashNode.
-      // (This allows us to treat a HashNode* as a HashNode, if
-      // we only want the HashNode's _next pointer. We could
-      // get rid of this requirement if we add extra ifs or
-      // use a HashNode**, but these take longer to write
-      // and longer to run.)
-      high = (HashNode*) &newbin[i+_bins];
-      low  = (HashNode*) &newbin[i];
-      while (node) {
-         if (_bins & (node->_hash)) {
-            high->_next = node;
-            high = node;
-         } else {
-            low->_next = node;
-            low = node;
+   unsigned chunks = chunksFor(_bins);
+   for (unsigned c=0; c<chunks; ++c) {
+      BinChunk* chunk = _chunk[c];
+      bool shared = chunk->_refs > 1;
+      unsigned firstBin = c << chunkShift;
+      for (unsigned j=0; j<chunkBins(_bins); ++j) {
+         unsigned i = firstBin + j;
+         node = first(chunk->_bin[j]);
+         uintptr_t highTag = 0;
+         uintptr_t lowTag = 0;
+         // Makes high and low point to the pointers to the first HashNodes in their bins.
+         // This is why _next must be the first item in HashNode.
+         // (This allows us to treat a HashNode* as a HashNode, if
+         // we only want the HashNode's _next pointer. We could
+         // get rid of this requirement if we add extra ifs or
+         // use a HashNode**, but these take longer to write
+         // and longer to run.)
+         high = (HashNode*) &binOf(table, i+_bins);
+         low  = (HashNode*) &binOf(table, i);
+         while (node) {
+            HashNode* moved = shared ? new(_pool.alloc()) HashNode(0, node->_item.ex(), node->_hash) : node;
+            if (_bins & (node->_hash)) {
+               high->_next = moved;
+               high = moved;
+               highTag |= BINS::tag(node->_hash);
+            } else {
+               low->_next = moved;
+               low = moved;
+               lowTag |= BINS::tag(node->_hash);
+            }
+            node = node->_next;
          }
-         node = node->_next;
+         high->_next = 0;
+         low->_next  = 0;
+         binOf(table, i+_bins) = tagged(binOf(table, i+_bins), highTag);
+         binOf(table, i)       = tagged(binOf(table, i), lowTag);
       }
-      high->_next = 0;
-      low->_next  = 0;
+      // Shared chunks now only belong to retired tables; ours are empty (their nodes were moved).
+      if (shared)
+         --chunk->_refs;
+      else
+         _pool.reclaim(chunk, sizeof(BinChunk) + (chunkBins(_bins) - 1) * sizeof(HashNode*));
    }
 
-   _pool.donate(_bin, sizeof(HashNode*) * _bins);
-   _bin = newbin;
+   // Until the next resize we can add as many items as there used to be bins,
+   // so the pool should grow in steps of that size (instead of its initial size).
+   _pool.expect(_bins);
+   _table->~BinTable();
+   free(_table);
+   installTable(table);
    _bins = newbins;
    _mask = _bins-1;
    _trigger <<= 1;   
+
+   // Splitting the chains scatters them, so large sets put them back together.
+   if (_relayoutThreshold and _size >= _relayoutThreshold)
+      relayout();
+   _stats.finishResize();
+}
+
+//------------------------------------------------------------------------------
+// Calls fn(beginBin, endBin) for chunks that cover bins 0 to bins - 1, from several threads at once.
+/**
+ * There are several chunks per thread, and each thread takes the next
+ * unclaimed chunk when it finishes one, so the work stays balanced even if
+ * some chunks are much fuller than others. With one thread (or few bins)
+ * everything is done by the calling thread.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+template<class FN>
+void HashSet<ITEM, POOL, STATS, BINS>::forBinRanges (unsigned bins, unsigned threads, FN fn)
+{
+   if (threads == 0)
+      threads = std::thread::hardware_concurrency();
+   const unsigned minChunk = 1024;
+   if (threads <= 1 or bins <= minChunk) {
+      fn(0u, bins);
+      return;
+   }
+   unsigned chunk = bins / (8 * threads);
+   if (chunk < minChunk)
+      chunk = minChunk;
+
+   std::atomic<unsigned> next(0);
+   auto work = [bins, chunk, &next, &fn] () {
+      unsigned begin;
+      while ((begin = next.fetch_add(chunk)) < bins)
+         fn(begin, begin + chunk < bins ? begin + chunk : bins);
+   };
+   // the calling thread is one of the workers
+   std::vector<std::thread> workers;
+   for (unsigned t=1; t<threads; ++t)
+      workers.emplace_back(work);
+   work();
+   for (std::thread& worker : workers)
+      worker.join();
+}
+
+//------------------------------------------------------------------------------
+// Returns true if this set has an item equal to node's (using node's stored hash).
+template<class ITEM, class POOL, class STATS, class BINS>
+bool HashSet<ITEM, POOL, STATS, BINS>::contains (HashNode const* node) const
+{
+   HashNode* stored = slot(node->_hash & _mask);
+   if (!mayContain(stored, node->_hash))
+      return false;
+   for (HashNode const* mine = first(stored); mine; mine = mine->_next) {
+      if (mine->_hash == node->_hash and mine->_item.cref() == node->_item.cref())
+         return true;
+   }
+   return false;
+}
+
+//------------------------------------------------------------------------------
+// Adds an item that isn't in the set yet.
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::addNew (typename W::Ex item, unsigned hash)
+{
+   if (++_size > _trigger)
+      resize();
+   push(writableBin(hash & _mask), item, hash);
+}
+
+//------------------------------------------------------------------------------
+// Adds a new node to the front of a stored bin.
+template<class ITEM, class POOL, class STATS, class BINS>
+inline void HashSet<ITEM, POOL, STATS, BINS>::push (HashNode*& bin, typename W::Ex item, unsigned hash)
+{
+   HashNode* node = new(_pool.alloc()) HashNode(first(bin), item, hash);
+   bin = tagged(node, tagOf(bin) | BINS::tag(hash));
+}
+
+//------------------------------------------------------------------------------
+// Returns the tag bits for the chain starting with node (which is walked only if BINS uses tags).
+template<class ITEM, class POOL, class STATS, class BINS>
+uintptr_t HashSet<ITEM, POOL, STATS, BINS>::chainTag (HashNode const* node)
+{
+   uintptr_t tag = 0;
+   if (BINS::tagged) {
+      for (; node; node = node->_next)
+         tag |= BINS::tag(node->_hash);
+   }
+   return tag;
+}
+
+//------------------------------------------------------------------------------
+// Removes (in parallel) the nodes for which hashSet.contains(node) == keep.
+/**
+ * Each chunk of bins only relinks its own chains, so chunks can be processed
+ * at the same time. The nodes that are unlinked are collected, and handed
+ * back to the pool by the calling thread.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::removeWhere (HashSet const& hashSet, bool keep, unsigned threads)
+{
+   unshare(0, _bins);
+   std::vector<HashNode*> dead;
+   std::mutex mutex;
+   forBinRanges(_bins, threads, [this, &hashSet, keep, &dead, &mutex] (unsigned beginBin, unsigned endBin) {
+      std::vector<HashNode*> local;
+      for (unsigned i=beginBin; i<endBin; ++i) {
+         HashNode* head = bin(i);
+         HashNode** link = &head;
+         unsigned removed = local.size();
+         while (HashNode* node = *link) {
+            if (hashSet.contains(node) == keep) {
+               *link = node->_next;
+               node->~HashNode();
+               local.push_back(node);
+            } else {
+               link = &node->_next;
+            }
+         }
+         if (local.size() != removed)
+            binRef(i) = tagged(head, chainTag(head));
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      dead.insert(dead.end(), local.begin(), local.end());
+   });
+
+   // the pool only looks at the addresses, so the dead nodes themselves aren't touched again
+   for (HashNode* node : dead)
+      _pool.free(node);
+   _size -= dead.size();
+}
+
+//------------------------------------------------------------------------------
+// Returns the matching node in a stored bin (or a null pointer), recording the probes.
+/**
+ * If the bin's tag rules the key out, the miss is recorded with no probes.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+template<class KEY>
+typename HashSet<ITEM, POOL, STATS, BINS>::HashNode* HashSet<ITEM, POOL, STATS, BINS>::findInChain (HashNode* bin, unsigned hash, KEY const& key) const
+{
+   unsigned probes = 0;
+   HashNode* node = mayContain(bin, hash) ? first(bin) : 0;
+   while (node) {
+      ++probes;
+      if (node->_hash == hash and node->_item.cref() == cref(key)) {
+         _stats.hit(probes);
+         return node;
+      }
+      node = node->_next;
+   }
+   _stats.miss(probes);
+   return 0;
+}
+
+//------------------------------------------------------------------------------
+// Makes this set's bins and nodes copies of hashSet's (the set must be empty, and have as many bins).
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::copyChains (HashSet const& hashSet)
+{
+   _pool.expect(hashSet._size);
+   for (unsigned i=0; i<_bins; ++i) {
+      HashNode* head = 0;
+      HashNode** link = &head;
+      for (HashNode const* node = hashSet.bin(i); node; node = node->_next) {
+         *link = new(_pool.alloc()) HashNode(0, node->_item.ex(), node->_hash);
+         link = &((*link)->_next);
+      }
+      binRef(i) = tagged(head, tagOf(hashSet.slot(i)));
+   }
+   _size = hashSet._size;
+}
+
+//------------------------------------------------------------------------------
+// Returns bin i, which may be changed (copying it first if Snapshots share it).
+template<class ITEM, class POOL, class STATS, class BINS>
+typename HashSet<ITEM, POOL, STATS, BINS>::HashNode*& HashSet<ITEM, POOL, STATS, BINS>::writableBin (unsigned i)
+{
+   if (tableShared())
+      detach();
+   BinChunk*& chunk = _chunk[i >> chunkShift];
+   if (chunk->_refs > 1)
+      chunk = copyChunk(chunk);
+   return chunk->_bin[i & chunkMask];
+}
+
+//------------------------------------------------------------------------------
+// Copies whatever Snapshots share of bins beginBin to endBin - 1, so that it can be changed.
+template<class ITEM, class POOL, class STATS, class BINS>
+HashSet<ITEM, POOL, STATS, BINS>& HashSet<ITEM, POOL, STATS, BINS>::unshare (unsigned beginBin, unsigned endBin)
+{
+   if (tableShared())
+      detach();
+   if (_retired) {
+      if (endBin > _bins)
+         endBin = _bins;
+      for (unsigned c = beginBin >> chunkShift; c < chunksFor(endBin); ++c) {
+         if (_chunk[c]->_refs > 1)
+            _chunk[c] = copyChunk(_chunk[c]);
+      }
+   }
+   return *this;
+}
+
+//------------------------------------------------------------------------------
+// true if no Snapshots (or tables they used) are still around, so nothing is shared.
+/**
+ * Chunks are only shared between tables, so if there are no retired tables
+ * and no Snapshots of the current table, every chunk belongs to the HashSet alone.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+bool HashSet<ITEM, POOL, STATS, BINS>::exclusive ()
+{
+   collect();
+   return !_retired and !tableShared();
+}
+
+//------------------------------------------------------------------------------
+template<class ITEM, class POOL, class STATS, class BINS>
+typename HashSet<ITEM, POOL, STATS, BINS>::BinChunk* HashSet<ITEM, POOL, STATS, BINS>::newChunk (unsigned bins, bool zero)
+{
+   size_t bytes = sizeof(BinChunk) + (bins - 1) * sizeof(HashNode*);
+   BinChunk* chunk = static_cast<BinChunk*>(zero ? calloc(1, bytes) : malloc(bytes));
+   if (!chunk) {
+      throw("Could not allocate memory in Geneva::HashSet.");
+   }
+   chunk->_refs = 1;
+   return chunk;
+}
+
+//------------------------------------------------------------------------------
+template<class ITEM, class POOL, class STATS, class BINS>
+typename HashSet<ITEM, POOL, STATS, BINS>::BinTable* HashSet<ITEM, POOL, STATS, BINS>::newTable (unsigned bins, bool zeroChunks)
+{
+   unsigned chunks = chunksFor(bins);
+   void* memory = malloc(sizeof(BinTable) + (chunks - 1) * sizeof(BinChunk*));
+   if (!memory) {
+      throw("Could not allocate memory in Geneva::HashSet.");
+   }
+   BinTable* table = static_cast<BinTable*>(memory);
+   new(&table->_refs) std::atomic<unsigned>(1);
+   table->_bins = bins;
+   table->_nextRetired = 0;
+   for (unsigned c=0; c<chunks; ++c)
+      table->_chunk[c] = newChunk(chunkBins(bins), zeroChunks);
+   return table;
+}
+
+//------------------------------------------------------------------------------
+// Replaces _table with a copy (pointing to the same chunks), and retires _table.
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::detach ()
+{
+   unsigned chunks = chunksFor(_bins);
+   void* memory = malloc(sizeof(BinTable) + (chunks - 1) * sizeof(BinChunk*));
+   if (!memory) {
+      throw("Could not allocate memory in Geneva::HashSet.");
+   }
+   BinTable* table = static_cast<BinTable*>(memory);
+   new(&table->_refs) std::atomic<unsigned>(1);
+   table->_bins = _bins;
+   table->_nextRetired = 0;
+   for (unsigned c=0; c<chunks; ++c) {
+      table->_chunk[c] = _chunk[c];
+      ++_chunk[c]->_refs;
+   }
+   BinTable* old = _table;
+   installTable(table);
+   retire(old);
+   collect();
+}
+
+//------------------------------------------------------------------------------
+// Returns a copy of chunk (with copies of its nodes), which replaces it in _table.
+template<class ITEM, class POOL, class STATS, class BINS>
+typename HashSet<ITEM, POOL, STATS, BINS>::BinChunk* HashSet<ITEM, POOL, STATS, BINS>::copyChunk (BinChunk* chunk)
+{
+   unsigned bins = chunkBins(_bins);
+   BinChunk* copy = newChunk(bins, false);
+   for (unsigned j=0; j<bins; ++j) {
+      HashNode* head = 0;
+      HashNode** link = &head;
+      for (HashNode const* node = first(chunk->_bin[j]); node; node = node->_next) {
+         *link = new(_pool.alloc()) HashNode(0, node->_item.ex(), node->_hash);
+         link = &((*link)->_next);
+      }
+      copy->_bin[j] = tagged(head, tagOf(chunk->_bin[j]));
+   }
+   --chunk->_refs;
+   return copy;
+}
+
+//------------------------------------------------------------------------------
+// The HashSet lets go of table (which Snapshots may still be using).
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::retire (BinTable* table)
+{
+   table->_refs.fetch_sub(1, std::memory_order_acq_rel);
+   table->_nextRetired = _retired;
+   _retired = table;
+}
+
+//------------------------------------------------------------------------------
+// Frees the retired tables that no Snapshots are using anymore (or all of them if force is true).
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::collect (bool force)
+{
+   BinTable** link = &_retired;
+   while (BinTable* table = *link) {
+      if (force or table->_refs.load(std::memory_order_acquire) == 0) {
+         *link = table->_nextRetired;
+         releaseTable(table, !force);
+      } else {
+         link = &table->_nextRetired;
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Lets go of table's chunks, and frees it. Nodes of chunks nobody uses anymore are freed if freeNodes is true.
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::releaseTable (BinTable* table, bool freeNodes)
+{
+   unsigned chunks = chunksFor(table->_bins);
+   unsigned bins = chunkBins(table->_bins);
+   for (unsigned c=0; c<chunks; ++c) {
+      BinChunk* chunk = table->_chunk[c];
+      if (--chunk->_refs)
+         continue;
+      if (freeNodes) {
+         for (unsigned j=0; j<bins; ++j) {
+            HashNode* node = first(chunk->_bin[j]);
+            while (node) {
+               HashNode* next = node->_next;
+               node->~HashNode();
+               _pool.free(node);
+               node = next;
+            }
+         }
+      }
+      _pool.reclaim(chunk, sizeof(BinChunk) + (bins - 1) * sizeof(HashNode*));
+   }
+   table->_refs.~atomic();
+   free(table);
 }
 
 
@@ -484,29 +1491,49 @@ void HashSet<ITEM, POOL>::resize()
 
 //------------------------------------------------------------------------------
 // Constructor
-template<class ITEM, class POOL>
-HashSet<ITEM, POOL>::ConstIterator::ConstIterator (HashSet const& hashSet)
-: _hashSet(&hashSet), _currentBin(0), _currentNode(0)
+template<class ITEM, class POOL, class STATS, class BINS>
+HashSet<ITEM, POOL, STATS, BINS>::ConstIterator::ConstIterator (HashSet const& hashSet)
+: ConstIterator(&hashSet._table, 0, hashSet._bins)
+{}
+
+//------------------------------------------------------------------------------
+// Constructor for a range of bins
+template<class ITEM, class POOL, class STATS, class BINS>
+HashSet<ITEM, POOL, STATS, BINS>::ConstIterator::ConstIterator (HashSet const& hashSet, unsigned beginBin, unsigned endBin)
+: ConstIterator(&hashSet._table, beginBin, endBin)
+{}
+
+//------------------------------------------------------------------------------
+// Constructor for a range of bins of a table (which belongs to a HashSet or a Snapshot)
+/**
+ * The Iterator keeps a pointer to the HashSet's (or Snapshot's) table pointer,
+ * so it keeps working if the HashSet replaces its table to copy bins that
+ * Snapshots share.
+ */
+template<class ITEM, class POOL, class STATS, class BINS>
+HashSet<ITEM, POOL, STATS, BINS>::ConstIterator::ConstIterator (BinTable* const* table, unsigned beginBin, unsigned endBin)
+: _table(table), _currentBin(beginBin), _endBin(*table and endBin < (*table)->_bins ? endBin : (*table ? (*table)->_bins : 0)),
+_currentNode(0)
 {
    findNextUsedBin();
-   if (_currentBin < _hashSet->_bins)
-      _currentNode = _hashSet->_bin[_currentBin];
+   if (_currentBin < _endBin)
+      _currentNode = first(binOf(*_table, _currentBin));
 }
 
 //------------------------------------------------------------------------------
 // Makes the Iterator point to the next ITEM in the HashSet.
-template<class ITEM, class POOL>
-typename HashSet<ITEM, POOL>::ConstIterator& HashSet<ITEM, POOL>::ConstIterator::operator++ ()
+template<class ITEM, class POOL, class STATS, class BINS>
+typename HashSet<ITEM, POOL, STATS, BINS>::ConstIterator& HashSet<ITEM, POOL, STATS, BINS>::ConstIterator::operator++ ()
 {
    if (_currentNode->_next) {
       _currentNode = _currentNode->_next;
    } else {
       ++_currentBin;
       findNextUsedBin();
-      if (_currentBin == _hashSet->_bins) {
+      if (_currentBin >= _endBin) {
          _currentNode = 0;
       } else {
-         _currentNode = _hashSet->_bin[_currentBin];
+         _currentNode = first(binOf(*_table, _currentBin));
       }
    }
    return *this;
@@ -515,12 +1542,12 @@ typename HashSet<ITEM, POOL>::ConstIterator& HashSet<ITEM, POOL>::ConstIterator:
 //------------------------------------------------------------------------------
 // Sets _currentBin to the index of the next nonempty bin in _hashSet.
 /**
- *If there are no more nonempty bins, _currentBin will be equal to _hashSet->_bins.
+ *If there are no more nonempty bins, _currentBin will be equal to _endBin.
  */
-template<class ITEM, class POOL>
-void HashSet<ITEM, POOL>::ConstIterator::findNextUsedBin ()
+template<class ITEM, class POOL, class STATS, class BINS>
+void HashSet<ITEM, POOL, STATS, BINS>::ConstIterator::findNextUsedBin ()
 {
-   while ( (_currentBin < _hashSet->_bins) and !(_hashSet->_bin[_currentBin]) )
+   while ( (_currentBin < _endBin) and !binOf(*_table, _currentBin) )
       ++_currentBin;
 }
 
@@ -64,12 +64,23 @@ public:
 // Members
 private:
    Link* _first;     // Must be first, so it looks like a Link 
+   Link* _last;
    unsigned _items;
 
+   // A sorted chain of Links (for sort and merge)
+   struct Run {
+      Link* first;
+      Link* last;
+   };
+   // Compares ITEMs with <
+   struct Less {
+      bool operator() (typename Wrap<ITEM>::CRef a, typename Wrap<ITEM>::CRef b) const { return a < b; }
+   };
+
 // Interface
 public:
    // Constructor
-   LinkedList (): _first(0), _items(0) {}
+   LinkedList (): _first(0), _last(0), _items(0) {}
 
    // Destructor
    ~LinkedList ();
@@ -109,6 +120,20 @@ public:
    inline void leakFirst ();
    // Leaks all the links in the LinkedList.
    inline void leakAll ();
+
+   // Moves all of other's links after itr (use dummyItr to put them first).
+   inline void splice (Itr itr, LinkedList& other);
+   // Moves all of other's links to the end.
+   inline void append (LinkedList& other);
+   // Moves other's links into this sorted list, keeping it sorted (other must be sorted too).
+   void merge (LinkedList& other) { merge(other, Less()); }
+   template<typename LESS> void merge (LinkedList& other, LESS less);
+   // Sorts the links (stably, without allocating).
+   void sort () { sort(Less()); }
+   template<typename LESS> void sort (LESS less);
+
+private:
+   template<typename LESS> static Run merge (Run a, Run b, LESS& less);
 };
 
 
@@ -134,6 +159,8 @@ LinkedList<ITEM>::~LinkedList () {
 template<typename ITEM>
 void LinkedList<ITEM>::add (typename Wrap<ITEM>::Ex item) {
    _first = new Link(_first, item);
+   if (!_last)
+      _last = _first;
    ++_items;
 }
 
@@ -142,6 +169,8 @@ void LinkedList<ITEM>::add (typename Wrap<ITEM>::Ex item) {
 template<typename ITEM>
 void LinkedList<ITEM>::add (typename Wrap<ITEM>::Ex item, MemoryPool& pool) {
    _first = new(pool.alloc(sizeof(Link))) Link(_first, item);
+   if (!_last)
+      _last = _first;
    ++_items;
 }
 
@@ -149,7 +178,10 @@ void LinkedList<ITEM>::add (typename Wrap<ITEM>::Ex item, MemoryPool& pool) {
 template<typename ITEM>
 typename LinkedList<ITEM>::Itr LinkedList<ITEM>::add (Itr itr, typename Wrap<ITEM>::Ex item) {
    ++_items;
-   return Itr(itr.link()->_next = new Link(itr.link()->_next, item));
+   Link* link = itr.link()->_next = new Link(itr.link()->_next, item);
+   if (!link->_next)
+      _last = link;
+   return Itr(link);
 }
 
 //------------------------------------------------------------------------------
@@ -158,6 +190,8 @@ template<typename ITEM>
 void LinkedList<ITEM>::addLink (Link* link) {
    link->_next = _first;
    _first = link;
+   if (!_last)
+      _last = link;
    ++_items;
 }
 
@@ -168,6 +202,8 @@ typename Wrap<ITEM>::T LinkedList<ITEM>::removeNext (Link* parent) {
    Link* temp = parent->_next;
    typename Wrap<ITEM>::T item = temp->_item.t();
    parent->_next = temp->_next;
+   if (temp == _last)
+      _last = _items == 1 ? 0 : parent;
    delete temp;
    --_items;
    return item;
@@ -190,6 +226,7 @@ void LinkedList<ITEM>::removeAll () {
       link1 = link2;
    }
    _first = 0;
+   _last = 0;
    _items = 0;
 }
 
@@ -198,6 +235,8 @@ void LinkedList<ITEM>::removeAll () {
 // This causes a memory leak, unless everything is in a MemoryPool.
 template<typename ITEM>
 void LinkedList<ITEM>::leakNext (Link* parent) {
+   if (parent->_next == _last)
+      _last = _items == 1 ? 0 : parent;
    parent->_next = parent->_next->_next;
    --_items;
 }
@@ -212,13 +251,118 @@ void LinkedList<ITEM>::leakFirst () {
 template<typename ITEM>
 void LinkedList<ITEM>::leakAll () {
    _first = 0;
+   _last = 0;
    _items = 0;
 }
 
+//------------------------------------------------------------------------------
+// Moves all of other's links after itr, in O(1).
+template<typename ITEM>
+void LinkedList<ITEM>::splice (Itr itr, LinkedList& other) {
+   if (!other._first)
+      return;
+   Link* parent = itr.link();
+   other._last->_next = parent->_next;
+   parent->_next = other._first;
+   if (!other._last->_next)
+      _last = other._last;
+   _items += other._items;
+   other.leakAll();
+}
+
+//------------------------------------------------------------------------------
+// Moves all of other's links to the end, in O(1).
+template<typename ITEM>
+void LinkedList<ITEM>::append (LinkedList& other) {
+   splice(_last ? Itr(_last) : dummyItr(), other);
+}
+
 
 //==============================================================================
 // Method Definitions
 //==============================================================================
 
+//------------------------------------------------------------------------------
+// Moves other's links into this list. Both must be sorted by less.
+// Equal items from this list stay ahead of those from other.
+template<typename ITEM>
+template<typename LESS>
+void LinkedList<ITEM>::merge (LinkedList& other, LESS less) {
+   if (!other._first)
+      return;
+   if (!_first) {
+      splice(dummyItr(), other);
+      return;
+   }
+   Run a = {_first, _last};
+   Run b = {other._first, other._last};
+   Run run = merge(a, b, less);
+   _first = run.first;
+   _last = run.last;
+   _items += other._items;
+   other.leakAll();
+}
+
+//------------------------------------------------------------------------------
+// Sorts the links by less, keeping equal items in order.
+// This is a bottom-up merge sort on the chain itself: run[i] holds a
+// sorted run of 2^i links (or none), and each link is carried in like a
+// binary increment, so the only extra memory is the array of runs.
+template<typename ITEM>
+template<typename LESS>
+void LinkedList<ITEM>::sort (LESS less) {
+   Run runs[64];
+   unsigned used = 0;
+   Link* rest = _first;
+   while (rest) {
+      Run run = {rest, rest};
+      rest = rest->_next;
+      run.last->_next = 0;
+      unsigned i = 0;
+      for (; i<used and runs[i].first; ++i) {
+         run = merge(runs[i], run, less);
+         runs[i].first = 0;
+      }
+      if (i == used)
+         ++used;
+      runs[i] = run;
+   }
+   Run sorted = {0, 0};
+   for (unsigned i=0; i<used; ++i) {
+      if (runs[i].first)
+         sorted = sorted.first ? merge(runs[i], sorted, less) : runs[i];
+   }
+   _first = sorted.first;
+   _last = sorted.last;
+}
+
+//------------------------------------------------------------------------------
+// Merges two sorted, null terminated chains, taking from a first when items are equal.
+template<typename ITEM>
+template<typename LESS>
+typename LinkedList<ITEM>::Run LinkedList<ITEM>::merge (Run a, Run b, LESS& less) {
+   Run run;
+   Link** next = &run.first;
+   while (true) {
+      if (less(b.first->_item.cref(), a.first->_item.cref())) {
+         *next = b.first;
+         next = &b.first->_next;
+         if (!(b.first = b.first->_next)) {
+            *next = a.first;
+            run.last = a.last;
+            return run;
+         }
+      } else {
+         *next = a.first;
+         next = &a.first->_next;
+         if (!(a.first = a.first->_next)) {
+            *next = b.first;
+            run.last = b.last;
+            return run;
+         }
+      }
+   }
+}
+
 
 #endif // ESTDLIB_LINKED_LIST
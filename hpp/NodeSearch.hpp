@@ -0,0 +1,119 @@
+//==============================================================================
+// NodeSearch.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_NODE_SEARCH
+#define ESTDLIB_NODE_SEARCH
+
+#include <cstdint>
+#include "Wrap.hpp"
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+
+//==============================================================================
+// Struct NodeSearch
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/// Counts the items in a sorted node that are less than a key.
+/**
+ * The count is the position of the first item not less than key, which is
+ * all a search within a B+-tree node (or any small sorted array) needs. In
+ * general this is a branchless binary search. For 32 bit integers it
+ * compares the whole node with SSE2 (or AVX2 when compiled with -mavx2 or
+ * -march=native) and adds up the matches, which takes fewer instructions
+ * than the binary search and has no branches that depend on the key. 64 bit
+ * integers do the same when SSE4.2 or AVX2 is enabled. (Unsigned integers
+ * are compared as signed ones, with their top bits flipped.) Since the node
+ * is sorted, the lanes less than key in each block are the first ones, so
+ * they are counted with count trailing zeros rather than popcount (which is
+ * a library call unless the target has POPCNT).
+ */
+struct NodeSearch {
+   template<typename W, typename KEY>
+   static unsigned countLess (W const* items, unsigned count, KEY const& key) {
+      if (count == 0)
+         return 0;
+      W const* base = items;
+      while (count > 1) {
+         unsigned half = count / 2;
+         base = base[half].cref() < key ? base + half : base;
+         count -= half;
+      }
+      return (base - items) + (base->cref() < key);
+   }
+
+#if defined(__x86_64__) || defined(_M_X64)
+   static unsigned countLess (Wrap<int> const* items, unsigned count, int key) {
+      return countLess32(reinterpret_cast<int const*>(items), count, key, 0);
+   }
+   static unsigned countLess (Wrap<unsigned> const* items, unsigned count, unsigned key) {
+      return countLess32(reinterpret_cast<int const*>(items), count, key, INT32_MIN);
+   }
+#if defined(__SSE4_2__) || defined(__AVX2__)
+   static unsigned countLess (Wrap<std::int64_t> const* items, unsigned count, std::int64_t key) {
+      return countLess64(reinterpret_cast<std::int64_t const*>(items), count, key, 0);
+   }
+   static unsigned countLess (Wrap<std::uint64_t> const* items, unsigned count, std::uint64_t key) {
+      return countLess64(reinterpret_cast<std::int64_t const*>(items), count, key, INT64_MIN);
+   }
+#endif
+
+private:
+   // Counts the set bits in a movemask whose set bits are all at the bottom.
+   static unsigned lanes (int mask) {
+      return __builtin_ctz(~static_cast<unsigned>(mask));
+   }
+
+   static unsigned countLess32 (int const* items, unsigned count, int key, int flip) {
+      key ^= flip;
+      unsigned less = 0, i = 0;
+#ifdef __AVX2__
+      __m256i keys8 = _mm256_set1_epi32(key);
+      __m256i flip8 = _mm256_set1_epi32(flip);
+      for (; i + 8 <= count; i += 8) {
+         __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(items + i)), flip8);
+         less += lanes(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(keys8, block))));
+      }
+#endif
+      __m128i keys4 = _mm_set1_epi32(key);
+      __m128i flip4 = _mm_set1_epi32(flip);
+      for (; i + 4 <= count; i += 4) {
+         __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(items + i)), flip4);
+         less += lanes(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(keys4, block))));
+      }
+      for (; i < count; ++i)
+         less += (items[i] ^ flip) < key;
+      return less;
+   }
+
+#if defined(__SSE4_2__) || defined(__AVX2__)
+   static unsigned countLess64 (std::int64_t const* items, unsigned count, std::int64_t key, std::int64_t flip) {
+      key ^= flip;
+      unsigned less = 0, i = 0;
+#ifdef __AVX2__
+      __m256i keys4 = _mm256_set1_epi64x(key);
+      __m256i flip4 = _mm256_set1_epi64x(flip);
+      for (; i + 4 <= count; i += 4) {
+         __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(items + i)), flip4);
+         less += lanes(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(keys4, block))));
+      }
+#endif
+      __m128i keys2 = _mm_set1_epi64x(key);
+      __m128i flip2 = _mm_set1_epi64x(flip);
+      for (; i + 2 <= count; i += 2) {
+         __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(items + i)), flip2);
+         less += lanes(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(keys2, block))));
+      }
+      for (; i < count; ++i)
+         less += (items[i] ^ flip) < key;
+      return less;
+   }
+#endif
+#endif
+};
+
+#endif // ESTDLIB_NODE_SEARCH
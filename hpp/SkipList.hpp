@@ -4,19 +4,53 @@
 #include <iostream>
 #include <cstdlib>
 #include <string.h>
-#include "MemoryPool.h"
+#include <new>
+#include <vector>
+#include "MemoryPoolF.h"
 #include "Wrap.hpp"
 #include "Random.h"
+#include "SkipListStats.hpp"
 
 
 //==============================================================================
 // A skiplist.
 //==============================================================================
 /**
- * Need description of memory layout!
+ * Each Link holds an item and an array of next pointers, one for each lane it
+ * is in. Links with the same number of lanes are the same size, so they are
+ * allocated from one MemoryPoolF per lane count, and removed Links are freed
+ * back to it to be reused.
+ *
+ * The number of lanes grows as items are added (see resize). Once removals
+ * bring the number of items well below the point at which the top lane was
+ * added, the top lane is dropped again (see shrink). Links keep the memory for
+ * the lanes they were allocated with, so they still go back to the right pool.
+ *
+ * Each express lane also records its width: how many places on the next Link
+ * in it is. (In lane 0 that is always 1, so it isn't stored, and Links in lane
+ * 0 only are no bigger for it.) Searches add up the widths they skip over,
+ * which finds an item's index (rank) or the item at an index (at) in
+ * O(log n).
+ *
+ * _lastStops is left holding the last stops of the latest add or remove, which
+ * makes it a finger: add(hint, item) climbs from the hint and from those stops
+ * only as far up as it has to, so runs of nearby inserts (sorted, reverse
+ * sorted or clustered) cost O(1) expected instead of O(log n) each.
+ *
+ * Lanes are normally drawn at random (from _rand). With deterministic lanes
+ * (setDeterministicLanes) nothing random is drawn: a new Link goes into lane
+ * L (as well as every lane below it) when the span it lands in there is more
+ * than 1.5 stride^L places wide, stride being 1/linkProb. So no span grows
+ * far past that before an add splits it, the layout depends only on the
+ * order items were added in, and it comes out the same on every run. Removes
+ * don't move Links up or down; removing a tall Link merges two spans, which
+ * the next adds into it split again.
+ *
+ * STATS is told the Links each search steps onto and the lanes it drops down
+ * (see SkipListStats.hpp). The default, NoSkipListStats, counts nothing.
  */
 
-template<typename ITEM>
+template<typename ITEM, typename STATS = NoSkipListStats>
 class SkipList {
 // SubClasses
 private:
@@ -25,20 +59,27 @@ private:
    /// The links that form the list.
    struct Link {
       W item;
+      unsigned short lanes; ///< number of lanes it is linked into
+      unsigned short size;  ///< number of lanes it has room for (the pool it came from)
       Link* next; // this is really the first item in an array of pointers to Links
-      // express lanes go here
+      // express lanes go here, followed by their widths
       
-      Link (typename W::Ex item): item(item) {}   // next is always set after construction
+      Link (typename W::Ex item, unsigned lanes): item(item), lanes(lanes), size(lanes) {}   // next is always set after construction
       Link*& nextInLane (unsigned lane) { return (&next)[lane]; }
       Link* const& nextInLane (unsigned lane) const { return (&next)[lane]; }
+      // Places from this Link to the next one in an express lane (lane > 0), or to size()+1 if there is none.
+      unsigned& widthInLane (unsigned lane) { return reinterpret_cast<unsigned*>(&next + size)[lane-1]; }
+      unsigned widthInLane (unsigned lane) const { return reinterpret_cast<unsigned const*>(&next + size)[lane-1]; }
+      unsigned width (unsigned lane) const { return lane ? widthInLane(lane) : 1; }
       // Returns the amount of extra memory required for a Link with the specified number of lanes.
       // This much memory must be placed immediately after the Link itself.
-      static unsigned footprint (unsigned lanes) { return sizeof(Link) + (lanes-1)*sizeof(Link*); }
+      static unsigned footprint (unsigned lanes) { return sizeof(Link) + (lanes-1)*(sizeof(Link*) + sizeof(unsigned)); }
    };
 
 public:
    /// Cautiously iterates over the SkipList.
    class ConstIterator {
+   friend class SkipList;
    protected:
       Link const* _current;
    public:
@@ -78,9 +119,9 @@ public:
 
 // Member data
 private:
-   MemoryPool* _pool;   ///< memory pool where links are created
+   MemoryPoolF** _pools;   ///< _pools[i] holds the Links with i+1 lanes (_classes long array)
+   unsigned _classes;   ///< number of pools (the most lanes the SkipList has had)
    XorShift32* _rand;   ///< random number generator
-   bool _sharedPool;    ///< true if the MemoryPool is shared (and thus should not be deleted)
    bool _sharedRand;    ///< true if the random number generator is shared (and thus should not be deleted)
    unsigned _lanes;     ///< Number of lanes (starts at 1). Every Link links to lane 0.
    Link* _head;         ///< Points to dummy link at head of the list.
@@ -89,19 +130,42 @@ private:
    unsigned* _items;
    float _linkProb;    ///< probability of new entry linking to lane n is _linkProb^n
    float _trigger;     ///< new lane is added when _items[0] exceeds _trigger == 1/(_linkProb^_lanes)
+   unsigned _stride;   ///< 1/_linkProb, rounded (at least 2): the spacing of Links in each lane over the one below
+   bool _deterministic; ///< true if lanes are chosen by the spans a new Link lands in rather than at random
+   mutable STATS _stats; ///< counts the costs of searches (see SkipListStats.hpp)
    
    // Working Memory
    /// Points to last Links visited in each lane. Used for insertions.
-   /** This should be pulled off the stack when needed, not stored here. */
+   /** Each is _head or a Link in its lane, and together they are the last
+    * stops of the latest add or remove (the finger add(hint, item) starts
+    * from). */
    Link** _lastStops;
+   unsigned* _lastRanks; ///< index+1 of each of _lastStops (0 for _head)
    
 // Interface
 public:
-   SkipList (unsigned initialCapacity, float linkProb = 0.25, MemoryPool* pool = 0, XorShift32* rand = 0);
+   SkipList (unsigned initialCapacity, float linkProb = 0.25, XorShift32* rand = 0);
    ~SkipList ();
    
    /// Adds a new ITEM to the SkipList.
    Iterator add (typename W::Ex item);
+   /// Adds a new ITEM to the SkipList, searching from hint (best if at or just before where it goes).
+   Iterator add (ConstIterator hint, typename W::Ex item);
+   /// Fills an empty SkipList with the sorted ITEMs from begin to end (forward iterators), in one pass.
+   template<typename ITR> void buildSorted (ITR begin, ITR end, bool randomLanes = false);
+   /// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+   template<typename KEY> bool remove (KEY const& key);
+   /// Removes the ITEM itr points to, and returns an Iterator to the ITEM after it.
+   Iterator remove (ConstIterator itr);
+   Iterator remove (Iterator itr) { return remove(static_cast<ConstIterator>(itr)); }
+   /// Removes the ITEM at index (counting from 0). Returns false if there isn't one.
+   bool erase (unsigned index);
+
+   /// Returns an Iterator to the ITEM at index (counting from 0), or an invalid one if there isn't one.
+   Iterator at (unsigned index);
+   ConstIterator at (unsigned index) const { return const_cast<SkipList*>(this)->at(index); }
+   /// Returns the number of ITEMs less than key (the index of the first one not less).
+   template<typename KEY> unsigned rank (KEY const& key) const;
 
    /// Attempts to find an ITEM in the SkipList with the specified KEY.
    template<typename KEY> Iterator find (KEY const& key);
@@ -112,6 +176,11 @@ public:
    
    /// Attempts to find an ITEM in the SkipList with the specified KEY.
    template<typename KEY> ConstIterator find (KEY const& key) const;
+
+   /// Attempts to find an ITEM with the specified KEY, searching from hint (best if just before it).
+   template<typename KEY> Iterator find (ConstIterator hint, KEY const& key);
+   /// Attempts to find an ITEM with the specified KEY, searching from hint (best if just before it).
+   template<typename KEY> ConstIterator find (ConstIterator hint, KEY const& key) const;
    /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY.
    template<typename KEY> ConstIterator findLow (KEY const& key) const;
    /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY.
@@ -124,16 +193,43 @@ public:
    
    /// Returns the number of items in the SkipList. 
    unsigned size () const { return _items[0]; } 
+   /// Chooses whether the lanes of new Links are random (the default) or set by where they go.
+   void setDeterministicLanes (bool deterministic) { _deterministic = deterministic; }
    
 // Private Methods
 private:
    void resize ();
+   void shrink ();
+   void sizePools ();
+   /// Fills _lastStops with the last Link before key in each lane.
+   template<typename KEY> void findLastStops (KEY const& key);
+   /// Fills _lastStops with the last Link before key in each lane, starting from hint and the finger.
+   template<typename KEY> void findLastStops (ConstIterator hint, KEY const& key);
+   /// Fills _lastStops with the last Link before place (index+1) in each lane.
+   void findLastStopsAt (unsigned place);
+   /// Brings _lastStops[low] and above up to date for key, from the finger.
+   template<typename KEY> void moveFinger (KEY const& key, unsigned low);
+   /// Returns the last Link before key reached from link, and the highest lane it got to.
+   template<typename KEY> Link* climb (Link* link, KEY const& key, unsigned& lane) const;
+   /// Returns the last Link before key, descending from link in lane.
+   template<typename KEY> Link* descend (Link* link, KEY const& key, unsigned lane) const;
+   /// Counts a new Link in _items (adding a lane if needed), and returns how many lanes it gets (0 if it's up to insert).
+   unsigned countNewLink ();
+   /// Links a new Link holding item in after _lastStops.
+   Iterator insert (typename W::Ex item, unsigned newLanes);
+   void unlink (Link* link, unsigned place);
    unsigned chooseNewLanes () const;
+   /// Returns how many lanes a new Link going in after _lastStops gets with deterministic lanes.
+   unsigned chooseSpannedLanes () const;
 
 // Debug Methods
 public:
    void printStats () const;
    void print () const;
+   /// Returns the number of Links a search for key compares it to.
+   template<typename KEY> unsigned pathLength (KEY const& key) const;
+   /// Returns the STATS policy, which has counted the costs of the operations so far.
+   STATS& stats () const { return _stats; }
 };
 
 
@@ -143,39 +239,38 @@ public:
 
 //------------------------------------------------------------------------------
 // Constructor
-template<typename ITEM>
-SkipList<ITEM>::SkipList (unsigned initialCapacity, float linkProb, MemoryPool* pool, XorShift32* rand)
-   : _lanes(1), _linkProb(linkProb), _trigger(1.0/linkProb)
+template<typename ITEM, typename STATS>
+SkipList<ITEM, STATS>::SkipList (unsigned initialCapacity, float linkProb, XorShift32* rand)
+   : _lanes(1), _linkProb(linkProb), _trigger(1.0/linkProb), _deterministic(false)
 {
    // Ensure linkProb is valid.
    if (0.0 >= _linkProb or _linkProb >= 1.0) {
       throw("Error from SkipList constructor: linkProb must be between 0 and 1.\n");
    }
+   _stride = static_cast<unsigned>(1.0/_linkProb + 0.5);
+   if (_stride < 2)
+      _stride = 2;
 
-   // Find the right number of lanes to start out with,
-   // and calculate how much memory we expect these lanes to take up.
-   float inverseLinkProb = _trigger;
-   float compoundedLinkProb = _linkProb; // prob of linking to fastest lane
+   // Find the right number of lanes to start out with.
    // The values calculated in this loop could be done in closed form
-   // (logs for lanes and trigger, powers for compounded)
+   // (logs for lanes and trigger)
    // but the performance loss should not be great since lanes is usually small.
    // (Even with 100,000 items and p = 1/4, lanes will only be 8.)
+   float inverseLinkProb = _trigger;
    while (initialCapacity > static_cast<unsigned>(_trigger)) {
       ++_lanes;
       _trigger *= inverseLinkProb;
-      compoundedLinkProb *= _linkProb;
    }
-   float probSum = (1.0 - compoundedLinkProb) / (1.0 - _linkProb);
 
-   // Set up MemoryPool
-   if (pool) {
-      _sharedPool = true;
-      _pool = pool;
-   } else {
-      _sharedPool = false;
-      unsigned linkMemory = static_cast<unsigned>( static_cast<float>(initialCapacity)*probSum ) * sizeof(Link*);
-      _pool = new MemoryPool(initialCapacity*sizeof(W) + linkMemory, sizeof(ITEM*));
+   // Set up a MemoryPoolF for each number of lanes.
+   _classes = _lanes;
+   _pools = static_cast<MemoryPoolF**> (malloc(_classes * sizeof(MemoryPoolF*)));
+   for (unsigned i=0; i<_classes; ++i) {
+      _pools[i] = new MemoryPoolF;
+      _pools[i]->setItemSize(Link::footprint(i+1), alignof(Link));
+      _pools[i]->setMinFree(1);
    }
+   sizePools();
 
    // Set up random number generator
    if (rand) {
@@ -188,215 +283,435 @@ SkipList<ITEM>::SkipList (unsigned initialCapacity, float linkProb, MemoryPool*
 
    // Allocate other members.
    _head      = static_cast<Link*>     (calloc(1, Link::footprint(_lanes)));
-   _lastStops = static_cast<Link**>    (calloc(_lanes, sizeof(Link*)));
+   _lastStops = static_cast<Link**>    (malloc(_lanes * sizeof(Link*)));
+   _lastRanks = static_cast<unsigned*> (calloc(_lanes, sizeof(unsigned)));
    _items     = static_cast<unsigned*> (calloc(_lanes, sizeof(unsigned)));
+   _head->lanes = _head->size = _lanes;
+   for (unsigned i=0; i<_lanes; ++i) {
+      _lastStops[i] = _head;
+      if (i)
+         _head->widthInLane(i) = 1;
+   }
 }
 
 //------------------------------------------------------------------------------
 // Destructor
-template<typename ITEM>
-inline SkipList<ITEM>::~SkipList ()
+template<typename ITEM, typename STATS>
+inline SkipList<ITEM, STATS>::~SkipList ()
 {
    free(_head);
    free(_lastStops);
+   free(_lastRanks);
    free(_items);
-   if (!_sharedPool)
-      delete _pool;
+   for (unsigned i=0; i<_classes; ++i)
+      delete _pools[i];
+   free(_pools);
+   if (!_sharedRand)
+      delete _rand;
 }
 
 //------------------------------------------------------------------------------
 // Adds an ITEM to the SkipList.
-template<typename ITEM>
-typename SkipList<ITEM>::Iterator SkipList<ITEM>::add (typename W::Ex item)
+template<typename ITEM, typename STATS>
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::add (typename W::Ex item)
 {
-   unsigned newLanes;
-
-   // If we will have more than _trigger items, resize and force the new entry to link to all lanes.
-   if (++_items[0] > static_cast<unsigned>(_trigger)) {
-      resize();
-      newLanes = _lanes;
-   } else {
-      newLanes = chooseNewLanes(); // Otherwise choose a random number of express lanes to link to.
-   }
-   
-   // Incremement lane counts for each express lane used by the new Link. (We already incremented _item[0].)
-   for (unsigned i=1; i<newLanes; ++i)
-      ++_items[i];
+   unsigned newLanes = countNewLink();
    
    // Find where to insert the new item, remembering where we have to change lanes (using _lastStops).
    // We need to remember where these stops are so we can update the relevant pointers later.
+   findLastStops(item);
+   _stats.added();
+   return insert(item, newLanes);
+}
+
+//------------------------------------------------------------------------------
+// Adds an ITEM to the SkipList, searching from hint.
+/**
+ * Any hint gives the right result, but the search is only short if hint is at
+ * or just before where item goes (such as the Iterator the last add returned,
+ * when items arrive in order), or if item goes near the last item added or
+ * removed.
+ */
+template<typename ITEM, typename STATS>
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::add (ConstIterator hint, typename W::Ex item)
+{
+   unsigned newLanes = countNewLink();
+   findLastStops(hint, item);
+   _stats.added();
+   return insert(item, newLanes);
+}
+
+//------------------------------------------------------------------------------
+// Fills an empty SkipList with the sorted ITEMs from begin to end, in one pass.
+/**
+ * Nothing is searched for: each Link is appended to every lane it is in. By
+ * default lanes are dealt out evenly (every 1/linkProb-th item gets a second
+ * lane, every 1/linkProb^2-th a third, and so on), so the lanes are perfectly
+ * balanced; randomLanes draws them the way add does instead.
+ *
+ * The lanes are chosen in a first pass (which also checks the order), so each
+ * pool can make room for all of its Links at once. Links are then allocated
+ * in key order, so the Links with the same number of lanes (three quarters of
+ * them are in lane 0 only, with linkProb = 1/4) are laid out contiguously in
+ * the order a scan visits them.
+ */
+template<typename ITEM, typename STATS>
+template<typename ITR>
+void SkipList<ITEM, STATS>::buildSorted (ITR begin, ITR end, bool randomLanes)
+{
+   if (_items[0]) {
+      throw("Error from SkipList::buildSorted: the SkipList must be empty.\n");
+   }
+
+   // Choose the lanes for each item (and check the order).
+   std::vector<unsigned char> lanes;
+   for (ITR itr = begin, prev = begin; itr != end; prev = itr++) {
+      if (itr != begin and cref(*itr) < cref(*prev)) {
+         throw("Error from SkipList::buildSorted: the items are not sorted.\n");
+      }
+      lanes.push_back(0);
+   }
+   unsigned items = lanes.size();
+   while (items > static_cast<unsigned>(_trigger))
+      resize();
+
+   std::vector<unsigned> links(_lanes, 0);
+   for (unsigned i=0; i<items; ++i) {
+      unsigned newLanes;
+      if (randomLanes) {
+         newLanes = chooseNewLanes();
+      } else {
+         newLanes = 1;
+         for (unsigned n = i+1; newLanes < _lanes and n % _stride == 0; n /= _stride)
+            ++newLanes;
+      }
+      lanes[i] = newLanes;
+      ++links[newLanes-1];
+   }
+   for (unsigned i=0; i<_lanes; ++i) {
+      if (_pools[i]->freeItemsTotal() < links[i])
+         _pools[i]->allocBlock(links[i]);
+   }
+
+   // Append each Link to its lanes, using _lastStops for the tails (which leaves them as the finger).
+   for (unsigned i=0; i<_lanes; ++i) {
+      _lastStops[i] = _head;
+      _lastRanks[i] = 0;
+   }
+   unsigned i = 0;
+   for (ITR itr = begin; itr != end; ++itr, ++i) {
+      Link* newLink = new( _pools[lanes[i]-1]->alloc() ) Link(*itr, lanes[i]);
+      for (unsigned lane=0; lane < lanes[i]; ++lane) {
+         _lastStops[lane]->nextInLane(lane) = newLink;
+         if (lane)
+            _lastStops[lane]->widthInLane(lane) = i+1 - _lastRanks[lane];
+         _lastStops[lane] = newLink;
+         _lastRanks[lane] = i+1;
+         ++_items[lane];
+      }
+   }
+   for (unsigned lane=0; lane<_lanes; ++lane) {
+      _lastStops[lane]->nextInLane(lane) = 0;
+      if (lane)
+         _lastStops[lane]->widthInLane(lane) = items+1 - _lastRanks[lane];
+   }
+}
+
+//------------------------------------------------------------------------------
+// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+template<typename ITEM, typename STATS>
+template<typename KEY>
+bool SkipList<ITEM, STATS>::remove (KEY const& key)
+{
+   findLastStops(key);
+   Link* link = _lastStops[0]->next;
+   if (!link or !(link->item.cref() == cref(key))) {
+      _stats.removed();
+      return false;
+   }
+   unlink(link, _lastRanks[0] + 1);
+   _stats.removed();
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Removes the ITEM itr points to, and returns an Iterator to the ITEM after it.
+/**
+ * Iterators to other ITEMs remain valid.
+ */
+template<typename ITEM, typename STATS>
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::remove (ConstIterator itr)
+{
+   Link* link = const_cast<Link*>(itr._current);
+   Link* next = link->next;
+   findLastStops(link->item.cref());
+   unsigned place = _lastRanks[0] + 1;
+   for (Link* stop = _lastStops[0]->next; stop != link; stop = stop->next) {
+      ++place;
+      _stats.step();
+   }
+   unlink(link, place);
+   _stats.removed();
+   return Iterator(next);
+}
+
+//------------------------------------------------------------------------------
+// Removes the ITEM at index (counting from 0). Returns false if there isn't one.
+template<typename ITEM, typename STATS>
+bool SkipList<ITEM, STATS>::erase (unsigned index)
+{
+   if (index >= _items[0])
+      return false;
+   findLastStopsAt(index + 1);
+   unlink(_lastStops[0]->next, index + 1);
+   _stats.removed();
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to the ITEM at index (counting from 0), or an invalid one if there isn't one.
+template<typename ITEM, typename STATS>
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::at (unsigned index)
+{
+   if (index >= _items[0])
+      return Iterator();
+
+   // Skip ahead while that doesn't pass the ITEM's place (index+1, counting _head as 0).
    unsigned lane = _lanes-1;
-   _lastStops[lane] = _head;
+   unsigned rank = 0;
+   Link* currentLink = _head;
    while (true) {
-      while (_lastStops[lane]->nextInLane(lane) and _lastStops[lane]->nextInLane(lane)->item.cref() < item) {
-         _lastStops[lane] = _lastStops[lane]->nextInLane(lane);
+      while (rank + currentLink->width(lane) <= index + 1) {
+         rank += currentLink->width(lane);
+         currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
-
       if (lane == 0) {
          break;
       } else {
-         _lastStops[lane-1] = _lastStops[lane];
          --lane;
+         _stats.drop();
       }
    }
-   
-   // Allocate memory for new Link.
-   Link* newLink = new( _pool->alloc(Link::footprint(newLanes)) ) Link(item);
-   
-   // Link in all forward pointing pointers of the new Link. (Note that lane == 0 at this point.)
-   while (lane < newLanes) {
-      newLink->nextInLane(lane) = _lastStops[lane]->nextInLane(lane);
-      _lastStops[lane]->nextInLane(lane) = newLink;
-      ++lane;
-   }
+   _stats.found();
+   return Iterator(currentLink);
+}
 
-   // Return an Iterator pointing to the new Link.
-   return Iterator(newLink);
+//------------------------------------------------------------------------------
+// Returns the number of ITEMs less than key (the index of the first one not less).
+template<typename ITEM, typename STATS>
+template<typename KEY>
+unsigned SkipList<ITEM, STATS>::rank (KEY const& key) const
+{
+   unsigned lane = _lanes-1;
+   unsigned rank = 0;
+   Link const* currentLink = _head;
+   while (true) {
+      while (currentLink->nextInLane(lane) and currentLink->nextInLane(lane)->item.cref() < cref(key)) {
+         rank += currentLink->width(lane);
+         currentLink = currentLink->nextInLane(lane);
+         _stats.step();
+      }
+      if (lane == 0) {
+         break;
+      } else {
+         --lane;
+         _stats.drop();
+      }
+   }
+   _stats.found();
+   return rank;
 }
 
 //------------------------------------------------------------------------------
 // Attempts to find an ITEM in the SkipList with the specified KEY.
-template<typename ITEM>
+template<typename ITEM, typename STATS>
 template<typename KEY>
-typename SkipList<ITEM>::Iterator SkipList<ITEM>::find (KEY const& key)
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::find (KEY const& key)
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and currentLink->nextInLane(lane)->item.cref() < cref(key)) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return Iterator( currentLink->next and currentLink->next->item.cref() == cref(key) ? currentLink->next : 0 );
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY.
-template<typename ITEM>
+template<typename ITEM, typename STATS>
 template<typename KEY>
-typename SkipList<ITEM>::Iterator SkipList<ITEM>::findLow (KEY const& key)
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::findLow (KEY const& key)
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and currentLink->nextInLane(lane)->item.cref() < cref(key)) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return Iterator( currentLink->next and currentLink->next->item.cref() == cref(key) ? currentLink->next : currentLink );
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY.
-template<typename ITEM>
+template<typename ITEM, typename STATS>
 template<typename KEY>
-typename SkipList<ITEM>::Iterator SkipList<ITEM>::findHigh (KEY const& key)
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::findHigh (KEY const& key)
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and currentLink->nextInLane(lane)->item.cref() < cref(key)) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return Iterator( currentLink->next );
 }
 
 
 //------------------------------------------------------------------------------
 // Attempts to find an ITEM in the SkipList with the specified KEY.
-template<typename ITEM>
+template<typename ITEM, typename STATS>
 template<typename KEY>
-typename SkipList<ITEM>::ConstIterator SkipList<ITEM>::find (KEY const& key) const
+typename SkipList<ITEM, STATS>::ConstIterator SkipList<ITEM, STATS>::find (KEY const& key) const
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and currentLink->nextInLane(lane)->item.cref() < cref(key)) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return ConstIterator( (currentLink->next and currentLink->next->item.cref() == cref(key)) ? currentLink->next : 0 );
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY.
-template<typename ITEM>
+template<typename ITEM, typename STATS>
 template<typename KEY>
-typename SkipList<ITEM>::ConstIterator SkipList<ITEM>::findLow (KEY const& key) const
+typename SkipList<ITEM, STATS>::ConstIterator SkipList<ITEM, STATS>::findLow (KEY const& key) const
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and currentLink->nextInLane(lane)->item.cref() < cref(key)) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return ConstIterator( currentLink->next and currentLink->next->item.cref() == cref(key) ? currentLink->next : currentLink );
 }
 
 //------------------------------------------------------------------------------
 // Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY.
-template<typename ITEM>
+template<typename ITEM, typename STATS>
 template<typename KEY>
-typename SkipList<ITEM>::ConstIterator SkipList<ITEM>::findHigh (KEY const& key) const
+typename SkipList<ITEM, STATS>::ConstIterator SkipList<ITEM, STATS>::findHigh (KEY const& key) const
 {
    unsigned lane = _lanes-1;
    Link* currentLink = _head;
    while (true) {
       while (currentLink->nextInLane(lane) and currentLink->nextInLane(lane)->item.cref() < cref(key)) {
          currentLink = currentLink->nextInLane(lane);
+         _stats.step();
       }
       if (lane == 0) {
          break;
       } else {
          --lane;
+         _stats.drop();
       }
    }
-   
+   _stats.found();
    return ConstIterator( currentLink->next );
 }
 
 
 
+//------------------------------------------------------------------------------
+// Attempts to find an ITEM with the specified KEY, searching from hint.
+/**
+ * The search climbs from hint only as high as it needs to, so it takes
+ * O(log d) expected steps to reach an item d items after hint. Links don't
+ * point back, so if key isn't after hint this is just find(key).
+ */
+template<typename ITEM, typename STATS>
+template<typename KEY>
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::find (ConstIterator hint, KEY const& key)
+{
+   Link* link = const_cast<Link*>(hint._current);
+   if (!link or !(link->item.cref() < cref(key)))
+      return find(key);
+
+   unsigned lane;
+   link = climb(link, key, lane);
+   link = descend(link, key, lane)->next;
+   _stats.found();
+   if (link and link->item.cref() == cref(key))
+      return Iterator(link);
+   return Iterator();
+}
+
+//------------------------------------------------------------------------------
+// Attempts to find an ITEM with the specified KEY, searching from hint.
+template<typename ITEM, typename STATS>
+template<typename KEY>
+typename SkipList<ITEM, STATS>::ConstIterator SkipList<ITEM, STATS>::find (ConstIterator hint, KEY const& key) const
+{
+   return const_cast<SkipList*>(this)->find(hint, key);
+}
+
+
 //------------------------------------------------------------------------------
 // Adds another express lane.
 /**
  * No extra lanes are added to existing items; it simply becomes possible for
  * new links to be formed with the new lane.
  */
-template<typename ITEM>
-void SkipList<ITEM>::resize ()
+template<typename ITEM, typename STATS>
+void SkipList<ITEM, STATS>::resize ()
 {
    // Change state members.
    ++_lanes;
@@ -405,26 +720,377 @@ void SkipList<ITEM>::resize ()
    // Allocate new memory.
    Link*     newHead      = static_cast<Link*>     (malloc(Link::footprint(_lanes)));
    Link**    newLastStops = static_cast<Link**>    (malloc(_lanes * sizeof(Link*)));
+   unsigned* newLastRanks = static_cast<unsigned*> (malloc(_lanes * sizeof(unsigned)));
    unsigned* newItems     = static_cast<unsigned*> (malloc(_lanes * sizeof(unsigned)));
 
-   // Fill new memory.
+   // Fill new memory. The new lane spans the whole list: one more place than
+   // there are Links in the lane below.
+   newHead->lanes = newHead->size = _lanes;
+   unsigned width = 0;
+   for (Link* link = _head; link; link = link->nextInLane(_lanes-2))
+      width += link->width(_lanes-2);
+   for (unsigned i=0; i<_lanes-1; ++i) {
+      newHead->nextInLane(i) = _head->nextInLane(i);
+      if (i)
+         newHead->widthInLane(i) = _head->widthInLane(i);
+   }
    newHead->nextInLane(_lanes-1) = 0;
-   memcpy(newHead, _head, Link::footprint(_lanes-1));
+   newHead->widthInLane(_lanes-1) = width;
+   // (The finger's stops below the new lane still hold, and _head is the last stop in it.)
+   memcpy(newLastStops, _lastStops, (_lanes-1)*sizeof(Link*));
+   for (unsigned i=0; i<_lanes-1; ++i) {
+      if (newLastStops[i] == _head)
+         newLastStops[i] = newHead;
+   }
+   newLastStops[_lanes-1] = newHead;
+   memcpy(newLastRanks, _lastRanks, (_lanes-1)*sizeof(unsigned));
+   newLastRanks[_lanes-1] = 0;
    newItems[_lanes-1] = 0;
    memcpy(newItems, _items, (_lanes-1)*sizeof(unsigned));
 
    // Free old memory, swap in new memory.
    free(_head);
    free(_lastStops);
+   free(_lastRanks);
    free(_items);
    _head = newHead;
    _lastStops = newLastStops;
+   _lastRanks = newLastRanks;
    _items = newItems;
+
+   // Add a pool for Links with the new number of lanes (unless one is left from before a shrink).
+   if (_lanes > _classes) {
+      _pools = static_cast<MemoryPoolF**> (realloc(_pools, _lanes * sizeof(MemoryPoolF*)));
+      _pools[_classes] = new MemoryPoolF;
+      _pools[_classes]->setItemSize(Link::footprint(_lanes), alignof(Link));
+      _pools[_classes]->setMinFree(1);
+      ++_classes;
+   }
+   sizePools();
+}
+
+//------------------------------------------------------------------------------
+// Drops the top express lane.
+/**
+ * The Links in the top lane stay in the lanes below it (there are only a
+ * handful). They keep the memory for the lane, but not the lane itself, so if
+ * it is added back later it starts out empty (see resize).
+ */
+template<typename ITEM, typename STATS>
+void SkipList<ITEM, STATS>::shrink ()
+{
+   --_lanes;
+   for (Link* link = _head->nextInLane(_lanes); link; link = link->nextInLane(_lanes))
+      link->lanes = _lanes;
+   _trigger *= _linkProb;
+   sizePools();
+}
+
+//------------------------------------------------------------------------------
+// Tells each pool how many Links to make room for when it next runs out.
+/**
+ * This is about the number of Links with that many lanes the SkipList will
+ * have when it next resizes, so that the pools' block counts (which free has
+ * to search through) only grow with the number of lanes.
+ */
+template<typename ITEM, typename STATS>
+void SkipList<ITEM, STATS>::sizePools ()
+{
+   float expected = _trigger;
+   for (unsigned i=0; i<_lanes; ++i) {
+      float links = i+1 < _lanes ? expected * (1.0 - _linkProb) : expected;
+      _pools[i]->setNextBlockSize(links < 16.0 ? 16 : static_cast<unsigned>(links));
+      expected *= _linkProb;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Fills _lastStops with the last Link before key in each lane.
+template<typename ITEM, typename STATS>
+template<typename KEY>
+void SkipList<ITEM, STATS>::findLastStops (KEY const& key)
+{
+   unsigned lane = _lanes-1;
+   unsigned rank = 0;
+   Link* stop = _head;
+   while (true) {
+      while (stop->nextInLane(lane) and stop->nextInLane(lane)->item.cref() < cref(key)) {
+         rank += stop->width(lane);
+         stop = stop->nextInLane(lane);
+         _stats.step();
+      }
+      _lastStops[lane] = stop;
+      _lastRanks[lane] = rank;
+
+      if (lane == 0) {
+         break;
+      } else {
+         --lane;
+         _stats.drop();
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Fills _lastStops with the last Link before place (index+1) in each lane.
+template<typename ITEM, typename STATS>
+void SkipList<ITEM, STATS>::findLastStopsAt (unsigned place)
+{
+   unsigned lane = _lanes-1;
+   unsigned rank = 0;
+   Link* stop = _head;
+   while (true) {
+      while (rank + stop->width(lane) < place) {
+         rank += stop->width(lane);
+         stop = stop->nextInLane(lane);
+         _stats.step();
+      }
+      _lastStops[lane] = stop;
+      _lastRanks[lane] = rank;
+
+      if (lane == 0) {
+         break;
+      } else {
+         --lane;
+         _stats.drop();
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+// Fills _lastStops with the last Link before key in each lane, starting from hint and the finger.
+/**
+ * If hint is before key, the lanes hint can reach are searched by climbing
+ * from it. Links don't point back, so the stops in the lanes above (or in all
+ * of them, if hint is no help) come from moving the finger.
+ *
+ * Where the climb stopped is then found from the finger's stop a lane up (to
+ * know its index): the Links between them have no more lanes than it has, so
+ * there are only a few.
+ */
+template<typename ITEM, typename STATS>
+template<typename KEY>
+void SkipList<ITEM, STATS>::findLastStops (ConstIterator hint, KEY const& key)
+{
+   Link* link = const_cast<Link*>(hint._current);
+   unsigned lane = 0;
+   unsigned low = 0;
+   if (link and link->item.cref() < cref(key)) {
+      link = climb(link, key, lane);
+      low = link->lanes;
+   }
+   moveFinger(key, low);
+   if (!low)
+      return;
+
+   Link* stop = low < _lanes ? _lastStops[low] : _head;
+   unsigned rank = low < _lanes ? _lastRanks[low] : 0;
+   for (; stop != link; stop = stop->nextInLane(low-1)) {
+      rank += stop->width(low-1);
+      _stats.step();
+   }
+
+   // link is the last stop in its own lanes from lane up (climb stopped there).
+   for (unsigned i = lane; i < low; ++i) {
+      _lastStops[i] = link;
+      _lastRanks[i] = rank;
+   }
+   while (lane > 0) {
+      --lane;
+      _stats.drop();
+      while (link->nextInLane(lane) and link->nextInLane(lane)->item.cref() < cref(key)) {
+         rank += link->width(lane);
+         link = link->nextInLane(lane);
+         _stats.step();
+      }
+      _lastStops[lane] = link;
+      _lastRanks[lane] = rank;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Brings _lastStops[low] and above up to date for key, from the finger.
+/**
+ * The finger holds the last stops for some earlier key. A stop that is still
+ * before key with its next Link not, is still right, and then so are all the
+ * stops above it (they are at or before it, and their next Links are at or
+ * after its next one). So the finger climbs until the stop a lane up is still
+ * right, and searches down from there; for keys near the earlier one that
+ * is only a lane or two.
+ */
+template<typename ITEM, typename STATS>
+template<typename KEY>
+void SkipList<ITEM, STATS>::moveFinger (KEY const& key, unsigned low)
+{
+   if (low >= _lanes)
+      return;
+
+   unsigned top = low;
+   while (top+1 < _lanes) {
+      Link* stop = _lastStops[top+1];
+      Link* next = stop->nextInLane(top+1);
+      if ((stop == _head or stop->item.cref() < cref(key)) and (!next or !(next->item.cref() < cref(key))))
+         break;
+      ++top;
+   }
+
+   // Start from the stop in the top lane if it is before key, or else from the (right) one above it.
+   Link* link = _lastStops[top];
+   unsigned rank = _lastRanks[top];
+   if (link != _head and !(link->item.cref() < cref(key))) {
+      link = top+1 < _lanes ? _lastStops[top+1] : _head;
+      rank = top+1 < _lanes ? _lastRanks[top+1] : 0;
+   }
+   for (unsigned lane = top; ; --lane) {
+      while (link->nextInLane(lane) and link->nextInLane(lane)->item.cref() < cref(key)) {
+         rank += link->width(lane);
+         link = link->nextInLane(lane);
+         _stats.step();
+      }
+      _lastStops[lane] = link;
+      _lastRanks[lane] = rank;
+      if (lane == low)
+         break;
+      _stats.drop();
+   }
+}
+
+//------------------------------------------------------------------------------
+// Returns the last Link before key reached from link, and the highest lane it got to.
+/**
+ * link must be before key. Each step climbs to a higher lane of the current
+ * Link if that lane's next Link is still before key, or else moves along the
+ * current lane. It stops where neither is possible: the Link it returns is
+ * then the last one before key in lane and in all of its own lanes above.
+ */
+template<typename ITEM, typename STATS>
+template<typename KEY>
+typename SkipList<ITEM, STATS>::Link* SkipList<ITEM, STATS>::climb (Link* link, KEY const& key, unsigned& lane) const
+{
+   lane = 0;
+   while (true) {
+      while (lane+1 < link->lanes and link->nextInLane(lane+1) and link->nextInLane(lane+1)->item.cref() < cref(key))
+         ++lane;
+      Link* next = link->nextInLane(lane);
+      if (!next or !(next->item.cref() < cref(key)))
+         return link;
+      link = next;
+      _stats.step();
+   }
+}
+
+//------------------------------------------------------------------------------
+// Returns the last Link before key, descending from link in lane.
+template<typename ITEM, typename STATS>
+template<typename KEY>
+typename SkipList<ITEM, STATS>::Link* SkipList<ITEM, STATS>::descend (Link* link, KEY const& key, unsigned lane) const
+{
+   while (true) {
+      while (link->nextInLane(lane) and link->nextInLane(lane)->item.cref() < cref(key)) {
+         link = link->nextInLane(lane);
+         _stats.step();
+      }
+      if (lane == 0)
+         return link;
+      --lane;
+      _stats.drop();
+   }
 }
 
 //------------------------------------------------------------------------------
-template<typename ITEM>
-unsigned SkipList<ITEM>::chooseNewLanes () const
+// Counts a new Link in _items (adding a lane if needed), and returns how many lanes it gets (0 if it's up to insert).
+/**
+ * Deterministic lanes depend on where the Link goes, so they are left to
+ * insert to choose, after the search. (A lane can't be added then, since that
+ * replaces _head, which the search may have stopped at.)
+ */
+template<typename ITEM, typename STATS>
+unsigned SkipList<ITEM, STATS>::countNewLink ()
+{
+   // If we will have more than _trigger items, resize and force the new entry to link to all lanes.
+   if (++_items[0] > static_cast<unsigned>(_trigger)) {
+      resize();
+      return _lanes;
+   } else {
+      return _deterministic ? 0 : chooseNewLanes(); // Otherwise choose a random number of express lanes to link to.
+   }
+}
+
+//------------------------------------------------------------------------------
+// Links a new Link holding item in after _lastStops.
+template<typename ITEM, typename STATS>
+typename SkipList<ITEM, STATS>::Iterator SkipList<ITEM, STATS>::insert (typename W::Ex item, unsigned newLanes)
+{
+   if (!newLanes)
+      newLanes = chooseSpannedLanes();
+
+   // Incremement lane counts for each express lane used by the new Link. (countNewLink already incremented _item[0].)
+   for (unsigned i=1; i<newLanes; ++i)
+      ++_items[i];
+
+   // Allocate memory for new Link.
+   Link* newLink = new( _pools[newLanes-1]->alloc() ) Link(item, newLanes);
+   
+   // Link in all forward pointing pointers of the new Link, splitting the widths of the lanes it is in.
+   unsigned place = _lastRanks[0] + 1;
+   for (unsigned lane=0; lane < newLanes; ++lane) {
+      Link* stop = _lastStops[lane];
+      newLink->nextInLane(lane) = stop->nextInLane(lane);
+      stop->nextInLane(lane) = newLink;
+      if (lane) {
+         unsigned before = place - _lastRanks[lane];
+         newLink->widthInLane(lane) = stop->widthInLane(lane) + 1 - before;
+         stop->widthInLane(lane) = before;
+      }
+   }
+   // The lanes above it pass over one more place.
+   for (unsigned lane = newLanes; lane < _lanes; ++lane)
+      ++_lastStops[lane]->widthInLane(lane);
+
+   // Return an Iterator pointing to the new Link.
+   return Iterator(newLink);
+}
+
+//------------------------------------------------------------------------------
+// Unlinks link (at place, its index+1) from every lane, and frees it. _lastStops must be found first.
+/**
+ * Among equal items link may come after the last stop's successor, so each
+ * lane is searched (from its last stop) for the last Link before place. In
+ * the lanes link is in that Link is right before it; in the others, its width
+ * passes over link.
+ */
+template<typename ITEM, typename STATS>
+void SkipList<ITEM, STATS>::unlink (Link* link, unsigned place)
+{
+   for (unsigned lane=0; lane<_lanes; ++lane) {
+      Link* stop = _lastStops[lane];
+      unsigned rank = _lastRanks[lane];
+      while (rank + stop->width(lane) < place) {
+         rank += stop->width(lane);
+         stop = stop->nextInLane(lane);
+         _stats.step();
+      }
+      if (lane < link->lanes) {
+         stop->nextInLane(lane) = link->nextInLane(lane);
+         if (lane)
+            stop->widthInLane(lane) += link->widthInLane(lane) - 1;
+         --_items[lane];
+      } else {
+         --stop->widthInLane(lane);
+      }
+   }
+   MemoryPoolF* pool = _pools[link->size-1];
+   link->item.~W();
+   pool->free(link);
+
+   // Drop the top lane once there are well under as many items as it was added for.
+   if (_lanes > 1 and _items[0] < _trigger * _linkProb * _linkProb)
+      shrink();
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, typename STATS>
+unsigned SkipList<ITEM, STATS>::chooseNewLanes () const
 {
    double random = _rand->f64();
    unsigned newLanes(1);
@@ -440,6 +1106,26 @@ unsigned SkipList<ITEM>::chooseNewLanes () const
    return newLanes;
 }
 
+//------------------------------------------------------------------------------
+// Returns how many lanes a new Link going in after _lastStops gets with deterministic lanes.
+/**
+ * It goes into lane L if it is in lane L-1 and the span of lane L it lands in
+ * is more than 1.5 stride^L places wide. A span that wide is split at a
+ * random place when adds come in random order, which leaves spans stride^L
+ * places wide on average, so lanes hold as many Links as random lanes would.
+ */
+template<typename ITEM, typename STATS>
+unsigned SkipList<ITEM, STATS>::chooseSpannedLanes () const
+{
+   unsigned newLanes = 1;
+   unsigned long span = _stride + _stride/2;
+   while (newLanes < _lanes and _lastStops[newLanes]->widthInLane(newLanes) > span) {
+      ++newLanes;
+      span *= _stride;
+   }
+   return newLanes;
+}
+
 //==============================================================================
 // Comparison Operators
 //==============================================================================
@@ -468,8 +1154,8 @@ bool operator>  (typename Wrap<ITEM>::CRef item, typename SkipList<ITEM>::Iterat
 //==============================================================================
 
 //------------------------------------------------------------------------------
-template<typename ITEM>
-void SkipList<ITEM>::printStats () const
+template<typename ITEM, typename STATS>
+void SkipList<ITEM, STATS>::printStats () const
 {
    std::cout << "SkipList Stats\n";
    std::cout << "Items: " << _items[0] << "\nLanes: " << _lanes << '\n';
@@ -479,8 +1165,33 @@ void SkipList<ITEM>::printStats () const
 }
 
 //------------------------------------------------------------------------------
-template<typename ITEM>
-void SkipList<ITEM>::print () const
+// Returns the number of Links a search for key compares it to.
+template<typename ITEM, typename STATS>
+template<typename KEY>
+unsigned SkipList<ITEM, STATS>::pathLength (KEY const& key) const
+{
+   unsigned lane = _lanes-1;
+   unsigned length = 0;
+   Link const* currentLink = _head;
+   while (true) {
+      while (currentLink->nextInLane(lane)) {
+         ++length;
+         if (!(currentLink->nextInLane(lane)->item.cref() < cref(key)))
+            break;
+         currentLink = currentLink->nextInLane(lane);
+      }
+      if (lane == 0) {
+         break;
+      } else {
+         --lane;
+      }
+   }
+   return length;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, typename STATS>
+void SkipList<ITEM, STATS>::print () const
 {
    std::cout << "Printing SkipList\n";
    Iterator itr(_head);
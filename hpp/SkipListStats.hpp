@@ -0,0 +1,96 @@
+//==============================================================================
+// SkipListStats.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_SKIPLIST_STATS
+#define ESTDLIB_SKIPLIST_STATS
+
+#include <cstring>
+
+
+//==============================================================================
+// Search Cost Policies for SkipList and DoubleSkipList
+//==============================================================================
+/*
+ * SkipList and DoubleSkipList take a STATS policy, which their searches tell
+ * about every Link they step onto (step) and every lane they drop down
+ * (drop), and then which kind of operation it was (found, added, removed).
+ * NoSkipListStats (the default) does nothing, so it all compiles away.
+ * SkipListStats adds it up into a SkipListCosts, which the list hands out
+ * through stats().
+ *
+ * The number of comparisons a search makes is its steps plus the lanes it
+ * looked along (each lane ends with one comparison that fails).
+ */
+
+/// The costs of the operations a SkipList or DoubleSkipList has done, as counted by SkipListStats.
+struct SkipListCosts {
+   static unsigned const buckets = 32;     ///< number of histogram buckets
+   static unsigned const bucketWidth = 4;  ///< Links counted in each bucket (the last takes the rest)
+
+   /// Totals for one kind of operation.
+   struct Op {
+      unsigned long count;    ///< operations
+      unsigned long links;    ///< Links stepped onto
+      unsigned long squares;  ///< sum of the squares of each operation's links
+      unsigned long drops;    ///< lanes dropped down
+      unsigned longest;       ///< most Links stepped onto by one operation
+      unsigned long histogram[buckets]; ///< operations by the Links they stepped onto
+
+      double meanLinks () const { return count ? double(links) / count : 0.0; }
+      double varianceLinks () const { return count ? double(squares) / count - meanLinks() * meanLinks() : 0.0; }
+      double meanDrops () const { return count ? double(drops) / count : 0.0; }
+   };
+
+   Op find;    ///< find, findLow, findHigh, rank and at
+   Op add;     ///< add (and DoubleSkipList::relink)
+   Op remove;  ///< remove, erase, popFront and popBack
+};
+
+//------------------------------------------------------------------------------
+/// Stats policy that counts nothing.
+struct NoSkipListStats {
+   void step () {}
+   void drop () {}
+   void found () {}
+   void added () {}
+   void removed () {}
+};
+
+//------------------------------------------------------------------------------
+/// Stats policy that adds up the costs of each operation.
+class SkipListStats {
+private:
+   SkipListCosts _costs;
+   unsigned _links;  ///< Links stepped onto by the operation under way
+   unsigned _drops;  ///< lanes dropped by the operation under way
+
+   void record (SkipListCosts::Op& op) {
+      ++op.count;
+      op.links += _links;
+      op.squares += static_cast<unsigned long>(_links) * _links;
+      op.drops += _drops;
+      if (_links > op.longest)
+         op.longest = _links;
+      unsigned bucket = _links / SkipListCosts::bucketWidth;
+      ++op.histogram[bucket < SkipListCosts::buckets ? bucket : SkipListCosts::buckets-1];
+      _links = _drops = 0;
+   }
+
+public:
+   SkipListStats () { reset(); }
+
+   void step () { ++_links; }
+   void drop () { ++_drops; }
+   void found () { record(_costs.find); }
+   void added () { record(_costs.add); }
+   void removed () { record(_costs.remove); }
+
+   /// Returns the costs counted since the list was made or reset.
+   SkipListCosts const& costs () const { return _costs; }
+   void reset () { memset(&_costs, 0, sizeof(_costs)); _links = _drops = 0; }
+};
+
+
+#endif // ESTDLIB_SKIPLIST_STATS
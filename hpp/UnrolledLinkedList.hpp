@@ -0,0 +1,347 @@
+//==============================================================================
+// UnrolledLinkedList.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_UNROLLED_LINKED_LIST
+#define ESTDLIB_UNROLLED_LINKED_LIST
+
+#include <new>
+#include "Wrap.hpp"
+#include "MemoryPool.h"
+
+
+//==============================================================================
+// Class UnrolledLinkedList<ITEM, NODE_ITEMS>
+//==============================================================================
+/*
+ * A singly linked list that keeps up to NODE_ITEMS items in each Node, so
+ * iterating over it reads arrays of items instead of chasing a pointer per
+ * item, and there's one pointer per Node rather than per item.
+ *
+ * Items in a Node sit in slots [_begin, _end). Adding at the head uses the
+ * free slot below the first Node's _begin, or else starts a new Node with
+ * the item in its last slot, so a list built by adding at the head has full
+ * Nodes. Adding after an Itr shifts the rest of its Node up a slot (or the
+ * front of it down, when the end is full), and splits a full Node in half.
+ * An item added after the last item of a full Node starts a new Node
+ * instead, so items appended in order fill their Nodes too. Either way the
+ * work is bounded by NODE_ITEMS, so both are O(1).
+ *
+ * Nodes come from a MemoryPool: one shared with other lists (as for the
+ * edge lists of a graph), or else one the UnrolledLinkedList makes for
+ * itself. MemoryPool doesn't take pieces back, so emptied Nodes are kept for
+ * reuse, and a shared pool only gets its memory back when it's cleared.
+ *
+ * As in LinkedList, removeFirst and removeNext remove items. An Itr stays
+ * valid until an item is added to or removed from its Node, except that
+ * removeNext(itr) leaves itr valid.
+ */
+
+template<typename ITEM, unsigned NODE_ITEMS = 16>
+class UnrolledLinkedList {
+// SubClasses
+public:
+   struct Node {
+      Node* _next;
+      unsigned _begin;  // first slot in use
+      unsigned _end;    // one past the last slot in use
+      alignas(Wrap<ITEM>) char _slots[NODE_ITEMS * sizeof(Wrap<ITEM>)];
+
+      Wrap<ITEM>* items () { return reinterpret_cast<Wrap<ITEM>*>(_slots); }
+      Wrap<ITEM> const* items () const { return reinterpret_cast<Wrap<ITEM> const*>(_slots); }
+      unsigned size () const { return _end - _begin; }
+   };
+
+// Iterators
+public:
+   class Itr {
+   private:
+      Node* _node;
+      unsigned _index;
+
+   public:
+      Itr (): _node(0), _index(0) {}
+      Itr (Node* node, unsigned index): _node(node), _index(index) {}
+      bool valid () const { return _node; }
+      bool last  () const { return _index+1 == _node->_end and !(_node->_next); }
+      Itr& operator++ () {
+         if (++_index == _node->_end and (_node = _node->_next))
+            _index = _node->_begin;
+         return *this;
+      }
+      typename Wrap<ITEM>::Ref  ref  () const { return _node->items()[_index].ref(); }
+      typename Wrap<ITEM>::CRef cref () const { return _node->items()[_index].cref(); }
+      typename Wrap<ITEM>::Ptr  ptr  () const { return _node->items()[_index].ptr(); }
+      typename Wrap<ITEM>::CPtr cptr () const { return _node->items()[_index].cptr(); }
+      Node* node () const { return _node; }
+      unsigned index () const { return _index; }
+   };
+   friend class Itr;
+
+   class CItr {
+   private:
+      Node const* _node;
+      unsigned _index;
+
+   public:
+      CItr (): _node(0), _index(0) {}
+      CItr (Node const* node, unsigned index): _node(node), _index(index) {}
+      bool valid () const { return _node; }
+      bool last  () const { return _index+1 == _node->_end and !(_node->_next); }
+      CItr& operator++ () {
+         if (++_index == _node->_end and (_node = _node->_next))
+            _index = _node->_begin;
+         return *this;
+      }
+      typename Wrap<ITEM>::CRef cref () const { return _node->items()[_index].cref(); }
+      typename Wrap<ITEM>::CPtr cptr () const { return _node->items()[_index].cptr(); }
+      Node const* node () const { return _node; }
+      unsigned index () const { return _index; }
+   };
+   friend class CItr;
+
+// Members
+private:
+   Node* _first;
+   Node* _last;
+   Node* _spare;       // emptied Nodes, linked through _next
+   MemoryPool* _pool;
+   bool _ownPool;      // whether we made _pool (and so delete it)
+   unsigned _items;
+
+   // Not copyable
+   UnrolledLinkedList (UnrolledLinkedList const&);
+   UnrolledLinkedList& operator= (UnrolledLinkedList const&);
+
+// Interface
+public:
+   // Constructors
+   UnrolledLinkedList ();
+   UnrolledLinkedList (MemoryPool& pool);
+
+   // Destructor
+   ~UnrolledLinkedList ();
+
+   // Returns the number of items in the UnrolledLinkedList.
+   unsigned size () const { return _items; }
+   // Returns the first item.
+   typename Wrap<ITEM>::T first () { return _first->items()[_first->_begin].t(); }
+
+   // Iterators
+   Itr itr () { return _first ? Itr(_first, _first->_begin) : Itr(); }
+   CItr citr () const { return _first ? CItr(_first, _first->_begin) : CItr(); }
+
+   // Adds an ITEM at the head.
+   inline void add (typename Wrap<ITEM>::Ex item);
+   // Adds an ITEM after the specified one.
+   inline Itr add (Itr itr, typename Wrap<ITEM>::Ex item);
+   // Adds an ITEM at the tail.
+   inline Itr append (typename Wrap<ITEM>::Ex item);
+
+   // Removes the item following itr.
+   inline typename Wrap<ITEM>::T removeNext (Itr itr);
+   // Removes the first item.
+   inline typename Wrap<ITEM>::T removeFirst ();
+   // Removes all items.
+   void removeAll ();
+
+private:
+   inline Node* newNode (Node* next, unsigned slot);
+   inline void freeNode (Node* node);
+   void move (Wrap<ITEM>* to, Wrap<ITEM>* from) { new(to) Wrap<ITEM>(from->ex()); from->~Wrap<ITEM>(); }
+   Itr split (Node* node, unsigned index, typename Wrap<ITEM>::Ex item);
+};
+
+
+//==============================================================================
+// Inline Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Constructor that makes its own MemoryPool
+template<typename ITEM, unsigned NODE_ITEMS>
+UnrolledLinkedList<ITEM, NODE_ITEMS>::UnrolledLinkedList ():
+   _first(0), _last(0), _spare(0), _pool(new MemoryPool(16*sizeof(Node), alignof(Node))), _ownPool(true), _items(0)
+{}
+
+//------------------------------------------------------------------------------
+// Constructor that takes its Nodes from pool
+template<typename ITEM, unsigned NODE_ITEMS>
+UnrolledLinkedList<ITEM, NODE_ITEMS>::UnrolledLinkedList (MemoryPool& pool):
+   _first(0), _last(0), _spare(0), _pool(&pool), _ownPool(false), _items(0)
+{}
+
+//------------------------------------------------------------------------------
+// Destructor
+template<typename ITEM, unsigned NODE_ITEMS>
+UnrolledLinkedList<ITEM, NODE_ITEMS>::~UnrolledLinkedList () {
+   removeAll();
+   if (_ownPool)
+      delete _pool;
+}
+
+//------------------------------------------------------------------------------
+// Returns a Node whose only item will go in slot, linked to next.
+template<typename ITEM, unsigned NODE_ITEMS>
+typename UnrolledLinkedList<ITEM, NODE_ITEMS>::Node* UnrolledLinkedList<ITEM, NODE_ITEMS>::newNode (Node* next, unsigned slot) {
+   Node* node = _spare;
+   if (node)
+      _spare = node->_next;
+   else
+      node = static_cast<Node*>(_pool->alloc(sizeof(Node), alignof(Node)));
+   node->_next = next;
+   node->_begin = slot;
+   node->_end = slot+1;
+   if (!next)
+      _last = node;
+   return node;
+}
+
+//------------------------------------------------------------------------------
+// Keeps an empty (and unlinked) Node for reuse.
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledLinkedList<ITEM, NODE_ITEMS>::freeNode (Node* node) {
+   node->_next = _spare;
+   _spare = node;
+}
+
+//------------------------------------------------------------------------------
+// Adds an ITEM at the head.
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledLinkedList<ITEM, NODE_ITEMS>::add (typename Wrap<ITEM>::Ex item) {
+   if (!_first or _first->_begin == 0)
+      _first = newNode(_first, NODE_ITEMS-1);
+   else
+      --_first->_begin;
+   new(_first->items() + _first->_begin) Wrap<ITEM>(item);
+   ++_items;
+}
+
+//------------------------------------------------------------------------------
+// Adds an ITEM after the one itr points to, and returns an Itr to it.
+template<typename ITEM, unsigned NODE_ITEMS>
+typename UnrolledLinkedList<ITEM, NODE_ITEMS>::Itr UnrolledLinkedList<ITEM, NODE_ITEMS>::add (Itr itr, typename Wrap<ITEM>::Ex item) {
+   Node* node = itr.node();
+   unsigned index = itr.index() + 1;
+   Wrap<ITEM>* items = node->items();
+   ++_items;
+   if (node->_end < NODE_ITEMS) {
+      for (unsigned i=node->_end; i>index; --i)
+         move(items + i, items + i-1);
+      ++node->_end;
+   } else if (node->_begin > 0) {
+      --index;
+      for (unsigned i=node->_begin; i<=index; ++i)
+         move(items + i-1, items + i);
+      --node->_begin;
+   } else if (index == NODE_ITEMS) {
+      node = node->_next = newNode(node->_next, 0);
+      index = 0;
+   } else {
+      return split(node, index, item);
+   }
+   new(node->items() + index) Wrap<ITEM>(item);
+   return Itr(node, index);
+}
+
+//------------------------------------------------------------------------------
+// Adds an ITEM at the tail, and returns an Itr to it.
+template<typename ITEM, unsigned NODE_ITEMS>
+typename UnrolledLinkedList<ITEM, NODE_ITEMS>::Itr UnrolledLinkedList<ITEM, NODE_ITEMS>::append (typename Wrap<ITEM>::Ex item) {
+   if (!_first) {
+      _first = newNode(0, 0);
+      new(_first->items()) Wrap<ITEM>(item);
+      ++_items;
+      return Itr(_first, 0);
+   }
+   return add(Itr(_last, _last->_end-1), item);
+}
+
+//------------------------------------------------------------------------------
+// Removes the item following itr, which stays valid.
+template<typename ITEM, unsigned NODE_ITEMS>
+typename Wrap<ITEM>::T UnrolledLinkedList<ITEM, NODE_ITEMS>::removeNext (Itr itr) {
+   Node* node = itr.node();
+   unsigned index = itr.index() + 1;
+   if (index == node->_end) {
+      Node* next = node->_next;
+      typename Wrap<ITEM>::T item = next->items()[next->_begin].t();
+      next->items()[next->_begin].~Wrap<ITEM>();
+      if (++next->_begin == next->_end) {
+         node->_next = next->_next;
+         if (_last == next)
+            _last = node;
+         freeNode(next);
+      }
+      --_items;
+      return item;
+   }
+   Wrap<ITEM>* items = node->items();
+   typename Wrap<ITEM>::T item = items[index].t();
+   items[index].~Wrap<ITEM>();
+   for (unsigned i=index+1; i<node->_end; ++i)
+      move(items + i-1, items + i);
+   --node->_end;
+   --_items;
+   return item;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned NODE_ITEMS>
+typename Wrap<ITEM>::T UnrolledLinkedList<ITEM, NODE_ITEMS>::removeFirst () {
+   Node* node = _first;
+   typename Wrap<ITEM>::T item = node->items()[node->_begin].t();
+   node->items()[node->_begin].~Wrap<ITEM>();
+   if (++node->_begin == node->_end) {
+      if (!(_first = node->_next))
+         _last = 0;
+      freeNode(node);
+   }
+   --_items;
+   return item;
+}
+
+
+//==============================================================================
+// Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledLinkedList<ITEM, NODE_ITEMS>::removeAll () {
+   while (_first) {
+      Node* node = _first;
+      for (unsigned i=node->_begin; i<node->_end; ++i)
+         node->items()[i].~Wrap<ITEM>();
+      _first = node->_next;
+      freeNode(node);
+   }
+   _last = 0;
+   _items = 0;
+}
+
+//------------------------------------------------------------------------------
+// Adds item at index of the full Node node, by moving its back half to a new Node after it.
+template<typename ITEM, unsigned NODE_ITEMS>
+typename UnrolledLinkedList<ITEM, NODE_ITEMS>::Itr UnrolledLinkedList<ITEM, NODE_ITEMS>::split (Node* node, unsigned index, typename Wrap<ITEM>::Ex item) {
+   unsigned const half = NODE_ITEMS / 2;
+   Node* back = node->_next = newNode(node->_next, 0);
+   back->_end = NODE_ITEMS - half;
+   for (unsigned i=half; i<NODE_ITEMS; ++i)
+      move(back->items() + i-half, node->items() + i);
+   node->_end = half;
+   if (index > half) {
+      node = back;
+      index -= half;
+   }
+   Wrap<ITEM>* items = node->items();
+   for (unsigned i=node->_end; i>index; --i)
+      move(items + i, items + i-1);
+   ++node->_end;
+   new(items + index) Wrap<ITEM>(item);
+   return Itr(node, index);
+}
+
+
+#endif // ESTDLIB_UNROLLED_LINKED_LIST
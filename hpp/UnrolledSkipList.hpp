@@ -0,0 +1,502 @@
+//==============================================================================
+// UnrolledSkipList.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_UNROLLED_SKIPLIST
+#define ESTDLIB_UNROLLED_SKIPLIST
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <utility>
+#include "MemoryPoolF.h"
+#include "NodeSearch.hpp"
+#include "Random.h"
+#include "Wrap.hpp"
+
+
+//==============================================================================
+// A skiplist of small sorted arrays.
+//==============================================================================
+/**
+ * UnrolledSkipList has the same add, remove, find, findLow and findHigh
+ * methods and Iterators as SkipList, and like it keeps items in order (using
+ * ITEM < ITEM, and ITEM < KEY and ITEM == KEY for searches) and may hold
+ * several equal items.
+ *
+ * Rather than one Link per item, each Node holds up to NODE_ITEMS items in a
+ * sorted array, and the lanes link Nodes (ordered by their first items). A
+ * search runs down the lanes to the last Node whose first item is less than
+ * the key, and finishes with a NodeSearch in that Node's array (SIMD for
+ * integer items). So there are a few times fewer pointers to chase than in
+ * SkipList, and the lanes' pointers are shared by a whole Node: with 16
+ * unsigned items per Node, full Nodes take about 5.2 bytes per item, against
+ * SkipList's 16 or so.
+ *
+ * A full Node is split in half when an item is added to it, except that an
+ * item that goes after a full Node goes at the start of the next one if
+ * there's room, or else into a new Node of its own (so items added in order
+ * fill their Nodes). A Node that falls below a quarter full takes in the
+ * Node after it if they fit together, and an empty Node is dropped.
+ *
+ * Nodes come from a MemoryPoolF per number of lanes. As in
+ * ConcurrentSkipList, the head has maxLanes lanes, and a new Node gets at
+ * most one more lane than the most in use.
+ *
+ * Iterators point at a place in a Node, and so (unlike SkipList's) are
+ * invalidated by any add or remove.
+ */
+
+template<typename ITEM, unsigned NODE_ITEMS = 16>
+class UnrolledSkipList {
+//------------------------------------------------------------------------------
+// SubClasses
+private:
+   typedef Wrap<ITEM> W;
+
+public:
+   static const unsigned maxLanes = 32;
+
+private:
+   /// Nodes are followed in memory by an array of NODE_ITEMS items and then one of lanes next pointers.
+   struct Node {
+      unsigned count;  ///< number of items in use
+      unsigned lanes;
+
+      W* items () { return reinterpret_cast<W*>(reinterpret_cast<char*>(this) + itemsOffset); }
+      W const* items () const { return reinterpret_cast<W const*>(reinterpret_cast<char const*>(this) + itemsOffset); }
+      Node*& next (unsigned lane) { return reinterpret_cast<Node**>(reinterpret_cast<char*>(this) + nextOffset)[lane]; }
+      Node* next (unsigned lane) const { return reinterpret_cast<Node* const*>(reinterpret_cast<char const*>(this) + nextOffset)[lane]; }
+      typename W::CRef first () const { return items()[0].cref(); }
+      static unsigned footprint (unsigned lanes) { return nextOffset + lanes*sizeof(Node*); }
+   };
+
+   static const unsigned itemsOffset = (sizeof(Node) + alignof(W) - 1) / alignof(W) * alignof(W);
+   static const unsigned nextOffset = (itemsOffset + NODE_ITEMS*sizeof(W) + sizeof(Node*) - 1) / sizeof(Node*) * sizeof(Node*);
+   static const unsigned nodeAlignment = alignof(W) > alignof(Node*) ? alignof(W) : alignof(Node*);
+
+public:
+   /// Cautiously iterates over the UnrolledSkipList.
+   class ConstIterator {
+   friend class UnrolledSkipList;
+   protected:
+      Node const* _node;
+      unsigned _index;
+   public:
+      ConstIterator (): _node(0), _index(0) {}
+      ConstIterator (Node const* node, unsigned index): _node(node), _index(index) {}
+      bool valid () const { return _node; }
+      typename W::CRef cref () const { return _node->items()[_index].cref(); }
+      typename W::CPtr cptr () const { return _node->items()[_index].cptr(); }
+      typename W::Ex   ex   () const { return _node->items()[_index].ex(); }
+      // All the following methods will crash if called on an invalid Iterator.
+      ConstIterator& operator++ () {
+         if (++_index == _node->count) {
+            _node = _node->next(0);
+            _index = 0;
+         }
+         return *this;
+      }
+      bool operator<  (ConstIterator itr) const { return this->cref() <  itr.cref(); }
+      bool operator<= (ConstIterator itr) const { return this->cref() <= itr.cref(); }
+      bool operator>  (ConstIterator itr) const { return this->cref() >  itr.cref(); }
+      bool operator>= (ConstIterator itr) const { return this->cref() >= itr.cref(); }
+   };
+
+   /// Iterates over the UnrolledSkipList. (Items must not be changed in ways that change their order.)
+   class Iterator : public ConstIterator {
+   friend class UnrolledSkipList;
+   private:
+      explicit Iterator (ConstIterator itr): ConstIterator(itr) {}
+   public:
+      Iterator (): ConstIterator() {}
+      Iterator (Node* node, unsigned index): ConstIterator(node, index) {}
+      typename W::Ref ref () const { return const_cast<Node*>(this->_node)->items()[this->_index].ref(); }
+      typename W::Ptr ptr () const { return const_cast<Node*>(this->_node)->items()[this->_index].ptr(); }
+      Iterator& operator++ () { ConstIterator::operator++(); return *this; }
+      bool operator<  (Iterator itr) const { return this->cref() <  itr.cref(); }
+      bool operator<= (Iterator itr) const { return this->cref() <= itr.cref(); }
+      bool operator>  (Iterator itr) const { return this->cref() >  itr.cref(); }
+      bool operator>= (Iterator itr) const { return this->cref() >= itr.cref(); }
+   };
+
+// Member data
+private:
+   MemoryPoolF _pools[maxLanes];   ///< _pools[i] holds the Nodes with i+1 lanes
+   Node* _head;         ///< dummy Node at the head of the list (with maxLanes lanes and no items)
+   unsigned _lanes;     ///< number of lanes in use (the most any Node has)
+   unsigned _size;      ///< number of items
+   unsigned _nodes;     ///< number of Nodes (not counting _head)
+   float _linkProb;     ///< probability of a new Node linking to lane n is _linkProb^n
+   XorShift32 _rand;
+
+// Interface
+public:
+   UnrolledSkipList (float linkProb = 0.25, unsigned seed = 0x0a11ed);
+   ~UnrolledSkipList ();
+   UnrolledSkipList (UnrolledSkipList const&) = delete;
+   UnrolledSkipList& operator= (UnrolledSkipList const&) = delete;
+
+   /// Adds a new ITEM to the UnrolledSkipList (before any equal ones).
+   Iterator add (typename W::Ex item);
+   /// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+   template<typename KEY> bool remove (KEY const& key);
+
+   /// Attempts to find an ITEM in the UnrolledSkipList with the specified KEY.
+   template<typename KEY> Iterator find (KEY const& key) { return Iterator(constThis().find(key)); }
+   /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY.
+   template<typename KEY> Iterator findLow (KEY const& key) { return Iterator(constThis().findLow(key)); }
+   /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY.
+   template<typename KEY> Iterator findHigh (KEY const& key) { return Iterator(constThis().findHigh(key)); }
+
+   /// Attempts to find an ITEM in the UnrolledSkipList with the specified KEY.
+   template<typename KEY> ConstIterator find (KEY const& key) const;
+   /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY.
+   template<typename KEY> ConstIterator findLow (KEY const& key) const;
+   /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY.
+   template<typename KEY> ConstIterator findHigh (KEY const& key) const;
+
+   /// Returns an Iterator to the first ITEM in the UnrolledSkipList.
+   Iterator iterator () { return Iterator(_head->next(0), 0); }
+   /// Returns a ConstIterator to the first ITEM in the UnrolledSkipList.
+   ConstIterator constIterator () const { return ConstIterator(_head->next(0), 0); }
+
+   /// Returns the number of items in the UnrolledSkipList.
+   unsigned size () const { return _size; }
+   unsigned lanes () const { return _lanes; }
+   /// Returns the memory held by the Nodes' pools.
+   unsigned long bytes () const;
+
+// Private Methods
+private:
+   UnrolledSkipList const& constThis () const { return *this; }
+   /// Returns the last Node whose first item is less than key (or _head), filling stops with the last in each lane.
+   template<typename KEY> Node* findStops (KEY const& key, Node** stops) const;
+   Node* newNode (unsigned lanes);
+   void freeNode (Node* node);
+   /// Links node in after stops (the last Node in each lane before it).
+   void link (Node* node, Node** stops);
+   /// Unlinks node (which must still have its items) from every lane.
+   void unlink (Node* node);
+   unsigned chooseNewLanes ();
+
+   /// Moves count items from from to to, which may overlap if to is lower.
+   static void moveDown (W* to, W* from, unsigned count);
+   /// Moves count items from from to to, which may overlap if to is higher.
+   static void moveUp (W* to, W* from, unsigned count);
+
+// Debug Methods
+public:
+   void printStats () const;
+};
+
+
+//==============================================================================
+// Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// Constructor
+template<typename ITEM, unsigned NODE_ITEMS>
+UnrolledSkipList<ITEM, NODE_ITEMS>::UnrolledSkipList (float linkProb, unsigned seed)
+   : _lanes(1), _size(0), _nodes(0), _linkProb(linkProb), _rand(seed)
+{
+   // Ensure linkProb is valid.
+   if (0.0 >= _linkProb or _linkProb >= 1.0) {
+      throw("Error from UnrolledSkipList constructor: linkProb must be between 0 and 1.\n");
+   }
+
+   for (unsigned i=0; i<maxLanes; ++i)
+      _pools[i].setItemSize(Node::footprint(i+1), nodeAlignment);
+
+   // The head's items are never constructed or looked at.
+   _head = static_cast<Node*>(malloc(Node::footprint(maxLanes)));
+   if (!_head) {
+      throw("Error from UnrolledSkipList constructor: could not allocate memory.\n");
+   }
+   _head->count = 0;
+   _head->lanes = maxLanes;
+   for (unsigned i=0; i<maxLanes; ++i)
+      _head->next(i) = 0;
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+template<typename ITEM, unsigned NODE_ITEMS>
+UnrolledSkipList<ITEM, NODE_ITEMS>::~UnrolledSkipList ()
+{
+   // The pools free the Nodes themselves.
+   for (Node* node = _head->next(0); node; node = node->next(0)) {
+      for (unsigned i=0; i<node->count; ++i)
+         node->items()[i].~W();
+   }
+   free(_head);
+}
+
+//------------------------------------------------------------------------------
+// Adds an ITEM to the UnrolledSkipList.
+template<typename ITEM, unsigned NODE_ITEMS>
+typename UnrolledSkipList<ITEM, NODE_ITEMS>::Iterator UnrolledSkipList<ITEM, NODE_ITEMS>::add (typename W::Ex item)
+{
+   Node* stops[maxLanes];
+   Node* node = findStops(item, stops);
+   unsigned i = NodeSearch::countLess(node->items(), node->count, ::cref(item));
+
+   // The item goes at the end of node (or before everything, if node is _head).
+   // It can go at the start of the next Node instead, if there's room.
+   if (i == node->count and (node == _head or node->count == NODE_ITEMS)) {
+      Node* next = node->next(0);
+      if (next and next->count < NODE_ITEMS) {
+         node = next;
+         i = 0;
+      } else {
+         Node* added = newNode(chooseNewLanes());
+         link(added, stops);
+         node = added;
+         i = 0;
+      }
+   }
+
+   // A full Node gives its top half to a new Node after it.
+   if (node->count == NODE_ITEMS) {
+      Node* right = newNode(chooseNewLanes());
+      unsigned half = (NODE_ITEMS + 1) / 2;
+      moveDown(right->items(), node->items() + half, NODE_ITEMS - half);
+      right->count = NODE_ITEMS - half;
+      node->count = half;
+      link(right, stops);
+      if (i > half) {
+         node = right;
+         i -= half;
+      }
+   }
+
+   moveUp(node->items() + i + 1, node->items() + i, node->count - i);
+   new(&node->items()[i]) W(item);
+   ++node->count;
+   ++_size;
+   return Iterator(node, i);
+}
+
+//------------------------------------------------------------------------------
+// Removes (one of) the ITEMs equal to key. Returns false if there wasn't one.
+template<typename ITEM, unsigned NODE_ITEMS>
+template<typename KEY>
+bool UnrolledSkipList<ITEM, NODE_ITEMS>::remove (KEY const& key)
+{
+   Node* node = findStops(key, 0);
+   unsigned i = NodeSearch::countLess(node->items(), node->count, ::cref(key));
+   if (i == node->count) {
+      node = node->next(0);
+      i = 0;
+   }
+   if (!node or !(node->items()[i].cref() == ::cref(key)))
+      return false;
+
+   --_size;
+   if (node->count == 1) {
+      unlink(node);
+      node->items()[0].~W();
+      freeNode(node);
+      return true;
+   }
+   node->items()[i].~W();
+   moveDown(node->items() + i, node->items() + i + 1, node->count - i - 1);
+   --node->count;
+
+   // Take in the next Node if this one is getting empty.
+   Node* next = node->next(0);
+   if (node->count < NODE_ITEMS / 4 and next and node->count + next->count <= NODE_ITEMS) {
+      unlink(next);
+      moveDown(node->items() + node->count, next->items(), next->count);
+      node->count += next->count;
+      freeNode(next);
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Attempts to find an ITEM in the UnrolledSkipList with the specified KEY.
+template<typename ITEM, unsigned NODE_ITEMS>
+template<typename KEY>
+typename UnrolledSkipList<ITEM, NODE_ITEMS>::ConstIterator UnrolledSkipList<ITEM, NODE_ITEMS>::find (KEY const& key) const
+{
+   ConstIterator itr = findHigh(key);
+   return itr.valid() and itr.cref() == ::cref(key) ? itr : ConstIterator();
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY.
+template<typename ITEM, unsigned NODE_ITEMS>
+template<typename KEY>
+typename UnrolledSkipList<ITEM, NODE_ITEMS>::ConstIterator UnrolledSkipList<ITEM, NODE_ITEMS>::findLow (KEY const& key) const
+{
+   Node const* node = findStops(key, 0);
+   unsigned i = NodeSearch::countLess(node->items(), node->count, ::cref(key));
+   if (i < node->count and node->items()[i].cref() == ::cref(key))
+      return ConstIterator(node, i);
+   Node const* next = node->next(0);
+   if (i == node->count and next and next->first() == ::cref(key))
+      return ConstIterator(next, 0);
+   // Every Node but _head has an item less than key.
+   return i ? ConstIterator(node, i-1) : ConstIterator();
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY.
+template<typename ITEM, unsigned NODE_ITEMS>
+template<typename KEY>
+typename UnrolledSkipList<ITEM, NODE_ITEMS>::ConstIterator UnrolledSkipList<ITEM, NODE_ITEMS>::findHigh (KEY const& key) const
+{
+   Node const* node = findStops(key, 0);
+   unsigned i = NodeSearch::countLess(node->items(), node->count, ::cref(key));
+   // If every item in the Node is less than key, the first one that isn't starts the next Node.
+   if (i == node->count)
+      return ConstIterator(node->next(0), 0);
+   return ConstIterator(node, i);
+}
+
+//------------------------------------------------------------------------------
+// Returns the memory held by the Nodes' pools.
+template<typename ITEM, unsigned NODE_ITEMS>
+unsigned long UnrolledSkipList<ITEM, NODE_ITEMS>::bytes () const
+{
+   unsigned long total = Node::footprint(maxLanes);
+   for (unsigned i=0; i<maxLanes; ++i)
+      total += _pools[i].capacityBytes();
+   return total;
+}
+
+
+//------------------------------------------------------------------------------
+// Private Methods
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Returns the last Node whose first item is less than key (or _head), filling stops with the last in each lane.
+template<typename ITEM, unsigned NODE_ITEMS>
+template<typename KEY>
+typename UnrolledSkipList<ITEM, NODE_ITEMS>::Node* UnrolledSkipList<ITEM, NODE_ITEMS>::findStops (KEY const& key, Node** stops) const
+{
+   Node* node = _head;
+   for (unsigned lane=_lanes; lane>0; --lane) {
+      while (node->next(lane-1) and node->next(lane-1)->first() < ::cref(key))
+         node = node->next(lane-1);
+      if (stops)
+         stops[lane-1] = node;
+   }
+   return node;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned NODE_ITEMS>
+typename UnrolledSkipList<ITEM, NODE_ITEMS>::Node* UnrolledSkipList<ITEM, NODE_ITEMS>::newNode (unsigned lanes)
+{
+   // Each pool grows by half each time, so there are few blocks to search on free, and not much to spare.
+   MemoryPoolF& pool = _pools[lanes-1];
+   pool.setNextBlockSize(pool.capacityItems() < 128 ? 64 : pool.capacityItems() / 2);
+   Node* node = static_cast<Node*>(pool.alloc());
+   node->count = 0;
+   node->lanes = lanes;
+   ++_nodes;
+   return node;
+}
+
+//------------------------------------------------------------------------------
+// Frees a Node whose items have all been moved or destroyed.
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledSkipList<ITEM, NODE_ITEMS>::freeNode (Node* node)
+{
+   _pools[node->lanes-1].free(node);
+   --_nodes;
+}
+
+//------------------------------------------------------------------------------
+// Links node in after stops (the last Node in each lane before it).
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledSkipList<ITEM, NODE_ITEMS>::link (Node* node, Node** stops)
+{
+   for (; _lanes < node->lanes; ++_lanes)
+      stops[_lanes] = _head;
+   for (unsigned lane=0; lane<node->lanes; ++lane) {
+      node->next(lane) = stops[lane]->next(lane);
+      stops[lane]->next(lane) = node;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Unlinks node (which must still have its items) from every lane.
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledSkipList<ITEM, NODE_ITEMS>::unlink (Node* node)
+{
+   Node* stop = _head;
+   for (unsigned lane=_lanes; lane>0; --lane) {
+      while (stop->next(lane-1) and stop->next(lane-1)->first() < node->first())
+         stop = stop->next(lane-1);
+      if (lane <= node->lanes) {
+         // Nodes with the same first item may come before node.
+         Node* before = stop;
+         while (before->next(lane-1) != node)
+            before = before->next(lane-1);
+         before->next(lane-1) = node->next(lane-1);
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned NODE_ITEMS>
+unsigned UnrolledSkipList<ITEM, NODE_ITEMS>::chooseNewLanes ()
+{
+   unsigned limit = _lanes + 1;
+   if (limit > maxLanes)
+      limit = maxLanes;
+   double random = _rand.f64();
+   unsigned newLanes(1);
+   double cutoff(_linkProb);
+   while (newLanes < limit and random <= cutoff) {
+      ++newLanes;
+      cutoff *= _linkProb;
+   }
+   return newLanes;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledSkipList<ITEM, NODE_ITEMS>::moveDown (W* to, W* from, unsigned count)
+{
+   for (unsigned i=0; i<count; ++i) {
+      new(&to[i]) W(std::move(from[i]));
+      from[i].~W();
+   }
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledSkipList<ITEM, NODE_ITEMS>::moveUp (W* to, W* from, unsigned count)
+{
+   for (unsigned i=count; i>0; --i) {
+      new(&to[i-1]) W(std::move(from[i-1]));
+      from[i-1].~W();
+   }
+}
+
+
+//==============================================================================
+// Debug Methods
+//==============================================================================
+
+//------------------------------------------------------------------------------
+template<typename ITEM, unsigned NODE_ITEMS>
+void UnrolledSkipList<ITEM, NODE_ITEMS>::printStats () const
+{
+   std::cout << "===== UnrolledSkipList Stats =====\n";
+   std::cout << "Items:          " << _size << '\n';
+   std::cout << "Nodes:          " << _nodes << " (" << NODE_ITEMS << " items each)\n";
+   std::cout << "Lanes:          " << _lanes << '\n';
+   std::cout << "Node fill:      " << (_nodes ? double(_size) / (_nodes * NODE_ITEMS) : 0.0) << '\n';
+   std::cout << "Bytes per item: " << (_size ? double(bytes()) / _size : 0.0) << '\n';
+   std::cout << '\n';
+}
+
+#endif // ESTDLIB_UNROLLED_SKIPLIST
@@ -0,0 +1,314 @@
+//==============================================================================
+// VersionedSkipList.hpp
+// Created October 18 2026
+//==============================================================================
+
+#ifndef ESTDLIB_VERSIONED_SKIPLIST
+#define ESTDLIB_VERSIONED_SKIPLIST
+
+#include <deque>
+#include <map>
+#include "SkipList.hpp"
+#include "Wrap.hpp"
+
+
+//==============================================================================
+// Class VersionedSkipList<ITEM>
+//==============================================================================
+/*
+ * A SkipList whose Links remember the version they were added in and the
+ * version they were removed in, so that a Snapshot can keep seeing the list
+ * as it was when the Snapshot was taken while items are added and removed.
+ *
+ * Every add and remove makes a new version. An item is visible at version v
+ * if it was added at or before v and not removed by then. remove only marks
+ * an item, and it stays linked (so Snapshots that can see it can still
+ * iterate to and past it) until no open Snapshot is older than the removal.
+ * Marked items are kept in a queue in the order they were removed, and are
+ * unlinked from the front of it whenever the oldest Snapshot is released,
+ * and on later removes. With no Snapshots open, remove unlinks right away.
+ *
+ * Snapshot Iterators point at Links, which stay put while the Snapshot is
+ * open, so a scan can be left and picked up again at any time. The list
+ * isn't thread safe itself, but this means a long scan can let go of the
+ * writers' lock between steps (or batches of steps) and still see one
+ * consistent version throughout, without copying the list.
+ *
+ * The view of the current version (find, iterator, ...) sees the items that
+ * haven't been removed, and changes with every add and remove (it doesn't keep
+ * removed items linked, as a Snapshot does). Snapshots must be released
+ * before the list is destroyed.
+ *
+ * The requirements on ITEM are the same as for SkipList.
+ */
+
+template<typename ITEM>
+class VersionedSkipList {
+//------------------------------------------------------------------------------
+// Types
+private:
+   typedef Wrap<ITEM> W;
+
+   /// An item with the versions it was added and removed in (0 if it hasn't been).
+   struct Entry {
+      W item;
+      unsigned long added;
+      unsigned long removed;
+
+      Entry (typename W::Ex item, unsigned long added): item(item), added(added), removed(0) {}
+      bool visible (unsigned long version) const { return added <= version and (!removed or version < removed); }
+      bool operator< (Entry const& entry) const { return item.cref() < entry.item.cref(); }
+      template<typename KEY> bool operator<  (KEY const& key) const { return item.cref() < ::cref(key); }
+      template<typename KEY> bool operator== (KEY const& key) const { return item.cref() == ::cref(key); }
+   };
+
+public:
+   typedef SkipList<Entry> List;
+
+   /// Iterates over the items visible at one version.
+   class ConstIterator {
+   friend class VersionedSkipList;
+   private:
+      typename List::ConstIterator _itr;
+      unsigned long _version;
+      ConstIterator (typename List::ConstIterator itr, unsigned long version): _itr(itr), _version(version) { skip(); }
+      void skip () {
+         while (_itr.valid() and !_itr.cref().visible(_version))
+            ++_itr;
+      }
+   public:
+      ConstIterator (): _version(0) {}
+      bool valid () const { return _itr.valid(); }
+      typename W::CRef cref () const { return _itr.cref().item.cref(); }
+      typename W::CPtr cptr () const { return _itr.cref().item.cptr(); }
+      typename W::Ex   ex   () const { return _itr.cref().item.ex(); }
+      unsigned long version () const { return _version; }
+      // All the following methods will crash if called on an invalid Iterator.
+      ConstIterator& operator++ () { ++_itr; skip(); return *this; }
+   };
+
+   /// A view of the list as it was at one version, which lasts until it (and every copy of it) is released.
+   class Snapshot {
+   friend class VersionedSkipList;
+   private:
+      VersionedSkipList const* _list;
+      unsigned long _version;
+      Snapshot (VersionedSkipList const* list, unsigned long version): _list(list), _version(version) { _list->open(_version); }
+   public:
+      Snapshot (): _list(0), _version(0) {}
+      Snapshot (Snapshot const& snapshot): _list(snapshot._list), _version(snapshot._version) { if (_list) _list->open(_version); }
+      Snapshot& operator= (Snapshot const& snapshot);
+      ~Snapshot () { release(); }
+      /// Lets go of the version (after which the Snapshot is empty).
+      void release ();
+
+      bool valid () const { return _list; }
+      unsigned long version () const { return _version; }
+      /// Attempts to find an ITEM with the specified KEY in this version.
+      template<typename KEY> ConstIterator find (KEY const& key) const { return _list->find(key, _version); }
+      /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY in this version.
+      template<typename KEY> ConstIterator findLow (KEY const& key) const { return _list->findLow(key, _version); }
+      /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY in this version.
+      template<typename KEY> ConstIterator findHigh (KEY const& key) const { return _list->findHigh(key, _version); }
+      /// Returns a ConstIterator to the first ITEM in this version.
+      ConstIterator constIterator () const { return ConstIterator(_list->_list.constIterator(), _version); }
+   };
+
+//------------------------------------------------------------------------------
+// Member Data
+private:
+   List _list;
+   unsigned long _version;    ///< the current version
+   unsigned _size;            ///< number of items visible in the current version
+   /// Marked items, in the order they were removed.
+   std::deque<typename List::Iterator> _removed;
+   /// The versions of open Snapshots, and how many are open at each.
+   mutable std::map<unsigned long, unsigned> _snapshots;
+
+//------------------------------------------------------------------------------
+// Interface
+public:
+   /// Arguments as for SkipList.
+   VersionedSkipList (unsigned initialCapacity, float linkProb = 0.25): _list(initialCapacity, linkProb), _version(0), _size(0) {}
+
+   /// Adds a new ITEM, in a new version.
+   ConstIterator add (typename W::Ex item);
+   /// Removes (one of) the ITEMs equal to key, in a new version. Returns false if there wasn't one.
+   template<typename KEY> bool remove (KEY const& key);
+
+   /// Returns a Snapshot of the current version.
+   Snapshot snapshot () const { return Snapshot(this, _version); }
+
+   /// Attempts to find an ITEM with the specified KEY in the current version.
+   template<typename KEY> ConstIterator find (KEY const& key) const { return find(key, _version); }
+   /// Returns an Iterator to (one of) the largest ITEM less than or equal to the specified KEY in the current version.
+   template<typename KEY> ConstIterator findLow (KEY const& key) const { return findLow(key, _version); }
+   /// Returns an Iterator to (one of) the smallest ITEM greater than or equal to the specified KEY in the current version.
+   template<typename KEY> ConstIterator findHigh (KEY const& key) const { return findHigh(key, _version); }
+   /// Returns a ConstIterator to the first ITEM in the current version.
+   ConstIterator constIterator () const { return ConstIterator(_list.constIterator(), _version); }
+
+   /// Returns the number of items in the current version.
+   unsigned size () const { return _size; }
+   unsigned long version () const { return _version; }
+   /// Returns the number of removed items that are still linked for open Snapshots.
+   unsigned marked () const { return _removed.size(); }
+   /// Returns the number of open Snapshots.
+   unsigned snapshots () const;
+   /// The underlying SkipList (with the marked items still in it).
+   List const& list () const { return _list; }
+
+// Private Methods
+private:
+   template<typename KEY> ConstIterator find (KEY const& key, unsigned long version) const;
+   template<typename KEY> ConstIterator findLow (KEY const& key, unsigned long version) const;
+   template<typename KEY> ConstIterator findHigh (KEY const& key, unsigned long version) const;
+   void open (unsigned long version) const { ++_snapshots[version]; }
+   void close (unsigned long version) const;
+   /// Unlinks the marked items that no open Snapshot can see.
+   void purge ();
+};
+
+
+//==============================================================================
+// Method Definitions
+//==============================================================================
+
+//------------------------------------------------------------------------------
+template<typename ITEM>
+typename VersionedSkipList<ITEM>::Snapshot& VersionedSkipList<ITEM>::Snapshot::operator= (Snapshot const& snapshot)
+{
+   if (this == &snapshot)
+      return *this;
+   if (snapshot._list)
+      snapshot._list->open(snapshot._version);
+   release();
+   _list = snapshot._list;
+   _version = snapshot._version;
+   return *this;
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM>
+void VersionedSkipList<ITEM>::Snapshot::release ()
+{
+   if (_list) {
+      _list->close(_version);
+      _list = 0;
+   }
+}
+
+//------------------------------------------------------------------------------
+// Adds a new ITEM, in a new version.
+template<typename ITEM>
+typename VersionedSkipList<ITEM>::ConstIterator VersionedSkipList<ITEM>::add (typename W::Ex item)
+{
+   ++_version;
+   ++_size;
+   return ConstIterator(_list.add(Entry(item, _version)), _version);
+}
+
+//------------------------------------------------------------------------------
+// Removes (one of) the ITEMs equal to key, in a new version. Returns false if there wasn't one.
+template<typename ITEM>
+template<typename KEY>
+bool VersionedSkipList<ITEM>::remove (KEY const& key)
+{
+   // Marked items stay in the list, so skip past them to a live one.
+   typename List::Iterator itr = _list.findHigh(key);
+   while (itr.valid() and itr.cref() == key and itr.cref().removed)
+      ++itr;
+   if (!itr.valid() or !(itr.cref() == key))
+      return false;
+
+   ++_version;
+   --_size;
+   if (_snapshots.empty()) {
+      _list.remove(itr);
+   } else {
+      itr.ref().removed = _version;
+      _removed.push_back(itr);
+      purge();
+   }
+   return true;
+}
+
+//------------------------------------------------------------------------------
+// Returns the number of open Snapshots.
+template<typename ITEM>
+unsigned VersionedSkipList<ITEM>::snapshots () const
+{
+   unsigned open = 0;
+   for (typename std::map<unsigned long, unsigned>::const_iterator itr = _snapshots.begin(); itr != _snapshots.end(); ++itr)
+      open += itr->second;
+   return open;
+}
+
+//------------------------------------------------------------------------------
+// Attempts to find an ITEM with the specified KEY in version.
+template<typename ITEM>
+template<typename KEY>
+typename VersionedSkipList<ITEM>::ConstIterator VersionedSkipList<ITEM>::find (KEY const& key, unsigned long version) const
+{
+   ConstIterator itr = findHigh(key, version);
+   return itr.valid() and itr.cref() == ::cref(key) ? itr : ConstIterator();
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the largest ITEMs less than or equal to the specified KEY in version.
+/**
+ * Links don't point back, so if there's no equal item this steps back by
+ * index (with SkipList::at) past any items that version can't see.
+ */
+template<typename ITEM>
+template<typename KEY>
+typename VersionedSkipList<ITEM>::ConstIterator VersionedSkipList<ITEM>::findLow (KEY const& key, unsigned long version) const
+{
+   ConstIterator itr = find(key, version);
+   if (itr.valid())
+      return itr;
+   for (unsigned index = _list.rank(key); index > 0; --index) {
+      typename List::ConstIterator before = _list.at(index-1);
+      if (before.cref().visible(version))
+         return ConstIterator(before, version);
+   }
+   return ConstIterator();
+}
+
+//------------------------------------------------------------------------------
+// Returns an Iterator to (one of) the smallest ITEMs greater than or equal to the specified KEY in version.
+template<typename ITEM>
+template<typename KEY>
+typename VersionedSkipList<ITEM>::ConstIterator VersionedSkipList<ITEM>::findHigh (KEY const& key, unsigned long version) const
+{
+   return ConstIterator(_list.findHigh(key), version);
+}
+
+//------------------------------------------------------------------------------
+template<typename ITEM>
+void VersionedSkipList<ITEM>::close (unsigned long version) const
+{
+   typename std::map<unsigned long, unsigned>::iterator itr = _snapshots.find(version);
+   bool oldest = itr == _snapshots.begin();
+   if (--itr->second == 0)
+      _snapshots.erase(itr);
+   // Only the oldest Snapshot holds marked items back. (A list that has
+   // always been const has none, so this never changes one.)
+   if (oldest)
+      const_cast<VersionedSkipList*>(this)->purge();
+}
+
+//------------------------------------------------------------------------------
+// Unlinks the marked items that no open Snapshot can see.
+template<typename ITEM>
+void VersionedSkipList<ITEM>::purge ()
+{
+   // A Snapshot at version v sees items removed after v.
+   while (!_removed.empty() and (_snapshots.empty() or _removed.front().cref().removed <= _snapshots.begin()->first)) {
+      _list.remove(_removed.front());
+      _removed.pop_front();
+   }
+}
+
+
+#endif // ESTDLIB_VERSIONED_SKIPLIST